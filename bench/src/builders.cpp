@@ -2,7 +2,9 @@
 #include "gl.h"
 
 #include "util/builders.h"
+#include "util/lineSegments.h"
 #include "glm/glm.hpp"
+#include <cmath>
 #include <vector>
 
 #include "benchmark/benchmark_api.h"
@@ -58,4 +60,137 @@ static void BM_Tangram_BuildRoundRoundLine(benchmark::State& state) {
 }
 BENCHMARK(BM_Tangram_BuildRoundRoundLine);
 
+// Same as above with the vertex sink passed as template argument
+static void BM_Tangram_BuildButtMiterLineInline(benchmark::State& state) {
+    while(state.KeepRunning()) {
+        std::vector<PosNormEnormColVertex> vertices;
+        PolyLineBuilder builder { {}, CapTypes::butt, JoinTypes::miter };
+
+        Builders::buildPolyLine(line, builder,
+            [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
+                vertices.push_back({ coord, uv, normal, 0.5f, 0xffffff, 0.f });
+            });
+    }
+}
+BENCHMARK(BM_Tangram_BuildButtMiterLineInline);
+
+static void BM_Tangram_BuildRoundRoundLineInline(benchmark::State& state) {
+    while(state.KeepRunning()) {
+        std::vector<PosNormEnormColVertex> vertices;
+        PolyLineBuilder builder { {}, CapTypes::round, JoinTypes::round };
+
+        Builders::buildPolyLine(line, builder,
+            [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
+                vertices.push_back({ coord, uv, normal, 0.5f, 0xffffff, 0.f });
+            });
+    }
+}
+BENCHMARK(BM_Tangram_BuildRoundRoundLineInline);
+
+struct PosNormColVertex {
+    glm::vec3 pos;
+    glm::vec3 normal;
+    glm::vec2 texcoord;
+    GLuint abgr;
+};
+
+// Circle with a hole and 64 points per ring
+static Polygon polygon() {
+    Polygon polygon(2);
+    for (int i = 0; i <= 64; i++) {
+        float a = 2 * M_PI * i / 64;
+        polygon[0].push_back({ 0.5f + 0.4f * std::cos(a), 0.5f + 0.4f * std::sin(a), 0 });
+        polygon[1].push_back({ 0.5f + 0.2f * std::cos(-a), 0.5f + 0.2f * std::sin(-a), 0 });
+    }
+    return polygon;
+}
+
+static void BM_Tangram_BuildPolygon(benchmark::State& state) {
+    auto poly = polygon();
+    std::vector<PosNormColVertex> vertices;
+
+    PolygonBuilder builder {
+        [&](const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv) {
+            vertices.push_back({ coord, normal, uv, 0xffffff });
+        }
+    };
+
+    while(state.KeepRunning()) {
+        Builders::buildPolygonExtrusion(poly, 0.f, 1.f, builder);
+        Builders::buildPolygon(poly, 1.f, builder);
+        builder.clear();
+        vertices.clear();
+    }
+}
+BENCHMARK(BM_Tangram_BuildPolygon);
+
+static void BM_Tangram_BuildPolygonInline(benchmark::State& state) {
+    auto poly = polygon();
+    std::vector<PosNormColVertex> vertices;
+
+    PolygonBuilder builder;
+    auto addVertex = [&](const glm::vec3& coord, const glm::vec3& normal, const glm::vec2& uv) {
+        vertices.push_back({ coord, normal, uv, 0xffffff });
+    };
+
+    while(state.KeepRunning()) {
+        Builders::buildPolygonExtrusion(poly, 0.f, 1.f, builder, addVertex);
+        Builders::buildPolygon(poly, 1.f, builder, addVertex);
+        builder.clear();
+        vertices.clear();
+    }
+}
+BENCHMARK(BM_Tangram_BuildPolygonInline);
+
+// Meandering line with 10k vertices, like a river or motorway
+static Line longLine() {
+    Line line;
+    for (int i = 0; i < 10000; i++) {
+        float t = i / 10000.f;
+        line.push_back({ t, 0.5f + 0.3f * std::sin(t * 40.f) + 0.01f * std::sin(t * 997.f), 0 });
+    }
+    return line;
+}
+
+static void BM_Tangram_LineSegmentsScalar(benchmark::State& state) {
+    auto line = longLine();
+    LineSegments segments;
+
+    while(state.KeepRunning()) {
+        segments.computeScalar(line);
+        benchmark::DoNotOptimize(segments.normals.data());
+    }
+    state.SetItemsProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_Tangram_LineSegmentsScalar);
+
+static void BM_Tangram_LineSegments(benchmark::State& state) {
+    auto line = longLine();
+    LineSegments segments;
+
+    while(state.KeepRunning()) {
+        segments.compute(line);
+        benchmark::DoNotOptimize(segments.normals.data());
+    }
+    state.SetItemsProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_Tangram_LineSegments);
+
+static void BM_Tangram_BuildLongLine(benchmark::State& state) {
+    auto line = longLine();
+    std::vector<PosNormEnormColVertex> vertices;
+    PolyLineBuilder builder { {}, CapTypes::round, JoinTypes::miter };
+
+    while(state.KeepRunning()) {
+        Builders::buildPolyLine(line, builder,
+            [&](const glm::vec3& coord, const glm::vec2& normal, const glm::vec2& uv) {
+                vertices.push_back({ coord, uv, normal, 0.5f, 0xffffff, 0.f });
+            });
+        builder.clear();
+        vertices.clear();
+    }
+    state.SetItemsProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_Tangram_BuildLongLine);
+
 BENCHMARK_MAIN();
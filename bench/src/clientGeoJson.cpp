@@ -0,0 +1,126 @@
+#include "data/clientGeoJsonSource.h"
+#include "data/properties.h"
+#include "data/tileData.h"
+#include "tile/tileID.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+static std::vector<LngLat> randomPoints(size_t _count) {
+    std::mt19937 random(0);
+    std::uniform_real_distribution<double> lng(-122.5, -122.3);
+    std::uniform_real_distribution<double> lat(37.7, 37.8);
+
+    std::vector<LngLat> points;
+    points.reserve(_count);
+    for (size_t i = 0; i < _count; i++) {
+        points.push_back({lng(random), lat(random)});
+    }
+    return points;
+}
+
+// range_x: number of points added per batch, 1 adds them one at a time
+static void BM_ClientGeoJsonAddPoints(benchmark::State& state) {
+    const size_t numPoints = 100000;
+    size_t batchSize = state.range_x();
+
+    auto points = randomPoints(numPoints);
+    Properties props;
+    props.set("kind", "marker");
+
+    while (state.KeepRunning()) {
+        auto source = std::make_shared<ClientGeoJsonSource>("points", "");
+
+        for (size_t i = 0; i < numPoints; i += batchSize) {
+            source->beginBatch();
+            for (size_t j = i; j < std::min(i + batchSize, numPoints); j++) {
+                source->addPoint(props, points[j]);
+            }
+            source->commitBatch();
+        }
+        benchmark::DoNotOptimize(source->generation());
+    }
+
+    state.SetItemsProcessed(state.iterations() * numPoints);
+    std::string label = std::to_string(numPoints) + " points";
+    state.SetLabel(label.c_str());
+}
+BENCHMARK(BM_ClientGeoJsonAddPoints)->Arg(1)->Arg(100)->Arg(100000);
+
+struct BenchGeoJsonSource : public ClientGeoJsonSource {
+    using ClientGeoJsonSource::ClientGeoJsonSource;
+    using ClientGeoJsonSource::parse;
+};
+
+// Source with 100k points, shared by all benchmark threads. The points are
+// added in one batch, so all tiles come from one store and threads only
+// scale when they slice from different cells of it.
+static std::shared_ptr<BenchGeoJsonSource> pointSource() {
+    static std::shared_ptr<BenchGeoJsonSource> s_source = [] {
+        auto source = std::make_shared<BenchGeoJsonSource>("points", "");
+        Properties props;
+        props.set("kind", "marker");
+
+        source->beginBatch();
+        for (auto& point : randomPoints(100000)) {
+            source->addPoint(props, point);
+        }
+        source->commitBatch();
+        return source;
+    }();
+    return s_source;
+}
+
+// Tiles covering the points at zoom 16
+static std::vector<TileID> pointTiles() {
+    const int z = 16;
+    const double n = 1 << z;
+    auto tileX = [&](double lng) { return int((lng + 180.) / 360. * n); };
+    auto tileY = [&](double lat) {
+        double r = lat * M_PI / 180.;
+        return int((1. - std::log(std::tan(r) + 1. / std::cos(r)) / M_PI) / 2. * n);
+    };
+
+    std::vector<TileID> tiles;
+    for (int x = tileX(-122.5); x <= tileX(-122.3); x++) {
+        for (int y = tileY(37.8); y <= tileY(37.7); y++) {
+            tiles.emplace_back(x, y, z);
+        }
+    }
+    return tiles;
+}
+
+// Each thread parses the tiles starting at a different offset
+static void BM_ClientGeoJsonParse(benchmark::State& state) {
+    auto source = pointSource();
+    auto tiles = pointTiles();
+    MercatorProjection projection;
+
+    size_t next = state.thread_index * tiles.size() / state.threads;
+    size_t features = 0;
+
+    while (state.KeepRunning()) {
+        TileID tileId = tiles[next++ % tiles.size()];
+        TileTask task(tileId, source, 0);
+
+        auto data = source->parse(task, projection);
+        if (data) { features += data->layers[0].features.size(); }
+    }
+    benchmark::DoNotOptimize(features);
+
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ClientGeoJsonParse)->ThreadRange(1, 8)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,71 @@
+#include "data/clusterIndex.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "tile/tileID.h"
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+static std::shared_ptr<ClusterIndex::Points> randomPoints(size_t _count) {
+    auto points = std::make_shared<ClusterIndex::Points>();
+    points->reserve(_count);
+
+    std::mt19937 random(0);
+    std::uniform_real_distribution<double> lon(-180, 180);
+    std::uniform_real_distribution<double> lat(-80, 80);
+
+    for (size_t i = 0; i < _count; i++) {
+        Properties props;
+        props.set("value", double(i % 100));
+        points->push_back({ LngLat(lon(random), lat(random)), props });
+    }
+    return points;
+}
+
+static ClusterIndex::Options clusterOptions() {
+    ClusterIndex::Options options;
+    options.aggregates.push_back({ "value", ClusterIndex::Aggregation::sum, "value_sum" });
+    return options;
+}
+
+// range_x: number of points
+static void BM_ClusterIndexBuild(benchmark::State& state) {
+    auto points = randomPoints(state.range_x());
+    auto options = clusterOptions();
+
+    while (state.KeepRunning()) {
+        ClusterIndex index(points, options);
+        benchmark::DoNotOptimize(index.size(0));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range_x());
+}
+BENCHMARK(BM_ClusterIndexBuild)->Arg(10000)->Arg(1000000);
+
+// range_x: zoom of the queried tiles
+static void BM_ClusterIndexGetTile(benchmark::State& state) {
+    static ClusterIndex index(randomPoints(1000000), clusterOptions());
+
+    int32_t z = state.range_x();
+    int32_t n = 1 << z;
+    size_t features = 0;
+    int32_t i = 0;
+
+    while (state.KeepRunning()) {
+        Layer layer("");
+        index.getTile(TileID((i * 7) % n, (i * 13) % n, z), 0, layer);
+        features += layer.features.size();
+        i++;
+    }
+    state.SetItemsProcessed(features);
+    std::string label = std::to_string(index.size(z)) + " clusters at zoom";
+    state.SetLabel(label.c_str());
+}
+BENCHMARK(BM_ClusterIndexGetTile)->Arg(0)->Arg(4)->Arg(8)->Arg(12)->Arg(18);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,144 @@
+#include "data/tileData.h"
+#include "scene/drawRule.h"
+#include "scene/filterProgram.h"
+#include "scene/filters.h"
+#include "scene/scene.h"
+#include "scene/sceneLayer.h"
+#include "scene/sceneLoader.h"
+#include "scene/styleContext.h"
+#include "yaml-cpp/yaml.h"
+
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Features and filters from yamlFilterTests.cpp
+struct FilterFixture {
+
+    StyleContext ctx;
+    std::vector<Feature> features;
+    std::vector<Filter> filters;
+
+    FilterFixture() {
+        Feature civic, bmw1, bike;
+
+        civic.props.set("name", "civic");
+        civic.props.set("brand", "honda");
+        civic.props.set("wheel",  4);
+        civic.props.set("drive", "fwd");
+        civic.props.set("type", "car");
+
+        bmw1.props.set("name", "bmw320i");
+        bmw1.props.set("brand", "bmw");
+        bmw1.props.set("check", "false");
+        bmw1.props.set("series", "3");
+        bmw1.props.set("wheel", 4);
+        bmw1.props.set("drive", "all");
+        bmw1.props.set("type", "car");
+        bmw1.props.set("serial", 4398046511104);
+
+        bike.props.set("name", "cb1100");
+        bike.props.set("brand", "honda");
+        bike.props.set("wheel", 2);
+        bike.props.set("type", "bike");
+        bike.props.set("series", "CB");
+        bike.props.set("check", "available");
+        bike.props.set("serial", 4398046511105);
+
+        features = { civic, bmw1, bike };
+
+        ctx.setKeyword("$geometry", Value(1));
+        ctx.setKeyword("$zoom", Value("false"));
+
+        for (auto* yaml : {
+                "filter: { series: !!str 3}",
+                "filter: { name : [civic, bmw320i] }",
+                "filter: {wheel : {min : 2, max : 5}}",
+                "filter: {any : [{name : civic}, {name : bmw320i}]}",
+                "filter: {all : [ {name : civic}, {brand : honda}, {wheel: 4} ] }",
+                "filter: {none : [{name : civic}, {name : bmw320i}]}",
+                "filter: {check : false}",
+                "filter: {serial : 4398046511105}",
+                "filter: {any : [{$geometry: 1}, {brand: bmw}, {wheel: {max: 3}}]}",
+                "filter: {all : [{drive: [fwd, all]}, {type: car}, {check: {exists: false}}]}" }) {
+            Scene scene;
+            filters.push_back(SceneLoader::generateFilter(YAML::Load(yaml)["filter"], scene));
+        }
+    }
+};
+
+// Layer hierarchy from layerTests.cpp
+SceneLayer layerInstance() {
+    Filter base = Filter::MatchExistence("base", true);
+    Filter one = Filter::MatchExistence("one", true);
+    Filter two = Filter::MatchExistence("two", true);
+
+    DrawRuleData rule1 = { "group1", 1, { { StyleParamKey::order, "a" } } };
+    DrawRuleData rule2 = { "group2", 2, {} };
+
+    return { "layer", base, { rule1 }, {
+            { "subLayer1", one, { rule1 }, {} },
+            { "subLayer2", two, { rule2 }, {} } } };
+}
+
+static void BM_FilterEval(benchmark::State& state) {
+    FilterFixture fixture;
+    size_t matches = 0;
+
+    while (state.KeepRunning()) {
+        for (auto& filter : fixture.filters) {
+            for (auto& feature : fixture.features) {
+                matches += filter.eval(feature, fixture.ctx);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(matches);
+}
+BENCHMARK(BM_FilterEval);
+
+static void BM_FilterProgramEval(benchmark::State& state) {
+    FilterFixture fixture;
+    std::vector<FilterProgram> programs;
+    for (auto& filter : fixture.filters) { programs.emplace_back(filter); }
+
+    size_t matches = 0;
+
+    while (state.KeepRunning()) {
+        for (auto& program : programs) {
+            for (auto& feature : fixture.features) {
+                matches += program.eval(feature, fixture.ctx);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(matches);
+}
+BENCHMARK(BM_FilterProgramEval);
+
+static void BM_LayerMatch(benchmark::State& state) {
+    StyleContext ctx;
+    DrawRuleMergeSet ruleSet;
+    auto layer = layerInstance();
+
+    std::vector<Feature> features(4);
+    features[0].props.set("base", "blah");
+    features[1].props.set("one", "blah");
+    features[1].props.set("base", "blah");
+    features[2].props.set("two", "blah");
+    features[3].props.set("two", "blah");
+    features[3].props.set("base", "blah");
+
+    size_t matches = 0;
+
+    while (state.KeepRunning()) {
+        for (auto& feature : features) {
+            matches += ruleSet.match(feature, layer, ctx);
+        }
+    }
+    benchmark::DoNotOptimize(matches);
+}
+BENCHMARK(BM_LayerMatch);
+
+BENCHMARK_MAIN();
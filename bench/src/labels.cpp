@@ -0,0 +1,102 @@
+#include "tangram.h"
+#include "platform.h"
+#include "labels/labels.h"
+#include "labels/labelSet.h"
+#include "labels/textLabel.h"
+#include "labels/textLabels.h"
+#include "style/textStyle.h"
+#include "tile/tile.h"
+#include "tile/tileCache.h"
+#include "view/view.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Label setup from labelsTests.cpp
+static TextStyle dummyStyle("textStyle");
+static TextLabels dummy(dummyStyle);
+
+struct BenchLabelMesh : public LabelSet {
+    void addLabel(std::unique_ptr<Label> _label) { m_labels.push_back(std::move(_label)); }
+};
+
+static std::unique_ptr<TextLabel> makeLabel(glm::vec2 _position, glm::vec2 _size, float _priority) {
+    Label::Options options;
+    options.offset = {0.0f, 0.0f};
+    options.priority = _priority;
+    options.properties = std::make_shared<Properties>();
+
+    return std::unique_ptr<TextLabel>(new TextLabel(Label::Transform{_position}, Label::Type::point,
+                                                    options, LabelProperty::Anchor::center,
+                                                    {}, _size, dummy, {}));
+}
+
+// range_x: 0 for a static view, otherwise pixels to pan on every update
+static void BM_LabelsUpdate(benchmark::State& state) {
+    float pan = state.range_x();
+    const int numLabels = 4000;
+
+    View view(1024, 1024);
+    view.setPosition(0, 0);
+    view.setZoom(2);
+    view.update(false);
+
+    auto labelMesh = std::unique_ptr<BenchLabelMesh>(new BenchLabelMesh());
+    auto textStyle = std::unique_ptr<TextStyle>(new TextStyle("test", false));
+    textStyle->setID(0);
+
+    std::mt19937 random(0);
+    std::uniform_real_distribution<float> position(0.f, 1.f);
+    std::uniform_int_distribution<int> priority(0, 10);
+
+    for (int i = 0; i < numLabels; i++) {
+        labelMesh->addLabel(makeLabel({position(random), position(random)}, {60, 14},
+                                      priority(random)));
+    }
+
+    std::shared_ptr<Tile> tile(new Tile({0,0,0}, view.getMapProjection()));
+    tile->initGeometry(1);
+    tile->setMesh(*textStyle.get(), std::move(labelMesh));
+    tile->update(0, view);
+
+    std::vector<std::unique_ptr<Style>> styles;
+    styles.push_back(std::move(textStyle));
+
+    std::vector<std::shared_ptr<Tile>> tiles = { tile };
+    std::unique_ptr<TileCache> cache(new TileCache(0));
+
+    Labels labels;
+    double x = 0;
+    int step = 0;
+
+    while (state.KeepRunning()) {
+        if (pan > 0) {
+            // Pan back and forth, so that the labels stay in view
+            float direction = (step++ / 8) % 2 ? -1.f : 1.f;
+            x += direction * pan / view.pixelsPerMeter();
+            view.setPosition(x, 0);
+            view.update(false);
+            tile->update(0, view);
+        }
+        labels.updateLabelSet(view, 0.016f, styles, tiles, cache);
+
+        // Include the placement, which runs on a worker
+        while (labels.placementPending()) {
+            labels.updateLabels(view, 0.016f, styles, tiles);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * numLabels);
+    std::string label = std::to_string(numLabels) + " labels";
+    state.SetLabel(label.c_str());
+}
+BENCHMARK(BM_LabelsUpdate)->Arg(0)->Arg(4)->Arg(64)->UseRealTime();
+
+BENCHMARK_MAIN();
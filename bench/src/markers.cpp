@@ -0,0 +1,76 @@
+#include "tangram.h"
+#include "platform.h"
+#include "labels/labels.h"
+#include "marker/markerManager.h"
+#include "scene/scene.h"
+#include "style/pointStyle.h"
+#include "tile/tile.h"
+#include "tile/tileCache.h"
+#include "view/view.h"
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// range_x: number of the 10k markers that move on every update
+static void BM_MarkersUpdate(benchmark::State& state) {
+    const int numMarkers = 10000;
+    int moved = state.range_x();
+
+    View view(1024, 1024);
+    view.setPosition(0, 0);
+    view.setZoom(12);
+    view.update(false);
+
+    auto scene = std::make_shared<Scene>();
+    auto* style = new PointStyle("points");
+    scene->styles().emplace_back(style);
+    style->setID(0);
+    style->build(*scene);
+
+    MarkerManager markers;
+    markers.setScene(scene);
+
+    std::mt19937 random(0);
+    std::uniform_real_distribution<double> position(-5000, 5000);
+
+    std::vector<MarkerID> ids;
+    for (int i = 0; i < numMarkers; i++) {
+        MarkerID id = markers.add();
+        markers.setPosition(id, {position(random), position(random)});
+        ids.push_back(id);
+    }
+
+    std::vector<std::shared_ptr<Tile>> tiles;
+    std::unique_ptr<TileCache> cache(new TileCache(0));
+
+    Labels labels;
+    size_t next = 0;
+
+    while (state.KeepRunning()) {
+        for (int i = 0; i < moved; i++) {
+            markers.setPosition(ids[next++ % numMarkers], {position(random), position(random)});
+        }
+
+        style->getMesh()->clear();
+
+        if (markers.update(view)) {
+            labels.updateLabelSet(view, 0.016f, scene->styles(), tiles, cache, &markers);
+        } else {
+            labels.updateLabels(view, 0.016f, scene->styles(), tiles, true, &markers);
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * moved);
+    std::string label = std::to_string(numMarkers) + " markers";
+    state.SetLabel(label.c_str());
+}
+BENCHMARK(BM_MarkersUpdate)->Arg(0)->Arg(100)->Arg(10000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,133 @@
+#include "data/tileData.h"
+#include "util/arena.h"
+#include "util/pbfParser.h"
+#include "platform.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Count heap allocations to report allocations per tile
+static std::atomic<uint64_t> s_allocations(0);
+
+void* operator new(size_t _size) {
+    s_allocations++;
+    if (void* ptr = std::malloc(_size ? _size : 1)) { return ptr; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* _ptr) noexcept {
+    std::free(_ptr);
+}
+
+static std::vector<char> loadTile(const char* _path) {
+    std::vector<char> data;
+    std::ifstream resource(_path, std::ifstream::ate | std::ifstream::binary);
+    if (!resource.is_open()) {
+        LOGE("Failed to read file at path: %s", _path);
+        return data;
+    }
+    data.resize(resource.tellg());
+    resource.seekg(std::ifstream::beg);
+    resource.read(data.data(), data.size());
+    return data;
+}
+
+// Baseline: nested Layer/Feature vectors with owned property strings
+static size_t parseTile(const std::vector<char>& _rawTileData) {
+    TileData tileData;
+    PbfParser::ParserContext ctx(0);
+
+    protobuf::message item(_rawTileData.data(), _rawTileData.size());
+    while (item.next()) {
+        if (item.tag == 3) {
+            tileData.layers.push_back(PbfParser::getLayer(ctx, item.getMessage()));
+        } else {
+            item.skip();
+        }
+    }
+
+    size_t features = 0;
+    for (auto& layer : tileData.layers) { features += layer.features.size(); }
+    return features;
+}
+
+// Flat layers in the worker arena, strings point into the tile data
+static size_t parseTileFlat(const std::vector<char>& _rawTileData, Arena& _arena) {
+    FlatTileData tileData;
+    PbfParser::ParserContext ctx(0);
+
+    protobuf::message item(_rawTileData.data(), _rawTileData.size());
+    while (item.next()) {
+        if (item.tag == 3) {
+            tileData.layers.push_back(PbfParser::getFlatLayer(ctx, _arena, item.getMessage()));
+        } else {
+            item.skip();
+        }
+    }
+
+    size_t features = 0;
+    for (auto& layer : tileData.layers) { features += layer.features.size(); }
+    return features;
+}
+
+static void setLabel(benchmark::State& state, const char* _name, size_t _features,
+                     uint64_t _tiles, uint64_t _allocations) {
+    std::string label = std::string(_name) + ": " + std::to_string(_features) + " features, " +
+        std::to_string(_tiles ? _allocations / _tiles : 0) + " allocs/tile";
+    state.SetLabel(label.c_str());
+}
+
+static void BM_ParseMVT(benchmark::State& state) {
+    auto rawTileData = loadTile("tile.mvt");
+
+    uint64_t tiles = 0;
+    uint64_t allocations = s_allocations;
+    size_t features = 0;
+
+    while (state.KeepRunning()) {
+        features = parseTile(rawTileData);
+        benchmark::DoNotOptimize(features);
+        tiles++;
+    }
+
+    allocations = s_allocations - allocations;
+
+    state.SetBytesProcessed(tiles * rawTileData.size());
+    setLabel(state, "baseline", features, tiles, allocations);
+}
+BENCHMARK(BM_ParseMVT);
+
+static void BM_ParseMVTFlat(benchmark::State& state) {
+    auto rawTileData = loadTile("tile.mvt");
+
+    // One arena per worker, reset between tiles
+    Arena arena;
+
+    uint64_t tiles = 0;
+    uint64_t allocations = s_allocations;
+    size_t features = 0;
+
+    while (state.KeepRunning()) {
+        features = parseTileFlat(rawTileData, arena);
+        benchmark::DoNotOptimize(features);
+        arena.reset();
+        tiles++;
+    }
+
+    allocations = s_allocations - allocations;
+
+    state.SetBytesProcessed(tiles * rawTileData.size());
+    setLabel(state, "flat", features, tiles, allocations);
+}
+BENCHMARK(BM_ParseMVTFlat);
+
+BENCHMARK_MAIN();
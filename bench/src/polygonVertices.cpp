@@ -0,0 +1,85 @@
+#include "tangram.h"
+#include "gl.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "gl/vertexLayout.h"
+#include "scene/drawRule.h"
+#include "scene/scene.h"
+#include "scene/sceneLayer.h"
+#include "style/polygonStyle.h"
+#include "tile/tile.h"
+#include "util/mapProjection.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Grid of extruded building footprints
+static std::vector<Feature> buildings() {
+    std::vector<Feature> features;
+    const int n = 32;
+    const float size = 1.f / n;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            float x = i * size, y = j * size, w = size * 0.8f;
+            Feature feature;
+            feature.geometryType = GeometryType::polygons;
+            feature.polygons.push_back({{
+                {x, y, 0}, {x + w, y, 0}, {x + w, y + w, 0}, {x, y + w, 0}, {x, y, 0}
+            }});
+            feature.props.set("height", 10 + (i * j) % 40);
+            features.push_back(std::move(feature));
+        }
+    }
+    return features;
+}
+
+// range_x: 0 for the float normal layout, 1 for the compact layout
+static void BM_BuildPolygonVertices(benchmark::State& state) {
+    bool compact = state.range_x() != 0;
+
+    Scene scene;
+    PolygonStyle style("polygons");
+    style.setCompactVertices(compact);
+    style.build(scene);
+
+    MercatorProjection projection;
+    Tile tile({0, 0, 16}, projection);
+
+    SceneLayer layer("buildings", Filter(), {}, {});
+    DrawRuleData ruleData = { "polygons", 0, {
+            { StyleParamKey::color, "#ff0000" },
+            { StyleParamKey::extrude, "true" },
+            { StyleParamKey::order, "1" } } };
+    DrawRule rule(ruleData, layer);
+
+    auto features = buildings();
+    auto builder = style.createBuilder();
+
+    size_t memory = 0;
+    size_t items = 0;
+
+    while (state.KeepRunning()) {
+        builder->setup(tile);
+        for (auto& feature : features) {
+            builder->addFeature(feature, rule);
+        }
+        auto mesh = builder->build();
+        memory = mesh->bufferSize();
+        benchmark::DoNotOptimize(memory);
+        items += features.size();
+    }
+
+    state.SetItemsProcessed(items);
+    std::string label = std::to_string(memory / 1024) + " kb per tile, " +
+        std::to_string(style.vertexLayout()->getStride()) + " bytes per vertex";
+    state.SetLabel(label.c_str());
+}
+BENCHMARK(BM_BuildPolygonVertices)->Arg(0)->Arg(1);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,127 @@
+#include "data/rawCache.h"
+#include "tile/tileHash.h"
+#include "tile/tileID.h"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+const static int NUM_TILES = 1024;
+const static size_t TILE_SIZE = 16 * 1024;
+
+// The cache DataSource used before RawCache was sharded:
+// One LRU list behind one mutex.
+struct LockedRawCache {
+    using Data = std::shared_ptr<std::vector<char>>;
+    using CacheList = std::list<std::pair<TileID, Data>>;
+
+    std::mutex mutex;
+    std::unordered_map<TileID, CacheList::iterator> map;
+    CacheList list;
+    uint64_t usage = 0;
+    uint64_t maxUsage = 0;
+
+    void setMaxUsage(uint64_t _maxUsage) { maxUsage = _maxUsage; }
+
+    bool get(const TileID& _tileID, Data& _data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = map.find(_tileID);
+        if (it == map.end()) { return false; }
+
+        list.splice(list.begin(), list, it->second);
+        _data = list.front().second;
+        return true;
+    }
+
+    void put(const TileID& _tileID, Data _data) {
+        std::lock_guard<std::mutex> lock(mutex);
+        usage += _data->size();
+        list.push_front({_tileID, std::move(_data)});
+        map[_tileID] = list.begin();
+
+        while (usage > maxUsage) {
+            usage -= list.back().second->size();
+            map.erase(list.back().first);
+            list.pop_back();
+        }
+    }
+};
+
+template<typename Cache>
+struct CacheContext {
+    Cache cache;
+    std::vector<TileID> tiles;
+
+    CacheContext() {
+        cache.setMaxUsage(uint64_t(NUM_TILES) * TILE_SIZE * 2);
+
+        for (int i = 0; i < NUM_TILES; i++) {
+            tiles.emplace_back(i % 32, i / 32, 14);
+            cache.put(tiles.back(), std::make_shared<std::vector<char>>(TILE_SIZE));
+        }
+    }
+
+    static CacheContext& get() {
+        static CacheContext s_context;
+        return s_context;
+    }
+};
+
+// Every iteration looks up one cached tile, like DataSource::createTask()
+// and the URL callback threads do.
+template<typename Cache>
+static void cacheHits(benchmark::State& state) {
+    auto& context = CacheContext<Cache>::get();
+
+    std::minstd_rand rand(state.thread_index);
+    typename Cache::Data data;
+
+    while (state.KeepRunning()) {
+        auto& id = context.tiles[rand() % NUM_TILES];
+        benchmark::DoNotOptimize(context.cache.get(id, data));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Tangram_LockedRawCache_Hit(benchmark::State& state) {
+    cacheHits<LockedRawCache>(state);
+}
+BENCHMARK(BM_Tangram_LockedRawCache_Hit)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
+
+static void BM_Tangram_RawCache_Hit(benchmark::State& state) {
+    cacheHits<RawCache>(state);
+}
+BENCHMARK(BM_Tangram_RawCache_Hit)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
+
+// Mixed lookups and inserts of new tiles, which evict old ones
+static void BM_Tangram_RawCache_PutTinyLFU(benchmark::State& state) {
+    static RawCache s_cache;
+    s_cache.setMaxUsage(uint64_t(NUM_TILES) * TILE_SIZE);
+    s_cache.setFrequencyAdmission(true);
+
+    std::minstd_rand rand(state.thread_index);
+    RawCache::Data data;
+    auto tileData = std::make_shared<std::vector<char>>(TILE_SIZE);
+
+    while (state.KeepRunning()) {
+        // Skewed access: most requests hit a small hot set
+        int n = rand() % 8 == 0 ? rand() % (NUM_TILES * 4) : rand() % (NUM_TILES / 4);
+        TileID id(n % 64, n / 64, 14);
+
+        if (!s_cache.get(id, data)) {
+            s_cache.put(id, tileData);
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Tangram_RawCache_PutTinyLFU)->Threads(8)->Threads(16)->Threads(32)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+#include "data/tileData.h"
+#include "scene/styleContext.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Typical filter and style functions of the form used in scene files
+static const std::vector<std::string> s_functions = {
+    R"(function() { return feature.kind === 'park' && $zoom >= 12; })",
+    R"(function() { return $geometry === 'line' || feature.name == 'main'; })",
+    R"(function() { return (feature.scalerank * .5) <= ($zoom - 4); })",
+    R"(function() { return feature.height > 20 ? feature.height : 20; })",
+    R"(function() { return feature.min_zoom <= $zoom; })",
+};
+
+static std::vector<Feature> features() {
+    std::vector<Feature> features(3);
+    features[0].geometryType = GeometryType::polygons;
+    features[0].props.set("kind", "park");
+    features[0].props.set("scalerank", 4);
+    features[0].props.set("min_zoom", 11);
+    features[1].geometryType = GeometryType::lines;
+    features[1].props.set("name", "main");
+    features[1].props.set("min_zoom", 15);
+    features[2].geometryType = GeometryType::polygons;
+    features[2].props.set("kind", "building");
+    features[2].props.set("height", 32);
+    return features;
+}
+
+static void evalFunctions(benchmark::State& state, bool _native) {
+    StyleContext ctx;
+    ctx.setNativeFunctions(_native);
+    ctx.setFunctions(s_functions);
+    ctx.setKeywordZoom(14);
+
+    auto data = features();
+    size_t matches = 0;
+    StyleParam::Value value;
+
+    while (state.KeepRunning()) {
+        for (auto& feature : data) {
+            ctx.setFeature(feature);
+            for (uint32_t id = 0; id < s_functions.size(); id++) {
+                matches += ctx.evalFilter(id);
+                matches += ctx.evalStyle(id, StyleParamKey::order, value);
+            }
+        }
+    }
+    benchmark::DoNotOptimize(matches);
+}
+
+static void BM_StyleFunctionsDuktape(benchmark::State& state) {
+    evalFunctions(state, false);
+}
+BENCHMARK(BM_StyleFunctionsDuktape);
+
+static void BM_StyleFunctionsNative(benchmark::State& state) {
+    evalFunctions(state, true);
+}
+BENCHMARK(BM_StyleFunctionsNative);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,196 @@
+#include "tangram.h"
+#include "data/dataSource.h"
+#include "scene/scene.h"
+#include "tile/tileID.h"
+#include "tile/tileTask.h"
+#include "tile/tileTaskScheduler.h"
+#include "tile/tileWorker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "benchmark/benchmark_api.h"
+#include "benchmark/benchmark.h"
+
+using namespace Tangram;
+
+// Number of tasks kept in the queue while popping, roughly the
+// backlog seen while panning quickly over a dense city.
+const static int BACKLOG_SIZE = 512;
+
+struct BenchSource : DataSource {
+    BenchSource() : DataSource("bench", "") {}
+
+    std::shared_ptr<TileData> parse(const TileTask& _task,
+                                    const MapProjection& _projection) const override {
+        return nullptr;
+    }
+};
+
+// The queue TileWorker used before TileTaskScheduler: One vector behind one
+// mutex with a linear scan for the next task.
+struct LockedVectorQueue {
+    LockedVectorQueue(size_t) {}
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<TileTask>> queue;
+
+    void push(std::shared_ptr<TileTask>&& _task) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queue.push_back(std::move(_task));
+    }
+
+    std::shared_ptr<TileTask> pop(size_t) {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto removes = std::remove_if(queue.begin(), queue.end(),
+                                      [](const auto& a) { return a->isCanceled(); });
+        queue.erase(removes, queue.end());
+
+        if (queue.empty()) { return nullptr; }
+
+        auto it = std::min_element(queue.begin(), queue.end(),
+            [](const auto& a, const auto& b) {
+                if (a->isProxy() != b->isProxy()) {
+                    return !a->isProxy();
+                }
+                if (a->source().id() == b->source().id() &&
+                    a->sourceGeneration() != b->sourceGeneration()) {
+                    return a->sourceGeneration() < b->sourceGeneration();
+                }
+                return a->getPriority() < b->getPriority();
+            });
+
+        auto task = std::move(*it);
+        queue.erase(it);
+        return task;
+    }
+
+    void reprioritize() {}
+};
+
+template<typename Queue>
+struct QueueContext {
+    int threads;
+    Queue queue;
+
+    QueueContext(int _threads) : threads(_threads), queue(_threads) {
+        auto source = std::make_shared<BenchSource>();
+        std::minstd_rand rand(0);
+
+        for (int i = 0; i < BACKLOG_SIZE; i++) {
+            TileID id(i % 64, i / 64, 14);
+            auto task = std::make_shared<TileTask>(id, source, -1);
+            task->setPriority(rand());
+            task->setProxyState(i % 8 == 0);
+            queue.push(std::move(task));
+        }
+    }
+
+    // Returns the context shared by all threads of one benchmark run
+    static std::shared_ptr<QueueContext> get(int _threads) {
+        static std::mutex s_mutex;
+        static std::shared_ptr<QueueContext> s_context;
+
+        std::lock_guard<std::mutex> lock(s_mutex);
+        if (!s_context || s_context->threads != _threads) {
+            s_context = std::make_shared<QueueContext>(_threads);
+        }
+        return s_context;
+    }
+};
+
+// Every iteration pops the best task and puts it back with a new priority,
+// so that the backlog stays constant. Thread 0 additionally simulates the
+// TileManager updating priorities once per frame. This measures the queues
+// alone, see BM_Tangram_TileWorker_Process for the cost of the worker loop.
+template<typename Queue>
+static void popTasks(benchmark::State& state) {
+    auto context = QueueContext<Queue>::get(state.threads);
+    auto& queue = context->queue;
+
+    std::minstd_rand rand(state.thread_index);
+    size_t count = 0;
+
+    while (state.KeepRunning()) {
+        auto task = queue.pop(state.thread_index);
+        if (!task) { continue; }
+
+        task->setPriority(rand());
+        queue.push(std::move(task));
+
+        if (state.thread_index == 0 && (++count % 64) == 0) {
+            queue.reprioritize();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_Tangram_LockedVectorQueue_Pop(benchmark::State& state) {
+    popTasks<LockedVectorQueue>(state);
+}
+BENCHMARK(BM_Tangram_LockedVectorQueue_Pop)->ThreadRange(1, 16)->UseRealTime();
+
+static void BM_Tangram_TileTaskScheduler_Pop(benchmark::State& state) {
+    popTasks<TileTaskScheduler>(state);
+}
+BENCHMARK(BM_Tangram_TileTaskScheduler_Pop)->ThreadRange(1, 16)->UseRealTime();
+
+// Task that stands in for building a tile: a fixed amount of work
+// without touching the TileBuilder
+struct BenchTask : TileTask {
+    std::atomic<int>& done;
+
+    BenchTask(TileID& _id, std::shared_ptr<DataSource> _source, std::atomic<int>& _done)
+        : TileTask(_id, _source, -1), done(_done) {}
+
+    void process(TileBuilder& _tileBuilder) override {
+        volatile uint32_t hash = 0;
+        for (int i = 0; i < 2000; i++) { hash = hash * 31 + i; }
+        done++;
+    }
+};
+
+// Runs tasks through the real TileWorker, including enqueue, the worker
+// wakeups and the locks around them. Every iteration enqueues one backlog
+// and waits until the workers have processed all of it.
+static void BM_Tangram_TileWorker_Process(benchmark::State& state) {
+    int numWorkers = state.range_x();
+
+    auto scene = std::make_shared<Scene>();
+    auto source = std::make_shared<BenchSource>();
+
+    TileWorker worker(numWorkers);
+    worker.setScene(scene);
+
+    std::minstd_rand rand(0);
+    std::atomic<int> done(0);
+
+    while (state.KeepRunning()) {
+        done = 0;
+
+        for (int i = 0; i < BACKLOG_SIZE; i++) {
+            TileID id(i % 64, i / 64, 14);
+            auto task = std::make_shared<BenchTask>(id, source, done);
+            task->setPriority(rand());
+            worker.enqueue(std::move(task));
+
+            if (i % 64 == 0) { worker.updatePriorities(); }
+        }
+
+        while (done < BACKLOG_SIZE) {
+            std::this_thread::yield();
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * BACKLOG_SIZE);
+
+    worker.stop();
+}
+BENCHMARK(BM_Tangram_TileWorker_Process)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime();
+
+BENCHMARK_MAIN();
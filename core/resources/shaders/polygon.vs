@@ -22,7 +22,12 @@ uniform float u_proxy_depth;
 
 attribute vec4 a_position;
 attribute vec4 a_color;
-attribute vec3 a_normal;
+
+#ifdef TANGRAM_PACKED_NORMAL
+    attribute vec2 a_packed_normal;
+#else
+    attribute vec3 a_normal;
+#endif
 
 #ifdef TANGRAM_USE_TEX_COORDS
     attribute vec2 a_texcoord;
@@ -44,6 +49,18 @@ vec4 modelPosition() {
     return vec4(UNPACK_POSITION(a_position.xyz) * exp2(u_tile_origin.z - u_tile_origin.w), 1.0);
 }
 
+#ifdef TANGRAM_PACKED_NORMAL
+    // Decode octahedral encoded normal
+    vec3 unpackNormal() {
+        vec3 n = vec3(a_packed_normal, 1.0 - abs(a_packed_normal.x) - abs(a_packed_normal.y));
+        if (n.z < 0.0) {
+            n.xy = (1.0 - abs(n.yx)) * vec2(n.x >= 0.0 ? 1.0 : -1.0, n.y >= 0.0 ? 1.0 : -1.0);
+        }
+        return normalize(n);
+    }
+    #define a_normal unpackNormal()
+#endif
+
 vec4 worldPosition() {
     return v_world_position;
 }
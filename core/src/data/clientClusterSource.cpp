@@ -0,0 +1,196 @@
+#include "clientClusterSource.h"
+
+#include "platform.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "tile/tileTask.h"
+#include "util/geoJson.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+ClientClusterSource::ClientClusterSource(const std::string& _name, const std::string& _url,
+                                         ClusterIndex::Options _options, int32_t _maxZoom)
+    : DataSource(_name, _url, _maxZoom), m_options(std::move(_options)) {
+
+    if (!_url.empty()) {
+        // Load from file
+        const auto& string = stringFromFile(_url.c_str(), PathType::resource);
+        addData(string);
+    }
+}
+
+ClientClusterSource::~ClientClusterSource() {}
+
+std::shared_ptr<TileTask> ClientClusterSource::createTask(TileID _tileId, int _subTask) {
+    return std::make_shared<TileTask>(_tileId, shared_from_this(), _subTask);
+}
+
+bool ClientClusterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
+
+    _cb.func(std::move(_task));
+
+    return true;
+}
+
+void ClientClusterSource::addData(const std::string& _data) {
+
+    const char* error = nullptr;
+    size_t offset = 0;
+
+    auto document = JsonParseBytes(_data.data(), _data.size(), &error, &offset);
+
+    if (error) {
+        LOGE("Json parsing failed on source '%s': %s (%u)", m_name.c_str(), error, offset);
+        return;
+    }
+    if (!GeoJson::isFeatureCollection(document)) {
+        LOGE("GeoJSON of source '%s' is not a FeatureCollection", m_name.c_str());
+        return;
+    }
+
+    // Coordinates are read as doubles, GeoJson::getPoint() gives floats
+    auto isPosition = [](const JsonValue& _coords) {
+        return _coords.IsArray() && _coords.Size() >= 2 &&
+            _coords[0].IsNumber() && _coords[1].IsNumber();
+    };
+    auto lngLat = [](const JsonValue& _coords) {
+        return LngLat(_coords[0].GetDouble(), _coords[1].GetDouble());
+    };
+
+    size_t skipped = 0;
+    auto& features = document["features"];
+
+    for (auto it = features.Begin(); it != features.End(); ++it) {
+        if (!it->IsObject()) {
+            skipped++;
+            continue;
+        }
+        auto geometry = it->FindMember("geometry");
+        if (geometry == it->MemberEnd() || !geometry->value.IsObject()) {
+            skipped++;
+            continue;
+        }
+        auto type = geometry->value.FindMember("type");
+        auto coords = geometry->value.FindMember("coordinates");
+        if (type == geometry->value.MemberEnd() || !type->value.IsString() ||
+            coords == geometry->value.MemberEnd()) {
+            skipped++;
+            continue;
+        }
+
+        bool isPoint = type->value == "Point";
+        bool isMultiPoint = type->value == "MultiPoint";
+
+        if (isPoint && !isPosition(coords->value)) {
+            isPoint = false;
+        } else if (isMultiPoint) {
+            auto& points = coords->value;
+            isMultiPoint = points.IsArray() &&
+                std::all_of(points.Begin(), points.End(), isPosition);
+        }
+        if (!isPoint && !isMultiPoint) {
+            skipped++;
+            continue;
+        }
+
+        Properties props;
+        auto properties = it->FindMember("properties");
+        if (properties != it->MemberEnd() && properties->value.IsObject()) {
+            props = GeoJson::getProperties(properties->value, m_id);
+        }
+
+        if (isPoint) {
+            m_pending.push_back({ lngLat(coords->value), std::move(props) });
+        } else {
+            auto& points = coords->value;
+            for (auto point = points.Begin(); point != points.End(); ++point) {
+                m_pending.push_back({ lngLat(*point), props });
+            }
+        }
+    }
+
+    if (skipped > 0) {
+        LOGW("Skipped %d features without valid point geometry in source '%s'", int(skipped), m_name.c_str());
+    }
+
+    if (m_batchDepth == 0) { commitPoints(); }
+}
+
+void ClientClusterSource::addPoint(const Properties& _props, LngLat _point) {
+
+    m_pending.push_back({ _point, _props });
+
+    if (m_batchDepth == 0) { commitPoints(); }
+}
+
+void ClientClusterSource::beginBatch() {
+    m_batchDepth++;
+}
+
+void ClientClusterSource::commitBatch() {
+    if (m_batchDepth == 0) {
+        LOGW("commitBatch() without beginBatch()");
+        return;
+    }
+    if (--m_batchDepth == 0) {
+        commitPoints();
+    }
+}
+
+void ClientClusterSource::commitPoints() {
+
+    if (m_pending.empty()) { return; }
+
+    auto points = std::make_shared<ClusterIndex::Points>();
+    if (m_points) {
+        points->reserve(m_points->size() + m_pending.size());
+        points->insert(points->end(), m_points->begin(), m_points->end());
+    }
+    for (auto& point : m_pending) {
+        points->push_back(std::move(point));
+    }
+    m_pending.clear();
+
+    m_points = points;
+
+    auto index = std::make_shared<const ClusterIndex>(m_points, m_options);
+    std::atomic_store(&m_index, index);
+
+    // Any cluster can change when points are added
+    invalidateAll();
+}
+
+void ClientClusterSource::clearData() {
+
+    m_pending.clear();
+    m_points.reset();
+
+    std::atomic_store(&m_index, std::shared_ptr<const ClusterIndex>());
+    invalidateAll();
+}
+
+size_t ClientClusterSource::clusterCount(int32_t _zoom) const {
+    auto index = std::atomic_load(&m_index);
+    return index ? index->size(_zoom) : 0;
+}
+
+std::shared_ptr<TileData> ClientClusterSource::parse(const TileTask& _task,
+                                                     const MapProjection& _projection) const {
+
+    auto index = std::atomic_load(&m_index);
+    if (!index) { return nullptr; }
+
+    auto data = std::make_shared<TileData>();
+
+    Layer layer(""); // empty name will skip filtering by 'collection'
+
+    index->getTile(_task.tileId(), m_id, layer);
+
+    data->layers.emplace_back(std::move(layer));
+
+    return data;
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "dataSource.h"
+#include "data/clusterIndex.h"
+#include "util/types.h"
+
+#include <memory>
+#include <vector>
+
+namespace Tangram {
+
+struct Properties;
+
+/* Source for large sets of client points that are shown as clusters
+ *
+ * Tiles up to the maximum zoom of the cluster options contain clusters with
+ * the properties 'cluster', 'point_count' and the configured aggregates, and
+ * the points that have no neighbor within the cluster radius. Above it all
+ * points are shown. The cost of a tile depends on the number of clusters in
+ * it, not on the total number of points.
+ */
+class ClientClusterSource : public DataSource {
+
+public:
+
+    /* Points of the GeoJSON file at @_url are added on construction */
+    ClientClusterSource(const std::string& _name, const std::string& _url,
+                        ClusterIndex::Options _options = {}, int32_t _maxZoom = 18);
+    ~ClientClusterSource();
+
+    /* Add the Point and MultiPoint features of a GeoJSON FeatureCollection,
+     * other geometries are skipped */
+    void addData(const std::string& _data);
+
+    /* Add a point. The cluster index is built again for all points, use
+     * beginBatch() and commitBatch() to add many points at once. */
+    void addPoint(const Properties& _props, LngLat _point);
+
+    void beginBatch();
+    void commitBatch();
+
+    // Number of clusters and unclustered points at @_zoom
+    size_t clusterCount(int32_t _zoom) const;
+
+    virtual bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
+    std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override;
+
+    virtual void cancelLoadingTile(const TileID& _tile) override {};
+    virtual void clearData() override;
+
+protected:
+
+    virtual std::shared_ptr<TileData> parse(const TileTask& _task,
+                                            const MapProjection& _projection) const override;
+
+    // Build the index for the pending points
+    void commitPoints();
+
+    ClusterIndex::Options m_options;
+
+    // Points of the current index, shared with it
+    std::shared_ptr<const ClusterIndex::Points> m_points;
+
+    // Published with std::atomic_store, tile workers query the index they
+    // loaded while a new one is built
+    std::shared_ptr<const ClusterIndex> m_index;
+
+    // Points added since the last commit
+    ClusterIndex::Points m_pending;
+    int m_batchDepth = 0;
+
+};
+
+}
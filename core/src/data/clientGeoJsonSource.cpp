@@ -11,11 +11,17 @@
 #include "tile/tile.h"
 #include "view/view.h"
 
+#include <array>
+#include <limits>
+#include <memory>
+#include <mutex>
+
 using namespace mapbox::util;
 
 namespace Tangram {
 
 const double extent = 4096;
+const double buffer = 64; // Tile buffer of GeoJSONVT
 const uint32_t indexMaxPoints = 100000;
 double tolerance = 1E-8;
 
@@ -28,9 +34,23 @@ Point transformPoint(geojsonvt::TilePoint pt) {
     return { pt.x / extent, 1. - pt.y / extent, 0 };
 }
 
+// Bounding box of @_features in normalized Mercator coordinates
+static BoundingBox featureBounds(const std::vector<geojsonvt::ProjectedFeature>& _features) {
+    BoundingBox bounds{ glm::dvec2(std::numeric_limits<double>::max()),
+                        glm::dvec2(std::numeric_limits<double>::lowest()) };
+
+    for (auto& feature : _features) {
+        bounds.min = glm::min(bounds.min, glm::dvec2(feature.min.x, feature.min.y));
+        bounds.max = glm::max(bounds.max, glm::dvec2(feature.max.x, feature.max.y));
+    }
+    return bounds;
+}
+
 ClientGeoJsonSource::ClientGeoJsonSource(const std::string& _name, const std::string& _url, int32_t _maxZoom)
     : DataSource(_name, _url, _maxZoom) {
 
+    m_tileBuffer = buffer / extent;
+
     if (!_url.empty()) {
         // Load from file
         const auto& string = stringFromFile(_url.c_str(), PathType::resource);
@@ -40,18 +60,193 @@ ClientGeoJsonSource::ClientGeoJsonSource(const std::string& _name, const std::st
 
 ClientGeoJsonSource::~ClientGeoJsonSource() {}
 
+/* Features of one commit and their tile indices
+ *
+ * GeoJSONVT slices and caches tiles in getTile(), which is not safe to call
+ * concurrently. To let workers slice in parallel, the features are split
+ * spatially on the writer thread: A quadtree of cells is refined until each
+ * cell holds at most cellMaxFeatures, and every leaf cell gets its own
+ * index and lock. A tile inside a leaf only waits for workers slicing from
+ * the same cell. Tiles that span several cells, i.e. low zoom tiles, use
+ * one overview index of all features.
+ *
+ * Features are added to every cell they overlap, including a margin of the
+ * tile buffer, so that a leaf index gives the same tiles as a single index.
+ */
+const size_t cellMaxFeatures = 2048;
+
+struct ClientGeoJsonSource::Store {
+
+    struct Index {
+        Index(const std::vector<geojsonvt::ProjectedFeature>& _features, int32_t _maxZoom)
+            : vt(_features, _maxZoom, _maxZoom, indexMaxPoints, tolerance) {}
+
+        std::mutex mutex;
+        GeoJSONVT vt;
+    };
+
+    struct Cell {
+        int32_t z = 0;
+        uint32_t x = 0, y = 0;
+        // Children in the order of childIndex(), empty quadrants are null
+        std::array<std::unique_ptr<Cell>, 4> children;
+        // Leaves only
+        std::unique_ptr<Index> index;
+
+        bool isLeaf() const { return bool(index); }
+    };
+
+    Store(std::vector<geojsonvt::ProjectedFeature> _features, int32_t _maxZoom)
+        : features(std::move(_features)), bounds(featureBounds(features)) {
+
+        split(root, features, _maxZoom);
+
+        if (!root.isLeaf()) {
+            overview = std::make_unique<Index>(features, _maxZoom);
+        }
+    }
+
+    static size_t childIndex(uint32_t _x, uint32_t _y) { return (_x & 1) + 2 * (_y & 1); }
+
+    static void split(Cell& _cell, const std::vector<geojsonvt::ProjectedFeature>& _features,
+                      int32_t _maxZoom) {
+
+        if (_features.size() > cellMaxFeatures && _cell.z < _maxZoom) {
+
+            std::array<std::vector<geojsonvt::ProjectedFeature>, 4> quadrants;
+            size_t total = 0;
+
+            double size = 1.0 / (1 << (_cell.z + 1));
+            double margin = size * buffer / extent;
+
+            for (uint32_t i = 0; i < 4; i++) {
+                double x0 = (_cell.x * 2 + (i & 1)) * size - margin;
+                double y0 = (_cell.y * 2 + (i >> 1)) * size - margin;
+                double x1 = x0 + size + 2 * margin;
+                double y1 = y0 + size + 2 * margin;
+
+                for (auto& feature : _features) {
+                    if (feature.max.x >= x0 && feature.min.x <= x1 &&
+                        feature.max.y >= y0 && feature.min.y <= y1) {
+                        quadrants[i].push_back(feature);
+                    }
+                }
+                total += quadrants[i].size();
+            }
+
+            // Stop when most features span the quadrants, splitting would
+            // only copy them. Features in the margins are copied to both
+            // sides, these copies shrink with the margin further down.
+            if (total <= _features.size() * 2) {
+                for (uint32_t i = 0; i < 4; i++) {
+                    if (quadrants[i].empty()) { continue; }
+
+                    auto child = std::make_unique<Cell>();
+                    child->z = _cell.z + 1;
+                    child->x = _cell.x * 2 + (i & 1);
+                    child->y = _cell.y * 2 + (i >> 1);
+                    split(*child, quadrants[i], _maxZoom);
+                    _cell.children[i] = std::move(child);
+                }
+                return;
+            }
+        }
+
+        _cell.index = std::make_unique<Index>(_features, _maxZoom);
+    }
+
+    // Append the tile of this store to @_tiles unless it has no features there
+    void getTile(const TileID& _tileId, std::vector<geojsonvt::Tile>& _tiles) {
+
+        Cell* cell = &root;
+
+        while (!cell->isLeaf()) {
+            int32_t dz = _tileId.z - (cell->z + 1);
+            // Tile covers more than one child
+            if (dz < 0) { break; }
+
+            cell = cell->children[childIndex(_tileId.x >> dz, _tileId.y >> dz)].get();
+            if (!cell) { return; }
+        }
+
+        Index* index = cell->isLeaf() ? cell->index.get() : overview.get();
+
+        std::lock_guard<std::mutex> lock(index->mutex);
+        _tiles.push_back(index->vt.getTile(_tileId.z, _tileId.x, _tileId.y));
+    }
+
+    const std::vector<geojsonvt::ProjectedFeature> features;
+    const BoundingBox bounds;
+
+    Cell root;
+    std::unique_ptr<Index> overview;
+};
+
+void ClientGeoJsonSource::beginBatch() {
+    m_batchDepth++;
+}
+
+void ClientGeoJsonSource::commitBatch() {
+    if (m_batchDepth == 0) {
+        LOGW("commitBatch() without beginBatch()");
+        return;
+    }
+    if (--m_batchDepth == 0) {
+        commitFeatures();
+    }
+}
+
+void ClientGeoJsonSource::commitFeatures() {
+
+    if (m_pending.empty()) { return; }
+
+    // Only tiles that intersect the new features have to be built again
+    BoundingBox bounds = featureBounds(m_pending);
+
+    // Only this thread replaces the stores
+    auto stores = std::atomic_load(&m_stores);
+    size_t numStores = stores ? stores->size() : 0;
+
+    // Merge with the newest stores that are not larger than the new one
+    size_t merged = numStores;
+    size_t count = m_pending.size();
+
+    while (merged > 0 && (*stores)[merged - 1]->features.size() <= count) {
+        merged--;
+        count += (*stores)[merged]->features.size();
+    }
+
+    std::vector<geojsonvt::ProjectedFeature> features;
+    features.reserve(count);
+    for (size_t i = merged; i < numStores; i++) {
+        auto& storeFeatures = (*stores)[i]->features;
+        features.insert(features.end(), storeFeatures.begin(), storeFeatures.end());
+    }
+    for (auto& feature : m_pending) {
+        features.push_back(std::move(feature));
+    }
+    m_pending.clear();
+
+    // Tiles are sliced from the current stores while the new index is built
+    auto newStores = std::make_shared<Stores>();
+    if (stores) {
+        newStores->assign(stores->begin(), stores->begin() + merged);
+    }
+    newStores->push_back(std::make_shared<Store>(std::move(features), m_maxZoom));
+
+    std::atomic_store(&m_stores, std::shared_ptr<const Stores>(std::move(newStores)));
+    invalidateRegion(bounds);
+}
+
 void ClientGeoJsonSource::addData(const std::string& _data) {
 
     auto features = geojsonvt::GeoJSONVT::convertFeatures(_data);
 
     for (auto& f : features) {
-        m_features.push_back(std::move(f));
+        m_pending.push_back(std::move(f));
     }
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
-
+    if (m_batchDepth == 0) { commitFeatures(); }
 }
 
 bool ClientGeoJsonSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
@@ -63,11 +258,20 @@ bool ClientGeoJsonSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTa
 
 void ClientGeoJsonSource::clearData() {
 
-    m_features.clear();
+    m_pending.clear();
+
+    auto stores = std::atomic_load(&m_stores);
+    if (!stores || stores->empty()) { return; }
+
+    // Tiles outside of the removed features stay valid
+    BoundingBox bounds = stores->front()->bounds;
+    for (auto& store : *stores) {
+        bounds.min = glm::min(bounds.min, store->bounds.min);
+        bounds.max = glm::max(bounds.max, store->bounds.max);
+    }
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store.reset();
-    m_generation++;
+    std::atomic_store(&m_stores, std::shared_ptr<const Stores>());
+    invalidateRegion(bounds);
 }
 
 void ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
@@ -80,11 +284,9 @@ void ClientGeoJsonSource::addPoint(const Properties& _tags, LngLat _point) {
                                               geojsonvt::ProjectedFeatureType::Point,
                                               container.members);
 
-    m_features.push_back(std::move(feature));
+    m_pending.push_back(std::move(feature));
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+    if (m_batchDepth == 0) { commitFeatures(); }
 }
 
 void ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _line) {
@@ -96,11 +298,9 @@ void ClientGeoJsonSource::addLine(const Properties& _tags, const Coordinates& _l
                                               geojsonvt::ProjectedFeatureType::LineString,
                                               geometry);
 
-    m_features.push_back(std::move(feature));
+    m_pending.push_back(std::move(feature));
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+    if (m_batchDepth == 0) { commitFeatures(); }
 }
 
 void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly) {
@@ -115,11 +315,9 @@ void ClientGeoJsonSource::addPoly(const Properties& _tags, const std::vector<Coo
                                               geojsonvt::ProjectedFeatureType::Polygon,
                                               geometry);
 
-    m_features.push_back(std::move(feature));
+    m_pending.push_back(std::move(feature));
 
-    std::lock_guard<std::mutex> lock(m_mutexStore);
-    m_store = std::make_unique<GeoJSONVT>(m_features, m_maxZoom, m_maxZoom, indexMaxPoints, tolerance);
-    m_generation++;
+    if (m_batchDepth == 0) { commitFeatures(); }
 }
 
 std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
@@ -127,64 +325,68 @@ std::shared_ptr<TileData> ClientGeoJsonSource::parse(const TileTask& _task,
 
     auto data = std::make_shared<TileData>();
 
-    geojsonvt::Tile tile;
-    {
-        std::lock_guard<std::mutex> lock(m_mutexStore);
-        if (!m_store) { return nullptr; }
-        tile = m_store->getTile(_task.tileId().z, _task.tileId().x, _task.tileId().y);
+    auto stores = std::atomic_load(&m_stores);
+    if (!stores || stores->empty()) { return nullptr; }
+
+    std::vector<geojsonvt::Tile> tiles;
+
+    for (auto& store : *stores) {
+        store->getTile(_task.tileId(), tiles);
     }
 
     Layer layer(""); // empty name will skip filtering by 'collection'
 
-    for (auto& it : tile.features) {
+    for (auto& tile : tiles) {
+        for (auto& it : tile.features) {
 
-        Feature feat(m_id);
+            Feature feat(m_id);
 
-        const auto& geom = it.tileGeometry;
-        const auto type = it.type;
+            const auto& geom = it.tileGeometry;
+            const auto type = it.type;
 
-        switch (type) {
-            case geojsonvt::TileFeatureType::Point: {
-                feat.geometryType = GeometryType::points;
-                for (const auto& pt : geom) {
-                    const auto& point = pt.get<geojsonvt::TilePoint>();
-                    feat.points.push_back(transformPoint(point));
-                }
-                break;
-            }
-            case geojsonvt::TileFeatureType::LineString: {
-                feat.geometryType = GeometryType::lines;
-                for (const auto& r : geom) {
-                    Line line;
-                    for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
-                        line.push_back(transformPoint(pt));
+            switch (type) {
+                case geojsonvt::TileFeatureType::Point: {
+                    feat.geometryType = GeometryType::points;
+                    for (const auto& pt : geom) {
+                        const auto& point = pt.get<geojsonvt::TilePoint>();
+                        feat.points.push_back(transformPoint(point));
                     }
-                    feat.lines.emplace_back(std::move(line));
+                    break;
                 }
-                break;
-            }
-            case geojsonvt::TileFeatureType::Polygon: {
-                feat.geometryType = GeometryType::polygons;
-                for (const auto& r : geom) {
-                    Line line;
-                    for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
-                        line.push_back(transformPoint(pt));
+                case geojsonvt::TileFeatureType::LineString: {
+                    feat.geometryType = GeometryType::lines;
+                    for (const auto& r : geom) {
+                        Line line;
+                        for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
+                            line.push_back(transformPoint(pt));
+                        }
+                        feat.lines.emplace_back(std::move(line));
                     }
-                    // Polygons are in a flat list of rings, with ccw rings indicating
-                    // the beginning of a new polygon
-                    if (signedArea(line.begin(), line.end()) >= 0 || feat.polygons.empty()) {
-                        feat.polygons.emplace_back();
+                    break;
+                }
+                case geojsonvt::TileFeatureType::Polygon: {
+                    feat.geometryType = GeometryType::polygons;
+                    for (const auto& r : geom) {
+                        Line line;
+                        for (const auto& pt : r.get<geojsonvt::TileRing>().points) {
+                            line.push_back(transformPoint(pt));
+                        }
+                        // Polygons are in a flat list of rings, with ccw rings indicating
+                        // the beginning of a new polygon
+                        if (signedArea(line.begin(), line.end()) >= 0 || feat.polygons.empty()) {
+                            feat.polygons.emplace_back();
+                        }
+                        feat.polygons.back().push_back(std::move(line));
                     }
-                    feat.polygons.back().push_back(std::move(line));
+                    break;
                 }
-                break;
+                default: break;
             }
-            default: break;
-        }
 
-        feat.props = *it.tags.map;
-        layer.features.emplace_back(std::move(feat));
+            feat.props = *it.tags.map;
+            layer.features.emplace_back(std::move(feat));
 
+        }
     }
 
     data->layers.emplace_back(std::move(layer));
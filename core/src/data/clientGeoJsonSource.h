@@ -3,7 +3,8 @@
 #include "dataSource.h"
 #include "util/types.h"
 
-#include <mutex>
+#include <memory>
+#include <vector>
 
 namespace mapbox {
 namespace util {
@@ -32,6 +33,12 @@ public:
     void addLine(const Properties& _tags, const Coordinates& _line);
     void addPoly(const Properties& _tags, const std::vector<Coordinates>& _poly);
 
+    /* Collect the features of following add* calls and add them to the tiles
+     * at once on commitBatch(). Batches can be nested, features are added when
+     * the outermost batch is committed. */
+    void beginBatch();
+    void commitBatch();
+
     virtual bool loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) override;
     std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override;
 
@@ -43,9 +50,26 @@ protected:
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
-    std::unique_ptr<GeoJSONVT> m_store;
-    mutable std::mutex m_mutexStore;
-    std::vector<mapbox::util::geojsonvt::ProjectedFeature> m_features;
+    // Tile index of a set of features
+    struct Store;
+
+    // Add the pending features as a new store
+    void commitFeatures();
+
+    using Stores = std::vector<std::shared_ptr<Store>>;
+
+    /* Stores ordered from the oldest to the newest features. A new store is
+     * merged with the preceding ones as long as they are not larger, so there
+     * are at most log2(n) stores for n features, each feature is re-indexed
+     * at most log2(n) times and the tiles of older stores stay sliced.
+     *
+     * Published with std::atomic_store, tile workers slice from the snapshot
+     * they loaded without blocking writers. */
+    std::shared_ptr<const Stores> m_stores;
+
+    // Features added since the last commit
+    std::vector<mapbox::util::geojsonvt::ProjectedFeature> m_pending;
+    int m_batchDepth = 0;
 
 };
 
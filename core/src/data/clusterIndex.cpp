@@ -0,0 +1,271 @@
+#include "clusterIndex.h"
+
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "tile/tileID.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Tangram {
+
+// Number of nodes in the leaves of the k-d trees
+static const size_t node_size = 64;
+
+// Tile size for the cluster radius
+static const double tile_size = 256;
+
+/* Points or clusters of one zoom level, ordered as a k-d tree */
+struct ClusterIndex::Level {
+    std::vector<Node> nodes;
+
+    void buildIndex() {
+        if (!nodes.empty()) { sort(0, nodes.size() - 1, 0); }
+    }
+
+    void sort(size_t _left, size_t _right, int _axis) {
+        if (_right - _left <= node_size) { return; }
+
+        size_t m = (_left + _right) / 2;
+        std::nth_element(nodes.begin() + _left, nodes.begin() + m, nodes.begin() + _right + 1,
+                         [&](const Node& a, const Node& b) {
+                             return _axis == 0 ? a.x < b.x : a.y < b.y;
+                         });
+
+        sort(_left, m - 1, 1 - _axis);
+        sort(m + 1, _right, 1 - _axis);
+    }
+
+    /* Call @_fn with the index of each node within the bounds */
+    template<typename F>
+    void range(double _minX, double _minY, double _maxX, double _maxY, F _fn) const {
+        if (nodes.empty()) { return; }
+
+        struct Range { size_t left, right; int axis; };
+        std::vector<Range> stack = {{ 0, nodes.size() - 1, 0 }};
+
+        auto contains = [&](const Node& n) {
+            return n.x >= _minX && n.x <= _maxX && n.y >= _minY && n.y <= _maxY;
+        };
+
+        while (!stack.empty()) {
+            Range r = stack.back();
+            stack.pop_back();
+
+            if (r.right - r.left <= node_size) {
+                for (size_t i = r.left; i <= r.right; i++) {
+                    if (contains(nodes[i])) { _fn(i); }
+                }
+                continue;
+            }
+
+            size_t m = (r.left + r.right) / 2;
+            const Node& n = nodes[m];
+            if (contains(n)) { _fn(m); }
+
+            double value = r.axis == 0 ? n.x : n.y;
+            double min = r.axis == 0 ? _minX : _minY;
+            double max = r.axis == 0 ? _maxX : _maxY;
+
+            if (min <= value) { stack.push_back({ r.left, m - 1, 1 - r.axis }); }
+            if (max >= value) { stack.push_back({ m + 1, r.right, 1 - r.axis }); }
+        }
+    }
+
+    template<typename F>
+    void within(double _x, double _y, double _radius, F _fn) const {
+        double r2 = _radius * _radius;
+
+        range(_x - _radius, _y - _radius, _x + _radius, _y + _radius, [&](size_t i) {
+            double dx = nodes[i].x - _x;
+            double dy = nodes[i].y - _y;
+            if (dx * dx + dy * dy <= r2) { _fn(i); }
+        });
+    }
+};
+
+static void aggregate(ClusterIndex::Aggregation _aggregation, double& _value, double _other) {
+    // NaN marks a missing value
+    if (std::isnan(_other)) { return; }
+    if (std::isnan(_value)) {
+        _value = _other;
+        return;
+    }
+    switch (_aggregation) {
+        case ClusterIndex::Aggregation::sum: _value += _other; break;
+        case ClusterIndex::Aggregation::min: _value = std::min(_value, _other); break;
+        case ClusterIndex::Aggregation::max: _value = std::max(_value, _other); break;
+    }
+}
+
+ClusterIndex::ClusterIndex(std::shared_ptr<const Points> _points, Options _options)
+    : m_points(std::move(_points)), m_options(std::move(_options)) {
+
+    m_options.maxZoom = std::max(m_options.minZoom, m_options.maxZoom);
+
+    size_t numAggregates = m_options.aggregates.size();
+    size_t numPoints = m_points->size();
+
+    m_levels.resize(m_options.maxZoom - m_options.minZoom + 2);
+    for (auto& level : m_levels) { level = std::make_unique<Level>(); }
+
+    auto& points = *m_levels.back();
+    points.nodes.reserve(numPoints);
+    m_values.reserve(numPoints * numAggregates);
+
+    for (size_t i = 0; i < numPoints; i++) {
+        auto& point = (*m_points)[i];
+
+        // Longitudes beyond +-180 wrap around, 180 itself is kept at the
+        // east edge of the world
+        double lon = point.position.longitude;
+        if (lon < -180.0 || lon > 180.0) {
+            lon -= 360.0 * std::floor((lon + 180.0) / 360.0);
+        }
+        double lat = glm::clamp(point.position.latitude, -85.0511, 85.0511) * M_PI / 180.0;
+        double x = lon / 360.0 + 0.5;
+        double y = glm::clamp(0.5 - std::log(std::tan(M_PI / 4.0 + lat / 2.0)) / (2.0 * M_PI), 0.0, 1.0);
+
+        points.nodes.push_back({ x, y, 1, uint32_t(i) });
+
+        for (auto& aggregate : m_options.aggregates) {
+            double value;
+            if (!point.props.getNumber(aggregate.property, value)) {
+                value = std::numeric_limits<double>::quiet_NaN();
+            }
+            m_values.push_back(value);
+        }
+    }
+    points.buildIndex();
+
+    for (int32_t z = m_options.maxZoom; z >= m_options.minZoom; z--) {
+        auto& level = *m_levels[z - m_options.minZoom + 1];
+        auto& next = *m_levels[z - m_options.minZoom];
+
+        cluster(level, next, z);
+        next.buildIndex();
+    }
+}
+
+ClusterIndex::~ClusterIndex() {}
+
+double* ClusterIndex::values(const Node& _node) {
+    return &m_values[_node.props * m_options.aggregates.size()];
+}
+
+void ClusterIndex::cluster(const Level& _level, Level& _next, int32_t _zoom) {
+
+    double radius = m_options.radius / (tile_size * std::pow(2.0, _zoom));
+    size_t numAggregates = m_options.aggregates.size();
+    uint32_t numPoints = m_points->size();
+
+    std::vector<bool> clustered(_level.nodes.size(), false);
+    std::vector<size_t> neighbors;
+    std::vector<double> clusterValues(numAggregates);
+
+    for (size_t i = 0; i < _level.nodes.size(); i++) {
+        if (clustered[i]) { continue; }
+        clustered[i] = true;
+
+        const Node& node = _level.nodes[i];
+
+        neighbors.clear();
+        _level.within(node.x, node.y, radius, [&](size_t j) {
+            if (!clustered[j]) { neighbors.push_back(j); }
+        });
+
+        if (neighbors.empty()) {
+            _next.nodes.push_back(node);
+            continue;
+        }
+
+        double wx = node.x * node.count;
+        double wy = node.y * node.count;
+        uint32_t count = node.count;
+
+        if (numAggregates > 0) {
+            double* nodeValues = values(node);
+            std::copy(nodeValues, nodeValues + numAggregates, clusterValues.begin());
+        }
+
+        for (size_t j : neighbors) {
+            clustered[j] = true;
+
+            const Node& neighbor = _level.nodes[j];
+            wx += neighbor.x * neighbor.count;
+            wy += neighbor.y * neighbor.count;
+            count += neighbor.count;
+
+            if (numAggregates > 0) {
+                double* neighborValues = values(neighbor);
+                for (size_t k = 0; k < numAggregates; k++) {
+                    aggregate(m_options.aggregates[k].aggregation, clusterValues[k], neighborValues[k]);
+                }
+            }
+        }
+
+        Properties props;
+        props.set("cluster", 1.0);
+        props.set("point_count", double(count));
+
+        for (size_t k = 0; k < numAggregates; k++) {
+            if (!std::isnan(clusterValues[k])) {
+                props.set(m_options.aggregates[k].output, clusterValues[k]);
+            }
+        }
+        m_values.insert(m_values.end(), clusterValues.begin(), clusterValues.end());
+
+        _next.nodes.push_back({ wx / count, wy / count, count,
+                                uint32_t(numPoints + m_clusterProps.size()) });
+
+        m_clusterProps.push_back(std::move(props));
+    }
+}
+
+const ClusterIndex::Level& ClusterIndex::level(int32_t _zoom) const {
+    int32_t z = glm::clamp(_zoom, m_options.minZoom, m_options.maxZoom + 1);
+    return *m_levels[z - m_options.minZoom];
+}
+
+size_t ClusterIndex::size(int32_t _zoom) const {
+    return level(_zoom).nodes.size();
+}
+
+void ClusterIndex::getTile(const TileID& _tileID, int32_t _sourceId, Layer& _layer) const {
+
+    double scale = std::pow(2.0, _tileID.z);
+
+    double minX = _tileID.x / scale;
+    double minY = _tileID.y / scale;
+    double maxX = (_tileID.x + 1) / scale;
+    double maxY = (_tileID.y + 1) / scale;
+
+    uint32_t numPoints = m_points->size();
+    auto& nodes = level(_tileID.z).nodes;
+
+    level(_tileID.z).range(minX, minY, maxX, maxY, [&](size_t i) {
+        const Node& node = nodes[i];
+
+        // Nodes on the east and south edge belong to the next tile, except
+        // at the edge of the world
+        if ((node.x == maxX && maxX < 1.0) || (node.y == maxY && maxY < 1.0)) { return; }
+
+        Feature feature(_sourceId);
+        feature.geometryType = GeometryType::points;
+        feature.points.push_back({ node.x * scale - _tileID.x, 1.0 - (node.y * scale - _tileID.y), 0 });
+
+        if (node.props < numPoints) {
+            feature.props = (*m_points)[node.props].props;
+        } else {
+            feature.props = m_clusterProps[node.props - numPoints];
+        }
+        feature.props.sourceId = _sourceId;
+
+        _layer.features.push_back(std::move(feature));
+    });
+}
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "data/properties.h"
+#include "util/types.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+struct Layer;
+struct TileID;
+
+/* Hierarchical clustering of points, as done by supercluster
+ *
+ * For each zoom level from maxZoom down to minZoom the points or clusters of
+ * the level above are merged greedily with their neighbors within the
+ * cluster radius. Every level is indexed by a static k-d tree, so that the
+ * clusters of a tile are found in O(log n + k) for the k clusters in it.
+ *
+ * The index is immutable once built and can be queried from any thread.
+ */
+class ClusterIndex {
+
+public:
+
+    struct PointFeature {
+        LngLat position;
+        Properties props;
+    };
+
+    using Points = std::vector<PointFeature>;
+
+    enum class Aggregation { sum, min, max };
+
+    /* Numeric property of the points, aggregated into the property @output
+     * of clusters. Points without the property are skipped. */
+    struct Aggregate {
+        std::string property;
+        Aggregation aggregation;
+        std::string output;
+    };
+
+    struct Options {
+        // Clusters are built for zooms from minZoom to maxZoom, at higher
+        // zooms the points are not clustered
+        int32_t minZoom = 0;
+        int32_t maxZoom = 16;
+        // Cluster radius in pixels of a 256 pixel tile
+        float radius = 40;
+        std::vector<Aggregate> aggregates;
+    };
+
+    ClusterIndex(std::shared_ptr<const Points> _points, Options _options);
+    ~ClusterIndex();
+
+    /* Add the clusters and points within @_tileID to @_layer. Clusters get
+     * the properties 'cluster' (1), 'point_count' and the aggregates, points
+     * keep their own properties. */
+    void getTile(const TileID& _tileID, int32_t _sourceId, Layer& _layer) const;
+
+    // Number of clusters and unclustered points at @_zoom
+    size_t size(int32_t _zoom) const;
+
+private:
+
+    struct Node {
+        // Normalized Mercator coordinates
+        double x, y;
+        uint32_t count;
+        // Index of the point, or number of points plus index of the cluster
+        uint32_t props;
+    };
+
+    struct Level;
+
+    const Level& level(int32_t _zoom) const;
+
+    void cluster(const Level& _level, Level& _next, int32_t _zoom);
+
+    // Aggregated values of the point or cluster of @_node
+    double* values(const Node& _node);
+
+    std::shared_ptr<const Points> m_points;
+    Options m_options;
+
+    // By zoom from minZoom to maxZoom + 1, the last holds the points
+    std::vector<std::unique_ptr<Level>> m_levels;
+
+    std::vector<Properties> m_clusterProps;
+
+    // Aggregated values of points and clusters, by props index
+    std::vector<double> m_values;
+};
+
+}
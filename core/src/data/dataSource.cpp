@@ -1,4 +1,6 @@
 #include "dataSource.h"
+#include "diskTileCache.h"
+#include "rawCache.h"
 #include "util/geoJson.h"
 #include "platform.h"
 #include "tileData.h"
@@ -9,85 +11,13 @@
 #include "tile/tileTask.h"
 #include "gl/texture.h"
 
+#include <algorithm>
 #include <atomic>
 #include <mutex>
-#include <list>
 #include <functional>
-#include <unordered_map>
 
 namespace Tangram {
 
-struct RawCache {
-
-    // Used to ensure safe access from async loading threads
-    std::mutex m_mutex;
-
-    // LRU in-memory cache for raw tile data
-    using CacheEntry = std::pair<TileID, std::shared_ptr<std::vector<char>>>;
-    using CacheList = std::list<CacheEntry>;
-    using CacheMap = std::unordered_map<TileID, typename CacheList::iterator>;
-
-    CacheMap m_cacheMap;
-    CacheList m_cacheList;
-    int m_usage = 0;
-    int m_maxUsage = 0;
-
-    bool get(DownloadTileTask& _task) {
-
-        if (m_maxUsage <= 0) { return false; }
-
-        std::lock_guard<std::mutex> lock(m_mutex);
-        TileID id(_task.tileId().x, _task.tileId().y, _task.tileId().z);
-
-        auto it = m_cacheMap.find(id);
-        if (it != m_cacheMap.end()) {
-            // Move cached entry to start of list
-            m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
-            _task.rawTileData = m_cacheList.front().second;
-
-            return true;
-        }
-
-        return false;
-    }
-    void put(const TileID& tileID, std::shared_ptr<std::vector<char>> rawDataRef) {
-
-        if (m_maxUsage <= 0) { return; }
-
-        std::lock_guard<std::mutex> lock(m_mutex);
-        TileID id(tileID.x, tileID.y, tileID.z);
-
-        m_cacheList.push_front({id, rawDataRef});
-        m_cacheMap[id] = m_cacheList.begin();
-
-        m_usage += rawDataRef->size();
-
-        while (m_usage > m_maxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Error: invalid cache state!");
-                m_usage = 0;
-                break;
-            }
-
-            // LOGE("Limit raw cache tiles:%d, %fMB ", m_cacheList.size(),
-            //        double(m_cacheUsage) / (1024*1024));
-
-            auto& entry = m_cacheList.back();
-            m_usage -= entry.second->size();
-
-            m_cacheMap.erase(entry.first);
-            m_cacheList.pop_back();
-        }
-    }
-
-    void clear() {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_usage = 0;
-    }
-};
-
 DataSource::DataSource(const std::string& _name, const std::string& _urlTemplate, int32_t _maxZoom) :
     m_name(_name), m_maxZoom(_maxZoom), m_urlTemplate(_urlTemplate),
     m_cache(std::make_unique<RawCache>()){
@@ -110,20 +40,114 @@ std::shared_ptr<TileTask> DataSource::createTask(TileID _tileId, int _subTask) {
 }
 
 void DataSource::setCacheSize(size_t _cacheSize) {
-    m_cache->m_maxUsage = _cacheSize;
+    m_cache->setMaxUsage(_cacheSize);
+}
+
+void DataSource::setCacheAdmission(bool _frequencyBased) {
+    m_cache->setFrequencyAdmission(_frequencyBased);
 }
 
 bool DataSource::cacheGet(DownloadTileTask& _task) {
-    return m_cache->get(_task);
+    return m_cache->get(_task.tileId(), _task.rawTileData);
 }
 
 void DataSource::cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef) {
     m_cache->put(_tileID, _rawDataRef);
+
+    if (auto diskCache = std::atomic_load(&m_diskCache)) {
+        // Skipped when the data came from the disk cache in the first place
+        diskCache->put(diskCacheKey(_tileID), _rawDataRef);
+    }
+}
+
+std::string DataSource::diskCacheKey(const TileID& _tileID) const {
+    return m_urlTemplate + '#' + std::to_string(_tileID.z) + '/' +
+        std::to_string(_tileID.x) + '/' + std::to_string(_tileID.y);
+}
+
+bool DataSource::loadFromDiskCache(std::shared_ptr<TileTask>& _task, TileTaskCb _cb) {
+
+    auto diskCache = std::atomic_load(&m_diskCache);
+    if (!diskCache) { return false; }
+
+    auto key = diskCacheKey(_task->tileId());
+    if (!diskCache->contains(key)) { return false; }
+
+    diskCache->load(key, [this, _cb, task = std::move(_task)](std::vector<char>&& rawData) mutable {
+            if (task->isCanceled()) { return; }
+
+            if (rawData.empty()) {
+                // The entry turned out to be invalid and is removed now,
+                // or the cache was replaced, so that this will request it
+                // from the current cache or the network.
+                this->loadTileData(std::move(task), _cb);
+            } else {
+                this->onTileLoaded(std::move(rawData), std::move(task), _cb);
+            }
+        });
+
+    return true;
 }
 
 void DataSource::clearData() {
     m_cache->clear();
-    m_generation++;
+    invalidateAll();
+}
+
+// Merge the older half of the dirty regions when there are more
+static const size_t max_dirty_regions = 256;
+
+void DataSource::invalidateRegion(const BoundingBox& _bounds) {
+    std::lock_guard<std::mutex> lock(m_dirtyMutex);
+
+    m_dirtyRegions.push_back({ ++m_generation, _bounds });
+
+    if (m_dirtyRegions.size() > max_dirty_regions) {
+        // The merged region is newer and larger than each of its parts,
+        // so that it invalidates at least the same tiles.
+        auto end = m_dirtyRegions.begin() + max_dirty_regions / 2;
+        DirtyRegion merged = m_dirtyRegions.front();
+
+        for (auto it = m_dirtyRegions.begin() + 1; it != end; ++it) {
+            merged.generation = it->generation;
+            merged.bounds.min = glm::min(merged.bounds.min, it->bounds.min);
+            merged.bounds.max = glm::max(merged.bounds.max, it->bounds.max);
+        }
+        *(end - 1) = merged;
+        m_dirtyRegions.erase(m_dirtyRegions.begin(), end - 1);
+    }
+}
+
+void DataSource::invalidateAll() {
+    std::lock_guard<std::mutex> lock(m_dirtyMutex);
+
+    m_clearGeneration = ++m_generation;
+    m_dirtyRegions.clear();
+}
+
+bool DataSource::isTileStale(const TileID& _tileID, int64_t _generation) const {
+
+    if (_generation >= m_generation) { return false; }
+
+    std::lock_guard<std::mutex> lock(m_dirtyMutex);
+
+    if (_generation < m_clearGeneration) { return true; }
+
+    double size = 1.0 / (1 << _tileID.z);
+    double buffer = size * m_tileBuffer;
+
+    glm::dvec2 min = glm::dvec2(_tileID.x, _tileID.y) * size - glm::dvec2(buffer);
+    glm::dvec2 max = glm::dvec2(_tileID.x + 1, _tileID.y + 1) * size + glm::dvec2(buffer);
+
+    for (auto it = m_dirtyRegions.rbegin(); it != m_dirtyRegions.rend(); ++it) {
+        if (it->generation <= _generation) { break; }
+
+        if (it->bounds.min.x <= max.x && it->bounds.max.x >= min.x &&
+            it->bounds.min.y <= max.y && it->bounds.max.y >= min.y) {
+            return true;
+        }
+    }
+    return false;
 }
 
 void DataSource::constructURL(const TileID& _tileCoord, std::string& _url) const {
@@ -163,6 +187,8 @@ void DataSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<Tile
 
 bool DataSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
 
+    if (loadFromDiskCache(_task, _cb)) { return true; }
+
     std::string url(constructURL(_task->tileId()));
 
     // lambda captured parameters are const by default, we want "task" (moved) to be non-const,
@@ -4,19 +4,24 @@
 #include <string>
 #include <memory>
 #include <vector>
+#include <atomic>
+#include <mutex>
 
 #include "tile/tileTask.h"
+#include "util/geom.h"
 
 namespace Tangram {
 
 class MapProjection;
 struct TileData;
+struct TileDataFilter;
 struct TileID;
 struct Raster;
 class Tile;
 class TileManager;
-struct RawCache;
+class RawCache;
 class Texture;
+class DiskTileCache;
 
 class DataSource : public std::enable_shared_from_this<DataSource> {
 
@@ -46,6 +51,13 @@ public:
     /* Parse a <TileTask> with data into a <TileData>, returning an empty TileData on failure */
     virtual std::shared_ptr<TileData> parse(const TileTask& _task, const MapProjection& _projection) const = 0;
 
+    /* Parse only the collections and features of a <TileTask> that pass @_filter.
+     * Sources that cannot decode selectively return the complete <TileData>. */
+    virtual std::shared_ptr<TileData> parseFiltered(const TileTask& _task, const MapProjection& _projection,
+                                                    TileDataFilter& _filter) const {
+        return parse(_task, _projection);
+    }
+
     /* Clears all data associated with this DataSource */
     virtual void clearData();
 
@@ -66,12 +78,28 @@ public:
      */
     void setCacheSize(size_t _cacheSize);
 
+    /* @_frequencyBased: Only admit tile data into the in-memory cache when the
+     * tile was requested more often than the one it would evict (TinyLFU).
+     */
+    void setCacheAdmission(bool _frequencyBased);
+
+    /* @_cache: Set persistent cache for tile data below the in-memory cache.
+     * Entries are keyed by URL template and TileID, so that one cache can be
+     * shared by all DataSources.
+     */
+    void setDiskCache(std::shared_ptr<DiskTileCache> _cache) { std::atomic_store(&m_diskCache, _cache); }
+
     /* ID of this DataSource instance */
     int32_t id() const { return m_id; }
 
     /* Generation ID of DataSource state (incremented for each update, e.g. on clearData()) */
     int64_t generation() const { return m_generation; }
 
+    /* Whether the data of @_tileID changed after @_generation, i.e. a tile
+     * built at @_generation must be loaded again. Only regions that changed
+     * since then are tested, tiles elsewhere stay valid. */
+    bool isTileStale(const TileID& _tileID, int64_t _generation) const;
+
     int32_t maxZoom() const { return m_maxZoom; }
 
     /* assign/get raster datasources to this datasource */
@@ -102,6 +130,21 @@ protected:
 
     void cachePut(const TileID& _tileID, std::shared_ptr<std::vector<char>> _rawDataRef);
 
+    /* Load the data for @_task from m_diskCache on its I/O thread. Returns false
+     * when the tile is not cached, otherwise the task is moved and passed to
+     * onTileLoaded() when done. */
+    bool loadFromDiskCache(std::shared_ptr<TileTask>& _task, TileTaskCb _cb);
+
+    std::string diskCacheKey(const TileID& _tileID) const;
+
+    /* Start a new generation in which the data within @_bounds changed.
+     * Bounds are normalized Mercator coordinates, from 0 to 1 west to east
+     * and north to south, like the tile grid. */
+    void invalidateRegion(const BoundingBox& _bounds);
+
+    // Start a new generation in which all data changed
+    void invalidateAll();
+
     // This datasource is used to generate actual tile geometry
     bool m_generateGeometry = false;
 
@@ -115,13 +158,32 @@ protected:
     int32_t m_id;
 
     // Generation of dynamic DataSource state (incremented for each update)
-    int64_t m_generation = 1;
+    std::atomic<int64_t> m_generation{1};
+
+    struct DirtyRegion {
+        int64_t generation;
+        BoundingBox bounds;
+    };
+
+    // Regions changed since m_clearGeneration, ordered by generation
+    std::vector<DirtyRegion> m_dirtyRegions;
+
+    // Generation of the last invalidateAll()
+    int64_t m_clearGeneration = 1;
+
+    mutable std::mutex m_dirtyMutex;
+
+    // Margin around tiles, relative to the tile size, from which features
+    // are included into the tile data
+    double m_tileBuffer = 0;
 
     // URL template for requesting tiles from a network or filesystem
     std::string m_urlTemplate;
 
     std::unique_ptr<RawCache> m_cache;
 
+    std::shared_ptr<DiskTileCache> m_diskCache;
+
     /* vector of raster sources (as raster samplers) referenced by this datasource */
     std::vector<std::shared_ptr<DataSource>> m_rasterSources;
 };
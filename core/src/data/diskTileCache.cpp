@@ -0,0 +1,417 @@
+#include "diskTileCache.h"
+
+#include "platform.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <ctime>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Tangram {
+
+namespace {
+
+const char CACHE_MAGIC[4] = { 'T', 'G', 'C', '1' };
+
+struct FileHeader {
+    char magic[4];
+    uint32_t keyLength;
+    uint64_t dataSize;
+};
+
+// FNV-1a
+uint64_t hashKey(const std::string& _key) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : _key) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool writeAll(int _fd, const char* _data, size_t _size) {
+    while (_size > 0) {
+        ssize_t n = ::write(_fd, _data, _size);
+        if (n < 0) {
+            if (errno == EINTR) { continue; }
+            return false;
+        }
+        _data += n;
+        _size -= n;
+    }
+    return true;
+}
+
+bool endsWith(const std::string& _str, const std::string& _suffix) {
+    return _str.size() >= _suffix.size() &&
+        _str.compare(_str.size() - _suffix.size(), _suffix.size(), _suffix) == 0;
+}
+
+}
+
+DiskTileCache::DiskTileCache(const std::string& _path, uint64_t _maxSize, uint32_t _maxAge) :
+    m_path(_path),
+    m_maxSize(_maxSize),
+    m_maxAge(_maxAge) {
+
+    while (m_path.size() > 1 && m_path.back() == '/') { m_path.pop_back(); }
+
+    if (mkdir(m_path.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOGE("Cannot create tile cache directory '%s'", m_path.c_str());
+    }
+
+    m_jobs = std::make_shared<JobQueue>();
+    m_thread = std::thread(&DiskTileCache::runJobs, m_jobs);
+
+    // Rebuild the index on the I/O thread: Walking a large cache tree would
+    // block the caller. Entries are missed until the scan is done, jobs
+    // queued later run after it.
+    int64_t started = time(nullptr);
+    addJob({ [this, started]() { scanDirectory(started); }, nullptr });
+}
+
+DiskTileCache::~DiskTileCache() {
+    std::deque<Job> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_jobs->mutex);
+        m_jobs->running = false;
+        std::swap(pending, m_jobs->jobs);
+    }
+    m_jobs->condition.notify_all();
+
+    if (m_thread.get_id() == std::this_thread::get_id()) {
+        // Released from within a job: The thread exits after this job
+        m_thread.detach();
+    } else {
+        m_thread.join();
+    }
+
+    // Let the owners of pending loads fall back to other sources, so that
+    // their tile tasks still complete
+    for (auto& job : pending) {
+        if (job.cancel) { job.cancel(); }
+    }
+}
+
+std::string DiskTileCache::filePath(uint64_t _hash) const {
+    char name[17];
+    snprintf(name, sizeof(name), "%016" PRIx64, _hash);
+
+    std::string path(m_path);
+    path += '/';
+    path.append(name, 2);
+    path += '/';
+    path.append(name + 2);
+    path += ".tile";
+    return path;
+}
+
+void DiskTileCache::scanDirectory(int64_t _started) {
+
+    uint64_t clears;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        clears = m_clears;
+    }
+
+    std::vector<Entry> entries;
+
+    DIR* root = opendir(m_path.c_str());
+    if (!root) { return; }
+
+    while (struct dirent* dir = readdir(root)) {
+        std::string dirName(dir->d_name);
+        if (dirName.size() != 2 || !isxdigit(dirName[0]) || !isxdigit(dirName[1])) {
+            continue;
+        }
+
+        std::string dirPath = m_path + '/' + dirName;
+        DIR* sub = opendir(dirPath.c_str());
+        if (!sub) { continue; }
+
+        while (struct dirent* file = readdir(sub)) {
+            std::string fileName(file->d_name);
+            std::string filePath = dirPath + '/' + fileName;
+
+            bool tmp = endsWith(fileName, ".tmp");
+            if (!tmp && (fileName.size() != 14 + 5 || !endsWith(fileName, ".tile"))) {
+                continue;
+            }
+
+            struct stat st;
+            if (stat(filePath.c_str(), &st) != 0) { continue; }
+
+            if (tmp) {
+                // Leftover of an interrupted write, unless write() was
+                // called while scanning
+                if (int64_t(st.st_mtime) < _started) { unlink(filePath.c_str()); }
+                continue;
+            }
+
+            std::string hex = dirName + fileName.substr(0, 14);
+            uint64_t hash = strtoull(hex.c_str(), nullptr, 16);
+
+            entries.push_back({ hash, uint64_t(st.st_size), int64_t(st.st_mtime) });
+        }
+        closedir(sub);
+    }
+    closedir(root);
+
+    // Most recently written entries first
+    std::sort(entries.begin(), entries.end(),
+              [](auto& a, auto& b) { return a.mtime > b.mtime; });
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    for (auto& entry : entries) {
+        if (m_clears != clears) {
+            // clear() was called while scanning
+            unlink(filePath(entry.hash).c_str());
+            continue;
+        }
+        // Entries written while scanning are newer
+        if (m_index.count(entry.hash)) { continue; }
+
+        m_entries.push_back(entry);
+        m_index[entry.hash] = std::prev(m_entries.end());
+        m_usage += entry.size;
+    }
+
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        auto entry = it++;
+        if (expired(*entry)) { remove(entry); }
+    }
+
+    limitUsage();
+}
+
+bool DiskTileCache::expired(const Entry& _entry) const {
+    return m_maxAge > 0 && (int64_t(time(nullptr)) - _entry.mtime) > int64_t(m_maxAge);
+}
+
+void DiskTileCache::remove(EntryList::iterator _entry) {
+    unlink(filePath(_entry->hash).c_str());
+
+    m_usage -= _entry->size;
+    m_index.erase(_entry->hash);
+    m_entries.erase(_entry);
+}
+
+void DiskTileCache::limitUsage() {
+    while (m_usage > m_maxSize && !m_entries.empty()) {
+        remove(std::prev(m_entries.end()));
+    }
+}
+
+bool DiskTileCache::contains(const std::string& _key) {
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_index.find(hashKey(_key));
+    if (it == m_index.end()) { return false; }
+
+    if (expired(*it->second)) {
+        remove(it->second);
+        return false;
+    }
+    return true;
+}
+
+bool DiskTileCache::read(const std::string& _key, std::vector<char>& _data) {
+
+    uint64_t hash = hashKey(_key);
+    uint64_t serial;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_index.find(hash);
+        if (it == m_index.end()) { return false; }
+
+        if (expired(*it->second)) {
+            remove(it->second);
+            return false;
+        }
+        // Move entry to start of list
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        serial = it->second->serial;
+    }
+
+    bool valid = false;
+
+    int fd = open(filePath(hash).c_str(), O_RDONLY);
+    if (fd >= 0) {
+        struct stat st;
+        if (fstat(fd, &st) == 0 && size_t(st.st_size) >= sizeof(FileHeader)) {
+            size_t size = st.st_size;
+            void* map = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (map != MAP_FAILED) {
+                const char* bytes = static_cast<const char*>(map);
+                FileHeader header;
+                std::memcpy(&header, bytes, sizeof(header));
+
+                size_t dataOffset = sizeof(header) + header.keyLength;
+
+                valid = std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 &&
+                    header.keyLength == _key.size() &&
+                    dataOffset + header.dataSize == size &&
+                    _key.compare(0, _key.size(), bytes + sizeof(header), header.keyLength) == 0;
+
+                if (valid) {
+                    _data.assign(bytes + dataOffset, bytes + size);
+                }
+                munmap(map, size);
+            }
+        }
+        close(fd);
+    }
+
+    if (!valid) {
+        // Truncated, corrupt or colliding entry, unless it was replaced
+        // by a write meanwhile
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(hash);
+        if (it != m_index.end() && it->second->serial == serial) { remove(it->second); }
+    }
+    return valid;
+}
+
+bool DiskTileCache::write(const std::string& _key, const std::vector<char>& _data) {
+
+    uint64_t hash = hashKey(_key);
+    std::string path = filePath(hash);
+    std::string dir = path.substr(0, path.rfind('/'));
+
+    if (mkdir(dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        LOGE("Cannot create tile cache directory '%s'", dir.c_str());
+        return false;
+    }
+
+    FileHeader header;
+    std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.keyLength = _key.size();
+    header.dataSize = _data.size();
+
+    // Write to a temporary file first and rename it when complete
+    std::string tmpPath = path + ".tmp";
+
+    int fd = open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) { return false; }
+
+    bool ok = writeAll(fd, reinterpret_cast<const char*>(&header), sizeof(header)) &&
+        writeAll(fd, _key.data(), _key.size()) &&
+        writeAll(fd, _data.data(), _data.size());
+
+    // Flush the data before the rename makes it visible, otherwise a crash
+    // could leave a renamed but empty or partial entry
+    ok = ok && fsync(fd) == 0;
+    ok = (close(fd) == 0) && ok;
+
+    // Rename and index the entry at once, so that a concurrent remove()
+    // does not unlink the new file or leave a stale entry
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (!ok || rename(tmpPath.c_str(), path.c_str()) != 0) {
+        LOGE("Cannot write tile cache entry '%s'", path.c_str());
+        unlink(tmpPath.c_str());
+        return false;
+    }
+
+    uint64_t size = sizeof(header) + _key.size() + _data.size();
+
+    auto it = m_index.find(hash);
+    if (it != m_index.end()) {
+        // Replaced an existing (expired) entry
+        m_usage -= it->second->size;
+        m_entries.erase(it->second);
+    }
+
+    m_entries.push_front({ hash, size, int64_t(time(nullptr)), ++m_serial });
+    m_index[hash] = m_entries.begin();
+    m_usage += size;
+
+    limitUsage();
+
+    return true;
+}
+
+void DiskTileCache::load(const std::string& _key, Callback _cb) {
+    addJob({ [this, _key, _cb]() {
+                 std::vector<char> data;
+                 read(_key, data);
+                 _cb(std::move(data));
+             },
+             [_cb]() { _cb({}); } });
+}
+
+void DiskTileCache::put(const std::string& _key, std::shared_ptr<std::vector<char>> _data) {
+    if (!_data || _data->empty() || contains(_key)) { return; }
+
+    // Dropped when the cache is destroyed before
+    addJob({ [this, _key, _data]() { write(_key, *_data); }, nullptr });
+}
+
+void DiskTileCache::clear() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_clears++;
+
+    while (!m_entries.empty()) {
+        remove(m_entries.begin());
+    }
+}
+
+uint64_t DiskTileCache::usage() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_usage;
+}
+
+size_t DiskTileCache::entries() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+void DiskTileCache::addJob(Job _job) {
+    {
+        std::lock_guard<std::mutex> lock(m_jobs->mutex);
+        m_jobs->jobs.push_back(std::move(_job));
+    }
+    m_jobs->condition.notify_all();
+}
+
+void DiskTileCache::flush() {
+    std::unique_lock<std::mutex> lock(m_jobs->mutex);
+    m_jobs->condition.wait(lock, [this]{
+            return !m_jobs->running || (m_jobs->jobs.empty() && !m_jobs->busy);
+        });
+}
+
+void DiskTileCache::runJobs(std::shared_ptr<JobQueue> _queue) {
+
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_queue->mutex);
+            _queue->busy = false;
+            _queue->condition.notify_all();
+
+            _queue->condition.wait(lock, [&]{ return !_queue->running || !_queue->jobs.empty(); });
+
+            if (!_queue->running) { break; }
+
+            job = std::move(_queue->jobs.front().run);
+            _queue->jobs.pop_front();
+            _queue->busy = true;
+        }
+        job();
+    }
+}
+
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* Persistent cache for raw tile data
+ *
+ * Entries are stored as one file per key in a directory tree below @_path,
+ * named after a 64bit hash of the key (e.g. the URL template of a DataSource
+ * and a TileID). Each file starts with a header holding the full key, so that
+ * hash collisions are detected on read.
+ *
+ * Files are written to a temporary file and synced before they are renamed,
+ * so that a crash never leaves a partially written entry behind. Reads are done via
+ * mmap. Both happen on a dedicated I/O thread when using load() and put().
+ *
+ * The total size of all entries is limited to @_maxSize bytes, least recently
+ * used entries are removed first. Entries older than @_maxAge seconds are
+ * treated as missing (0 disables expiry). The index is rebuilt from the
+ * directory by the first job of the I/O thread, ordered by file modification
+ * time; until then existing entries are reported as missing (see flush()).
+ */
+class DiskTileCache {
+
+public:
+
+    using Callback = std::function<void(std::vector<char>&&)>;
+
+    DiskTileCache(const std::string& _path, uint64_t _maxSize, uint32_t _maxAge = 0);
+
+    ~DiskTileCache();
+
+    /* Returns true when a non-expired entry for @_key exists */
+    bool contains(const std::string& _key);
+
+    /* Read the entry for @_key on the I/O thread and pass it to @_cb. The
+     * data passed to @_cb is empty when the entry could not be read, or when
+     * the cache was destroyed before the job ran. */
+    void load(const std::string& _key, Callback _cb);
+
+    /* Write an entry for @_key on the I/O thread, unless it already exists */
+    void put(const std::string& _key, std::shared_ptr<std::vector<char>> _data);
+
+    /* Synchronous versions of load() and put() */
+    bool read(const std::string& _key, std::vector<char>& _data);
+    bool write(const std::string& _key, const std::vector<char>& _data);
+
+    /* Remove all entries */
+    void clear();
+
+    /* Block until all pending I/O jobs are finished */
+    void flush();
+
+    /* Total size of all entries in bytes */
+    uint64_t usage() const;
+
+    size_t entries() const;
+
+    const std::string& path() const { return m_path; }
+
+private:
+
+    struct Entry {
+        uint64_t hash;
+        uint64_t size;
+        int64_t mtime;
+        // Distinguishes an entry from the ones replacing it
+        uint64_t serial = 0;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    std::string filePath(uint64_t _hash) const;
+
+    // Index the entries found on disk, removes temporary files
+    // older than @_started
+    void scanDirectory(int64_t _started);
+
+    // Remove entries until m_usage <= m_maxSize, must hold m_mutex
+    void limitUsage();
+
+    // Remove entry from index and disk, must hold m_mutex
+    void remove(EntryList::iterator _entry);
+
+    bool expired(const Entry& _entry) const;
+
+    struct Job {
+        std::function<void()> run;
+        // Called instead of run when the cache is destroyed before
+        std::function<void()> cancel;
+    };
+
+    // I/O thread state, shared with the thread so that the cache can be
+    // released by the I/O thread itself
+    struct JobQueue {
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<Job> jobs;
+        bool running = true;
+        bool busy = false;
+    };
+
+    static void runJobs(std::shared_ptr<JobQueue> _queue);
+
+    void addJob(Job _job);
+
+    std::string m_path;
+    uint64_t m_maxSize;
+    uint32_t m_maxAge;
+
+    // Guards the index and the files: entries are renamed into place,
+    // replaced and unlinked only while holding it
+    mutable std::mutex m_mutex;
+
+    // Most recently used entries first
+    EntryList m_entries;
+    std::unordered_map<uint64_t, EntryList::iterator> m_index;
+    uint64_t m_usage = 0;
+    uint64_t m_serial = 0;
+    // Number of clear() calls, entries found by a concurrent scan are dropped
+    uint64_t m_clears = 0;
+
+    std::shared_ptr<JobQueue> m_jobs;
+    std::thread m_thread;
+};
+
+}
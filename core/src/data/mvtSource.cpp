@@ -15,6 +15,15 @@ MVTSource::MVTSource(const std::string& _name, const std::string& _urlTemplate,
 }
 
 std::shared_ptr<TileData> MVTSource::parse(const TileTask& _task, const MapProjection& _projection) const {
+    return parseTile(_task, nullptr);
+}
+
+std::shared_ptr<TileData> MVTSource::parseFiltered(const TileTask& _task, const MapProjection& _projection,
+                                                   TileDataFilter& _filter) const {
+    return parseTile(_task, &_filter);
+}
+
+std::shared_ptr<TileData> MVTSource::parseTile(const TileTask& _task, TileDataFilter* _filter) const {
 
     auto tileData = std::make_shared<TileData>();
 
@@ -22,6 +31,7 @@ std::shared_ptr<TileData> MVTSource::parse(const TileTask& _task, const MapProje
 
     protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
     PbfParser::ParserContext ctx(m_id);
+    ctx.filter = _filter;
 
     while(item.next()) {
         if(item.tag == 3) {
@@ -33,4 +43,24 @@ std::shared_ptr<TileData> MVTSource::parse(const TileTask& _task, const MapProje
     return tileData;
 }
 
+FlatTileData MVTSource::parseFlat(const TileTask& _task, Arena& _arena) const {
+
+    FlatTileData tileData;
+
+    auto& task = static_cast<const DownloadTileTask&>(_task);
+    tileData.rawTileData = task.rawTileData;
+
+    protobuf::message item(task.rawTileData->data(), task.rawTileData->size());
+    PbfParser::ParserContext ctx(m_id);
+
+    while(item.next()) {
+        if(item.tag == 3) {
+            tileData.layers.push_back(PbfParser::getFlatLayer(ctx, _arena, item.getMessage()));
+        } else {
+            item.skip();
+        }
+    }
+    return tileData;
+}
+
 }
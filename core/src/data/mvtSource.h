@@ -4,6 +4,9 @@
 
 namespace Tangram {
 
+class Arena;
+struct FlatTileData;
+
 class MVTSource : public DataSource {
 
 protected:
@@ -11,10 +14,19 @@ protected:
     virtual std::shared_ptr<TileData> parse(const TileTask& _task,
                                             const MapProjection& _projection) const override;
 
+    virtual std::shared_ptr<TileData> parseFiltered(const TileTask& _task, const MapProjection& _projection,
+                                                    TileDataFilter& _filter) const override;
+
+    std::shared_ptr<TileData> parseTile(const TileTask& _task, TileDataFilter* _filter) const;
+
 public:
 
     MVTSource(const std::string& _name, const std::string& _urlTemplate, int32_t _maxZoom);
 
+    // Decode the tile of @_task into buffers from @_arena, see FlatLayer.
+    // The result retains the raw tile data and is valid until _arena is reset.
+    FlatTileData parseFlat(const TileTask& _task, Arena& _arena) const;
+
 };
 
 }
@@ -1,6 +1,7 @@
 #include "propertyItem.h"
 #include "properties.h"
 #include <algorithm>
+#include <numeric>
 
 namespace Tangram {
 
@@ -10,12 +11,21 @@ Properties::~Properties() {}
 
 Properties& Properties::operator=(Properties&& _other) {
     props = std::move(_other.props);
+    idOrder = std::move(_other.idOrder);
     sourceId = _other.sourceId;
     return *this;
 }
 
 void Properties::setSorted(std::vector<Item>&& _items) {
     props = std::move(_items);
+    updateIdOrder();
+}
+
+void Properties::updateIdOrder() {
+    idOrder.resize(props.size());
+    std::iota(idOrder.begin(), idOrder.end(), 0);
+    std::sort(idOrder.begin(), idOrder.end(),
+              [&](uint32_t a, uint32_t b) { return props[a].keyId < props[b].keyId; });
 }
 
 const Value& Properties::get(const std::string& key) const {
@@ -40,7 +50,32 @@ const Value& Properties::get(const std::string& key) const {
     return it->value;
 }
 
-void Properties::clear() { props.clear(); }
+const Value& Properties::getById(uint32_t keyId) const {
+    const static Value NOT_FOUND(none_type{});
+
+    auto byId = [&](uint32_t index, uint32_t id) { return props[index].keyId < id; };
+
+    auto it = std::lower_bound(idOrder.begin(), idOrder.end(), keyId, byId);
+    if (it != idOrder.end() && props[*it].keyId == keyId) {
+        return props[*it].value;
+    }
+
+    if (!idOrder.empty() && props[idOrder.back()].keyId == PropertyKeys::unknown &&
+        keyId != PropertyKeys::unknown) {
+        // Keys that were seen after the key table was full sort last
+        const auto& key = PropertyKeys::name(keyId);
+        for (it = std::lower_bound(idOrder.begin(), idOrder.end(), PropertyKeys::unknown, byId);
+             it != idOrder.end(); ++it) {
+            if (props[*it].key == key) { return props[*it].value; }
+        }
+    }
+    return NOT_FOUND;
+}
+
+void Properties::clear() {
+    props.clear();
+    idOrder.clear();
+}
 
 bool Properties::contains(const std::string& key) const {
     return !get(key).is<none_type>();
@@ -113,6 +148,7 @@ std::string Properties::getAsString(const std::string& key) const {
 
 void Properties::sort() {
     std::sort(props.begin(), props.end());
+    updateIdOrder();
 }
 
 void Properties::set(std::string key, std::string value) {
@@ -124,6 +160,7 @@ void Properties::set(std::string key, std::string value) {
 
     if (it == props.end() || it->key != key) {
         props.emplace(it, std::move(key), std::move(value));
+        updateIdOrder();
     } else {
         it->value = std::move(value);
     }
@@ -138,6 +175,7 @@ void Properties::set(std::string key, double value) {
 
     if (it == props.end() || it->key != key) {
         props.emplace(it, std::move(key), value);
+        updateIdOrder();
     } else {
         it->value = value;
     }
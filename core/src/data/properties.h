@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -22,6 +23,9 @@ struct Properties {
 
     const Value& get(const std::string& key) const;
 
+    /* Lookup by key ID from PropertyKeys::intern() */
+    const Value& getById(uint32_t keyId) const;
+
     void sort();
 
     void clear();
@@ -66,7 +70,13 @@ struct Properties {
         }
     }
 private:
+    // Rebuild idOrder after props changed
+    void updateIdOrder();
+
     std::vector<Item> props;
+
+    // Indices into props ordered by keyId, for getById()
+    std::vector<uint32_t> idOrder;
 };
 
 }
@@ -1,14 +1,20 @@
 #pragma once
 
+#include "data/propertyKeys.h"
 #include "util/variant.h"
 
 namespace Tangram {
 
 struct PropertyItem {
     PropertyItem(std::string _key, Value _value) :
-        key(std::move(_key)), value(std::move(_value)) {}
+        key(std::move(_key)), keyId(PropertyKeys::lookup(key)), value(std::move(_value)) {}
+
+    // For parsers that intern their keys upfront
+    PropertyItem(std::string _key, uint32_t _keyId, Value _value) :
+        key(std::move(_key)), keyId(_keyId), value(std::move(_value)) {}
 
     std::string key;
+    uint32_t keyId;
     Value value;
     bool operator<(const PropertyItem& _rhs) const {
         return key.size() == _rhs.key.size()
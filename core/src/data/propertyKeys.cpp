@@ -0,0 +1,59 @@
+#include "propertyKeys.h"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace Tangram {
+
+namespace {
+
+std::mutex s_mutex;
+std::unordered_map<std::string, uint32_t> s_keys;
+// Append-only, so that references returned by name() stay valid
+std::deque<std::string> s_names;
+
+// Keys this thread has already looked up. Holds only interned IDs, which
+// never change, so it needs no invalidation and stays below the size of
+// the shared table.
+thread_local std::unordered_map<std::string, uint32_t> t_cache;
+
+uint32_t find(const std::string& _key, bool _insert) {
+
+    auto cached = t_cache.find(_key);
+    if (cached != t_cache.end()) { return cached->second; }
+
+    uint32_t id = PropertyKeys::unknown;
+    {
+        std::lock_guard<std::mutex> lock(s_mutex);
+
+        auto it = s_keys.find(_key);
+        if (it != s_keys.end()) {
+            id = it->second;
+        } else if (_insert || s_keys.size() < PropertyKeys::max_keys) {
+            id = s_keys.size();
+            s_keys.emplace(_key, id);
+            s_names.push_back(_key);
+        }
+    }
+
+    if (id != PropertyKeys::unknown) { t_cache.emplace(_key, id); }
+    return id;
+}
+
+}
+
+uint32_t PropertyKeys::intern(const std::string& _key) {
+    return find(_key, true);
+}
+
+uint32_t PropertyKeys::lookup(const std::string& _key) {
+    return find(_key, false);
+}
+
+const std::string& PropertyKeys::name(uint32_t _id) {
+    std::lock_guard<std::mutex> lock(s_mutex);
+    return s_names[_id];
+}
+
+}
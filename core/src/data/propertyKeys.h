@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Tangram {
+
+/* Process wide table of interned property keys
+ *
+ * Parsers intern the keys of a collection once per tile and filters intern
+ * their keys when the scene is loaded, so that properties can be matched by
+ * integer ID instead of comparing strings. IDs stay valid for the lifetime
+ * of the process.
+ *
+ * Each thread keeps a cache of the IDs it has seen in front of the shared
+ * table, so that only the first lookup of a key takes the table lock.
+ */
+namespace PropertyKeys {
+
+    // ID of feature keys that were not interned, see lookup()
+    constexpr uint32_t unknown = UINT32_MAX;
+
+    // Number of keys after which lookup() stops adding keys to the table
+    constexpr uint32_t max_keys = 1 << 16;
+
+    // Get the ID of a key used by the scene. Always interns the key.
+    uint32_t intern(const std::string& _key);
+
+    // Get the ID of a key from feature data. Keys that are not in the table
+    // yet are only added while it has fewer than max_keys entries, otherwise
+    // they get 'unknown' and are matched by name, see Properties::getById().
+    uint32_t lookup(const std::string& _key);
+
+    // Key of an interned ID
+    const std::string& name(uint32_t _id);
+
+}
+
+}
@@ -153,6 +153,8 @@ void RasterSource::onTileLoaded(std::vector<char>&& _rawData, std::shared_ptr<Ti
 
 bool RasterSource::loadTileData(std::shared_ptr<TileTask>&& _task, TileTaskCb _cb) {
 
+    if (loadFromDiskCache(_task, _cb)) { return true; }
+
     std::string url(constructURL(_task->tileId()));
 
     auto copyTask = _task;
@@ -0,0 +1,197 @@
+#include "rawCache.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+static const uint64_t SKETCH_SEEDS[] = {
+    0x9e3779b97f4a7c15ull, 0xc2b2ae3d27d4eb4full,
+    0x165667b19e3779f9ull, 0xd6e8feb86659fd93ull
+};
+
+void RawCache::FrequencySketch::increment(size_t _hash) {
+    for (size_t i = 0; i < DEPTH; i++) {
+        auto& counter = counters[i * WIDTH + (uint64_t(_hash) * SKETCH_SEEDS[i] >> 32) % WIDTH];
+        if (counter < 15) { counter++; }
+    }
+
+    // Halve all counters periodically, so that the sketch
+    // follows changes in the access pattern.
+    if (++additions >= 10 * WIDTH) {
+        for (auto& counter : counters) { counter >>= 1; }
+        additions /= 2;
+    }
+}
+
+uint8_t RawCache::FrequencySketch::frequency(size_t _hash) const {
+    uint8_t result = 15;
+    for (size_t i = 0; i < DEPTH; i++) {
+        auto counter = counters[i * WIDTH + (uint64_t(_hash) * SKETCH_SEEDS[i] >> 32) % WIDTH];
+        result = std::min(result, counter);
+    }
+    return result;
+}
+
+RawCache::RawCache(size_t _shards) :
+    m_usage(0),
+    m_tick(0),
+    m_maxUsage(0),
+    m_admission(false) {
+
+    _shards = std::max<size_t>(_shards, 1);
+
+    for (size_t i = 0; i < _shards; i++) {
+        m_shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+RawCache::~RawCache() {}
+
+bool RawCache::get(const TileID& _tileID, Data& _data) {
+
+    if (m_maxUsage == 0) { return false; }
+
+    TileID id(_tileID.x, _tileID.y, _tileID.z);
+    size_t hash = std::hash<TileID>()(id);
+    auto& s = shard(hash);
+
+    std::lock_guard<std::mutex> lock(s.mutex);
+
+    if (m_admission) { s.sketch.increment(hash); }
+
+    auto it = s.map.find(id);
+    if (it == s.map.end()) { return false; }
+
+    // Move cached entry to start of list
+    s.list.splice(s.list.begin(), s.list, it->second);
+    s.list.front().tick = m_tick++;
+    updateOldest(s);
+
+    _data = s.list.front().data;
+
+    return true;
+}
+
+void RawCache::put(const TileID& _tileID, Data _data) {
+
+    uint64_t maxUsage = m_maxUsage;
+    if (maxUsage == 0 || !_data) { return; }
+
+    // Would not fit even after evicting everything else
+    uint64_t size = _data->size();
+    if (size > maxUsage) { return; }
+
+    TileID id(_tileID.x, _tileID.y, _tileID.z);
+    size_t hash = std::hash<TileID>()(id);
+    auto& s = shard(hash);
+
+    // Frequency of the entry that would be evicted first, looked up
+    // before taking the own lock so that only one lock is held
+    int victimFrequency = -1;
+    if (m_admission && m_usage + size > maxUsage) {
+        if (auto* victim = oldestShard()) {
+            std::lock_guard<std::mutex> lock(victim->mutex);
+            if (!victim->list.empty()) {
+                auto victimHash = std::hash<TileID>()(victim->list.back().id);
+                victimFrequency = victim->sketch.frequency(victimHash);
+            }
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(s.mutex);
+
+        auto it = s.map.find(id);
+        if (it == s.map.end()) {
+            // Admit only when requested more often than the entry it would evict
+            if (victimFrequency >= 0 && s.sketch.frequency(hash) <= victimFrequency) {
+                return;
+            }
+        } else {
+            // Replace existing entry
+            uint64_t oldSize = it->second->data->size();
+            s.usage -= oldSize;
+            m_usage -= oldSize;
+            s.list.erase(it->second);
+            s.map.erase(it);
+        }
+
+        s.list.push_front({id, std::move(_data), m_tick++});
+        s.map[id] = s.list.begin();
+        s.usage += size;
+        m_usage += size;
+
+        updateOldest(s);
+    }
+
+    // The new entry has the latest tick and goes last
+    evict(maxUsage);
+}
+
+RawCache::Shard* RawCache::oldestShard() {
+    Shard* result = nullptr;
+    uint64_t oldest = UINT64_MAX;
+
+    for (auto& s : m_shards) {
+        uint64_t tick = s->oldest;
+        if (tick < oldest) {
+            oldest = tick;
+            result = s.get();
+        }
+    }
+    return result;
+}
+
+void RawCache::updateOldest(Shard& _shard) {
+    _shard.oldest = _shard.list.empty() ? UINT64_MAX : _shard.list.back().tick;
+}
+
+void RawCache::evictLast(Shard& _shard) {
+    auto& entry = _shard.list.back();
+    uint64_t size = entry.data->size();
+    _shard.usage -= size;
+    m_usage -= size;
+
+    _shard.map.erase(entry.id);
+    _shard.list.pop_back();
+
+    updateOldest(_shard);
+}
+
+void RawCache::evict(uint64_t _maxUsage) {
+
+    while (m_usage > _maxUsage) {
+        auto* s = oldestShard();
+        if (!s) { break; }
+
+        // Another thread may have changed the shard meanwhile,
+        // its tail is still among the oldest entries
+        std::lock_guard<std::mutex> lock(s->mutex);
+        if (!s->list.empty()) {
+            evictLast(*s);
+        }
+    }
+}
+
+void RawCache::clear() {
+    for (auto& s : m_shards) {
+        std::lock_guard<std::mutex> lock(s->mutex);
+        s->map.clear();
+        s->list.clear();
+        m_usage -= s->usage;
+        s->usage = 0;
+        updateOldest(*s);
+    }
+}
+
+void RawCache::setMaxUsage(uint64_t _maxUsage) {
+    m_maxUsage = _maxUsage;
+
+    if (_maxUsage == 0) {
+        clear();
+    } else {
+        evict(_maxUsage);
+    }
+}
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "tile/tileID.h"
+#include "tile/tileHash.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* In-memory LRU cache for raw tile data
+ *
+ * The cache is split into shards by TileID, each with its own lock and LRU
+ * list, so that URL callback threads and the main thread rarely wait for
+ * each other. All shards share one size limit, accounted in bytes. Entries
+ * are stamped with a global access tick and every shard publishes the tick
+ * of its least recently used entry, so that eviction always removes the
+ * oldest tail of all shards, taking one lock at a time. Tiles larger than
+ * the whole limit are not cached.
+ *
+ * With frequency admission enabled (TinyLFU) each shard keeps a small
+ * count-min sketch of how often tiles were requested. A new tile that would
+ * evict others is only admitted when it was requested more often than the
+ * least recently used tile, so that one-off tiles (e.g. when flying over an
+ * area) do not flush tiles that are used over and over.
+ */
+class RawCache {
+
+public:
+
+    using Data = std::shared_ptr<std::vector<char>>;
+
+    const static size_t DEFAULT_SHARDS = 16;
+
+    RawCache(size_t _shards = DEFAULT_SHARDS);
+
+    ~RawCache();
+
+    bool get(const TileID& _tileID, Data& _data);
+
+    void put(const TileID& _tileID, Data _data);
+
+    void clear();
+
+    /* Size limit in bytes, 0 disables the cache */
+    void setMaxUsage(uint64_t _maxUsage);
+    uint64_t maxUsage() const { return m_maxUsage; }
+
+    /* Current size of all entries in bytes */
+    uint64_t usage() const { return m_usage; }
+
+    void setFrequencyAdmission(bool _enable) { m_admission = _enable; }
+
+private:
+
+    // 4-bit count-min sketch with periodic aging
+    struct FrequencySketch {
+        const static size_t WIDTH = 512;
+        const static size_t DEPTH = 4;
+
+        std::array<uint8_t, WIDTH * DEPTH> counters{};
+        size_t additions = 0;
+
+        void increment(size_t _hash);
+        uint8_t frequency(size_t _hash) const;
+    };
+
+    struct CacheEntry {
+        TileID id;
+        Data data;
+        // Value of m_tick at the last access
+        uint64_t tick;
+    };
+    using CacheList = std::list<CacheEntry>;
+
+    struct Shard {
+        std::mutex mutex;
+        std::unordered_map<TileID, CacheList::iterator> map;
+        CacheList list;
+        uint64_t usage = 0;
+        FrequencySketch sketch;
+        // Tick of the least recently used entry, UINT64_MAX when empty.
+        // Written with the lock held, read without.
+        std::atomic<uint64_t> oldest{UINT64_MAX};
+    };
+
+    Shard& shard(size_t _hash) { return *m_shards[(_hash ^ (_hash >> 17)) % m_shards.size()]; }
+
+    // Shard holding the least recently used entry, nullptr when all are empty
+    Shard* oldestShard();
+
+    // Publish the tick of the shard's last entry, must hold its lock
+    void updateOldest(Shard& _shard);
+
+    // Remove the least recently used entry of the shard, must hold its lock
+    void evictLast(Shard& _shard);
+
+    // Evict the least recently used entries until usage is within _maxUsage
+    void evict(uint64_t _maxUsage);
+
+    std::vector<std::unique_ptr<Shard>> m_shards;
+
+    std::atomic<uint64_t> m_usage;
+    std::atomic<uint64_t> m_tick;
+    std::atomic<uint64_t> m_maxUsage;
+    std::atomic<bool> m_admission;
+};
+
+}
@@ -2,7 +2,10 @@
 
 #include "glm/vec3.hpp"
 #include "data/properties.h"
+#include "util/arena.h"
+#include "util/stringView.h"
 
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -98,4 +101,95 @@ struct TileData {
 
 };
 
+/* Flat form of a Layer, decoded without per-feature allocations
+ *
+ * All buffers come from an Arena and are invalid once it is reset. Keys and
+ * string values point into the raw tile data, FlatTileData retains it.
+ *
+ * Features index into the layer buffers in CSR style: the lines of a feature
+ * are [linesBegin, linesEnd) in lineEnds and line i covers coordinates
+ * [lineBegin(i), lineEnds[i]). A points feature has a single line holding
+ * all of its points. Polygons do the same over lineEnds: polygon j of a
+ * feature covers the rings [polygonBegin(feature, j), polygonEnds[j]).
+ */
+struct FlatValue {
+    enum class Type : uint8_t { none, number, string };
+
+    Type type = Type::none;
+    double number = 0;
+    StringView string;
+};
+
+struct FlatFeature {
+    GeometryType geometryType = GeometryType::unknown;
+
+    // Properties of the feature in FlatLayer::properties, sorted by key
+    uint32_t propsBegin = 0, propsEnd = 0;
+
+    uint32_t linesBegin = 0, linesEnd = 0;
+
+    uint32_t polygonsBegin = 0, polygonsEnd = 0;
+};
+
+struct FlatLayer {
+
+    struct Property {
+        // Index into keys and keyIds
+        uint32_t key;
+        // Index into values
+        uint32_t value;
+    };
+
+    FlatLayer(Arena& _arena) :
+        keys(_arena), keyIds(_arena), values(_arena), properties(_arena),
+        coordinates(_arena), lineEnds(_arena), polygonEnds(_arena), features(_arena) {}
+
+    uint32_t lineBegin(uint32_t _line) const { return _line == 0 ? 0 : lineEnds[_line - 1]; }
+
+    uint32_t polygonBegin(const FlatFeature& _feature, uint32_t _polygon) const {
+        return _polygon == _feature.polygonsBegin ? _feature.linesBegin : polygonEnds[_polygon - 1];
+    }
+
+    StringView name;
+
+    ArenaVector<StringView> keys;
+    // Interned IDs of keys
+    ArenaVector<uint32_t> keyIds;
+    ArenaVector<FlatValue> values;
+    ArenaVector<Property> properties;
+
+    ArenaVector<Point> coordinates;
+    // End of each line, polygon ring or set of points in coordinates
+    ArenaVector<uint32_t> lineEnds;
+    // End of each polygon in lineEnds
+    ArenaVector<uint32_t> polygonEnds;
+
+    ArenaVector<FlatFeature> features;
+
+};
+
+struct FlatTileData {
+
+    // Buffer that keys and string values of the layers point into
+    std::shared_ptr<std::vector<char>> rawTileData;
+
+    std::vector<FlatLayer> layers;
+
+};
+
+/* Selects the parts of a tile that will be drawn, so that a DataSource can
+ * skip decoding the rest. feature() is called for the features of the last
+ * collection accepted by collection(), with properties and geometryType set
+ * but before the geometry is decoded.
+ */
+struct TileDataFilter {
+
+    virtual ~TileDataFilter() {}
+
+    virtual bool collection(const std::string& _name) = 0;
+
+    virtual bool feature(const Feature& _feature) = 0;
+
+};
+
 }
@@ -2,6 +2,7 @@
 
 #include "tangram.h"
 #include "debug/textDisplay.h"
+#include "text/fontContext.h"
 #include "tile/tileManager.h"
 #include "tile/tile.h"
 #include "tile/tileCache.h"
@@ -21,6 +22,8 @@ static clock_t s_startFrameTime = 0,
     s_startUpdateTime = 0,
     s_endUpdateTime = 0;
 
+static uint32_t s_drawCalls = 0;
+
 void FrameInfo::beginUpdate() {
 
     if (Tangram::getDebugFlag(DebugFlags::tangram_infos)) {
@@ -38,15 +41,21 @@ void FrameInfo::endUpdate() {
 
 }
 
+void FrameInfo::addDrawCalls(uint32_t _count) {
+    s_drawCalls += _count;
+}
+
 void FrameInfo::beginFrame() {
 
+    s_drawCalls = 0;
+
     if (getDebugFlag(DebugFlags::tangram_infos)) {
         s_startFrameTime = clock();
     }
 
 }
 
-void FrameInfo::draw(const View& _view, TileManager& _tileManager) {
+void FrameInfo::draw(const View& _view, TileManager& _tileManager, FontContext* _fontContext) {
 
     if (getDebugFlag(DebugFlags::tangram_infos)) {
         static int cpt = 0;
@@ -93,6 +102,16 @@ void FrameInfo::draw(const View& _view, TileManager& _tileManager) {
         debuginfos.push_back("tile cache size:"
                 + std::to_string(_tileManager.getTileCache()->getMemoryUsage() / 1024) + "kb");
         debuginfos.push_back("tile size:" + std::to_string(memused / 1024) + "kb");
+        auto memory = _tileManager.getMemoryInfo();
+        debuginfos.push_back("tile buffers client/gpu:"
+                + std::to_string(memory.clientBuffers / 1024) + "kb/"
+                + std::to_string(memory.gpuBuffers / 1024) + "kb");
+        debuginfos.push_back("draw calls:" + std::to_string(s_drawCalls));
+        if (_fontContext) {
+            auto layouts = _fontContext->layoutCacheStats();
+            debuginfos.push_back("text layout cache:" + std::to_string(layouts.entries) + " hits:"
+                    + to_string_with_precision(layouts.hitRate() * 100, 1) + "%");
+        }
         debuginfos.push_back("avg frame cpu time:" + to_string_with_precision(avgTimeCpu, 2) + "ms");
         debuginfos.push_back("avg frame render time:" + to_string_with_precision(avgTimeRender, 2) + "ms");
         debuginfos.push_back("avg frame update time:" + to_string_with_precision(avgTimeUpdate, 2) + "ms");
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <cstdint>
+
 namespace Tangram {
 
+class FontContext;
 class TileManager;
 class View;
 
@@ -12,7 +15,10 @@ struct FrameInfo {
 
     static void endUpdate();
 
-    static void draw(const View& _view, TileManager& _tileManager);
+    /* Count draw calls issued in the current frame */
+    static void addDrawCalls(uint32_t _count = 1);
+
+    static void draw(const View& _view, TileManager& _tileManager, FontContext* _fontContext = nullptr);
 };
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "debug/frameInfo.h"
 #include "gl/mesh.h"
 #include "gl/renderState.h"
 #include "gl/shaderProgram.h"
@@ -47,6 +48,10 @@ public:
         return MeshBase::bufferSize();
     }
 
+    size_t gpuBufferSize() const override {
+        return MeshBase::gpuBufferSize();
+    }
+
     void clear() {
         // Clear vertices for next frame
         m_nVertices = 0;
@@ -117,6 +122,7 @@ bool DynamicQuadMesh<T>::draw(ShaderProgram& _shader) {
         m_vertexLayout->enable(_shader, byteOffset);
 
         glDrawElements(m_drawMode, nVertices * 6 / 4, GL_UNSIGNED_SHORT, 0);
+        FrameInfo::addDrawCalls();
 
         vertexOffset += nVertices;
     }
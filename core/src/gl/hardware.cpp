@@ -13,6 +13,7 @@ namespace Hardware {
 bool supportsMapBuffer = false;
 bool supportsVAOs = false;
 bool supportsTextureNPOT = false;
+bool supportsElementIndexUint = false;
 
 uint32_t maxTextureSize = 0;
 uint32_t maxCombinedTextureUnits = 0;
@@ -53,8 +54,14 @@ void loadExtensions() {
     supportsVAOs = isAvailable("vertex_array_object");
     supportsTextureNPOT = isAvailable("texture_non_power_of_two");
 
+    // 32-bit indices are core in GLES3 and desktop GL
+    auto version = (const char*) glGetString(GL_VERSION);
+    bool gles3 = version && strstr(version, "OpenGL ES 3") != nullptr;
+    supportsElementIndexUint = DESKTOP_GL || gles3 || isAvailable("element_index_uint");
+
     LOG("Driver supports map buffer: %d", supportsMapBuffer);
     LOG("Driver supports vaos: %d", supportsVAOs);
+    LOG("Driver supports 32-bit indices: %d", supportsElementIndexUint);
 
     // find extension symbols if needed
     initGLExtensions();
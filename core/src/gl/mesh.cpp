@@ -3,6 +3,9 @@
 #include "renderState.h"
 #include "hardware.h"
 #include "platform.h"
+#include "debug/frameInfo.h"
+
+#include <cstdint>
 
 namespace Tangram {
 
@@ -128,8 +131,10 @@ void MeshBase::upload() {
     RenderState::vertexBuffer(m_glVertexBuffer);
     glBufferData(GL_ARRAY_BUFFER, vertexBytes, m_glVertexData, m_hint);
 
-    delete[] m_glVertexData;
-    m_glVertexData = nullptr;
+    if (!m_retainData) {
+        delete[] m_glVertexData;
+        m_glVertexData = nullptr;
+    }
 
     if (m_glIndexData) {
 
@@ -140,10 +145,12 @@ void MeshBase::upload() {
         // Buffer element index data
         RenderState::indexBuffer(m_glIndexBuffer);
 
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * sizeof(GLushort), m_glIndexData, m_hint);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_nIndices * indexSize(), m_glIndexData, m_hint);
 
-        delete[] m_glIndexData;
-        m_glIndexData = nullptr;
+        if (!m_retainData) {
+            delete[] m_glIndexData;
+            m_glIndexData = nullptr;
+        }
     }
 
     m_generation = RenderState::generation();
@@ -158,6 +165,9 @@ bool MeshBase::draw(ShaderProgram& _shader) {
     if (!m_isCompiled) { return false; }
     if (m_nVertices == 0) { return false; }
 
+    // Data was released after upload and the buffers are gone
+    if (!m_isUploaded && !m_glVertexData) { return false; }
+
     // Enable shader program
     if (!_shader.use()) {
         return false;
@@ -205,9 +215,11 @@ bool MeshBase::draw(ShaderProgram& _shader) {
 
         // Draw as elements or arrays
         if (nIndices > 0) {
-            glDrawElements(m_drawMode, nIndices, GL_UNSIGNED_SHORT, (void*)(indiceOffset * sizeof(GLushort)));
+            glDrawElements(m_drawMode, nIndices, m_indexType, (void*)(indiceOffset * indexSize()));
+            FrameInfo::addDrawCalls();
         } else if (nVertices > 0) {
             glDrawArrays(m_drawMode, 0, nVertices);
+            FrameInfo::addDrawCalls();
         }
 
         vertexOffset += nVertices;
@@ -221,6 +233,13 @@ bool MeshBase::draw(ShaderProgram& _shader) {
     return true;
 }
 
+bool MeshBase::needsRebuild() const {
+    // Released data implies that the mesh was uploaded before
+    if (!m_isCompiled || m_nVertices == 0 || m_glVertexData) { return false; }
+
+    return !m_isUploaded || !RenderState::isValidGeneration(m_generation);
+}
+
 bool MeshBase::checkValidity() {
     if (!RenderState::isValidGeneration(m_generation)) {
         m_isUploaded = false;
@@ -237,46 +256,88 @@ bool MeshBase::checkValidity() {
 }
 
 size_t MeshBase::bufferSize() const {
-    return m_nVertices * m_vertexLayout->getStride() + m_nIndices * sizeof(GLushort);
+    return m_nVertices * m_vertexLayout->getStride() + m_nIndices * indexSize();
+}
+
+size_t MeshBase::clientBufferSize() const {
+    size_t size = 0;
+    if (m_glVertexData) { size += m_nVertices * m_vertexLayout->getStride(); }
+    if (m_glIndexData) { size += m_nIndices * indexSize(); }
+    return size;
+}
+
+size_t MeshBase::gpuBufferSize() const {
+    size_t size = 0;
+    if (m_glVertexBuffer) { size += m_nVertices * m_vertexLayout->getStride(); }
+    if (m_glIndexBuffer) { size += m_nIndices * indexSize(); }
+    return size;
+}
+
+void MeshBase::allocateIndices() {
+
+    // With 32-bit indices all vertices can be drawn in one batch
+    if (Hardware::supportsElementIndexUint && m_nVertices > MAX_INDEX_VALUE) {
+        m_indexType = GL_UNSIGNED_INT;
+    } else {
+        m_indexType = GL_UNSIGNED_SHORT;
+    }
+
+    m_glIndexData = new GLbyte[m_nIndices * indexSize()];
 }
 
 // Add indices by collecting them into batches to draw as much as
 // possible in one draw call.  The indices must be shifted by the
 // number of vertices that are present in the current batch.
-size_t MeshBase::compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
-                                const std::vector<uint16_t>& _indices, size_t _offset) {
-
+template<typename I>
+static size_t addIndices(I* _dst, std::vector<std::pair<uint32_t, uint32_t>>& _vertexOffsets,
+                         const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
+                         const std::vector<uint16_t>& _indices, size_t _maxIndexValue) {
 
-    GLushort* dst = m_glIndexData + _offset;
     size_t curVertices = 0;
     size_t src = 0;
 
-    if (m_vertexOffsets.empty()) {
-        m_vertexOffsets.emplace_back(0, 0);
+    if (_vertexOffsets.empty()) {
+        _vertexOffsets.emplace_back(0, 0);
     } else {
-        curVertices = m_vertexOffsets.back().second;
+        curVertices = _vertexOffsets.back().second;
     }
 
     for (auto& p : _offsets) {
         size_t nIndices = p.first;
         size_t nVertices = p.second;
 
-        if (curVertices + nVertices > MAX_INDEX_VALUE) {
-            m_vertexOffsets.emplace_back(0, 0);
+        if (curVertices + nVertices > _maxIndexValue) {
+            _vertexOffsets.emplace_back(0, 0);
             curVertices = 0;
         }
-        for (size_t i = 0; i < nIndices; i++, dst++) {
-            *dst = _indices[src++] + curVertices;
+        for (size_t i = 0; i < nIndices; i++, _dst++) {
+            *_dst = _indices[src++] + curVertices;
         }
 
-        auto& offset = m_vertexOffsets.back();
+        auto& offset = _vertexOffsets.back();
         offset.first += nIndices;
         offset.second += nVertices;
 
         curVertices += nVertices;
     }
 
-    return _offset + src;
+    return src;
+}
+
+size_t MeshBase::compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
+                                const std::vector<uint16_t>& _indices, size_t _offset) {
+
+    size_t added;
+
+    if (m_indexType == GL_UNSIGNED_INT) {
+        GLuint* dst = reinterpret_cast<GLuint*>(m_glIndexData) + _offset;
+        added = addIndices(dst, m_vertexOffsets, _offsets, _indices, UINT32_MAX);
+    } else {
+        GLushort* dst = reinterpret_cast<GLushort*>(m_glIndexData) + _offset;
+        added = addIndices(dst, m_vertexOffsets, _offsets, _indices, MAX_INDEX_VALUE);
+    }
+
+    return _offset + added;
 }
 
 void MeshBase::setDirty(GLintptr _byteOffset, GLsizei _byteSize) {
@@ -66,6 +66,17 @@ public:
 
     size_t bufferSize() const;
 
+    /* Bytes of compiled vertex and index data waiting for upload */
+    size_t clientBufferSize() const;
+
+    /* Bytes of uploaded vertex and index buffers */
+    size_t gpuBufferSize() const;
+
+    /* Keep the compiled data after upload, see Style::setRetainMeshData() */
+    void setRetainData(bool _retain) { m_retainData = _retain; }
+
+    bool needsRebuild() const;
+
 protected:
 
     int m_generation; // Generation in which this mesh's GL handles were created
@@ -86,8 +97,16 @@ protected:
 
     size_t m_nIndices;
     GLuint m_glIndexBuffer;
-    // Compiled  indices for upload
-    GLushort* m_glIndexData = nullptr;
+    // Compiled  indices for upload, GLushort or GLuint depending on m_indexType
+    GLbyte* m_glIndexData = nullptr;
+
+    // GL_UNSIGNED_INT when the mesh is larger than MAX_INDEX_VALUE vertices
+    // and the driver supports 32-bit indices, so that it can be drawn at once
+    GLenum m_indexType = GL_UNSIGNED_SHORT;
+
+    size_t indexSize() const {
+        return m_indexType == GL_UNSIGNED_INT ? sizeof(GLuint) : sizeof(GLushort);
+    }
 
     GLenum m_drawMode;
     GLenum m_hint;
@@ -95,12 +114,16 @@ protected:
     bool m_isUploaded;
     bool m_isCompiled;
     bool m_dirty;
+    bool m_retainData = false;
 
     GLsizei m_dirtySize;
     GLintptr m_dirtyOffset;
 
     bool checkValidity();
 
+    // Choose the index type for m_nVertices and allocate m_glIndexData
+    void allocateIndices();
+
     size_t compileIndices(const std::vector<std::pair<uint32_t, uint32_t>>& _offsets,
                           const std::vector<uint16_t>& _indices, size_t _offset);
 
@@ -142,6 +165,22 @@ public:
         return MeshBase::bufferSize();
     }
 
+    size_t clientBufferSize() const override {
+        return MeshBase::clientBufferSize();
+    }
+
+    size_t gpuBufferSize() const override {
+        return MeshBase::gpuBufferSize();
+    }
+
+    bool needsRebuild() const override {
+        return MeshBase::needsRebuild();
+    }
+
+    void setRetainData(bool _retain) {
+        MeshBase::setRetainData(_retain);
+    }
+
     bool draw(ShaderProgram& _shader) override {
         return MeshBase::draw(_shader);
     }
@@ -194,7 +233,7 @@ void Mesh<T>::compile(const std::vector<MeshData<T>>& _meshes) {
     assert(offset == m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
+        allocateIndices();
 
         size_t offset = 0;
         for (auto& m : _meshes) {
@@ -220,7 +259,7 @@ void Mesh<T>::compile(const MeshData<T>& _mesh) {
                 m_nVertices * stride);
 
     if (m_nIndices > 0) {
-        m_glIndexData = new GLushort[m_nIndices];
+        allocateIndices();
         compileIndices(_mesh.offsets, _mesh.indices, 0);
     }
 
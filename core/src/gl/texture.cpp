@@ -323,7 +323,7 @@ bool Texture::isRepeatWrapping(TextureWrapping _wrapping) {
     return _wrapping.wraps == GL_REPEAT || _wrapping.wrapt == GL_REPEAT;
 }
 
-size_t Texture::bytesPerPixel() {
+size_t Texture::bytesPerPixel() const {
     switch (m_options.internalFormat) {
         case GL_ALPHA:
         case GL_LUMINANCE:
@@ -63,6 +63,9 @@ public:
     unsigned int getWidth() const { return m_width; }
     unsigned int getHeight() const { return m_height; }
 
+    /* Size of the texture data in bytes */
+    size_t bufferSize() const { return m_width * m_height * bytesPerPixel(); }
+
     void bind(GLuint _unit);
 
     void setDirty(size_t yOffset, size_t height);
@@ -119,7 +122,7 @@ protected:
 
 private:
 
-    size_t bytesPerPixel();
+    size_t bytesPerPixel() const;
 
     bool m_generateMipmaps;
     bool m_validData;
@@ -0,0 +1,237 @@
+#include "collisionGrid.h"
+
+#include "glm/glm.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Tangram {
+
+constexpr float CollisionGrid::move_tolerance;
+
+static void eraseValue(std::vector<uint32_t>& _values, uint32_t _value) {
+    auto it = std::find(_values.begin(), _values.end(), _value);
+    if (it != _values.end()) {
+        *it = _values.back();
+        _values.pop_back();
+    }
+}
+
+static bool sameQuads(const std::array<glm::vec2, 4>& _a, const std::array<glm::vec2, 4>& _b,
+                      float _tolerance) {
+    for (int i = 0; i < 4; i++) {
+        glm::vec2 d = glm::abs(_a[i] - _b[i]);
+        if (d.x > _tolerance || d.y > _tolerance) { return false; }
+    }
+    return true;
+}
+
+// Separating axis test for two oriented boxes, given by their corners in order
+static bool quadsIntersect(const std::array<glm::vec2, 4>& _a, const std::array<glm::vec2, 4>& _b) {
+
+    auto separated = [&](glm::vec2 _axis) {
+        float minA = INFINITY, maxA = -INFINITY;
+        float minB = INFINITY, maxB = -INFINITY;
+        for (int i = 0; i < 4; i++) {
+            float a = glm::dot(_a[i], _axis);
+            float b = glm::dot(_b[i], _axis);
+            minA = std::min(minA, a); maxA = std::max(maxA, a);
+            minB = std::min(minB, b); maxB = std::max(maxB, b);
+        }
+        return maxA < minB || maxB < minA;
+    };
+
+    for (auto* quad : { &_a, &_b }) {
+        for (int i = 0; i < 2; i++) {
+            if (separated((*quad)[i + 1] - (*quad)[i])) { return false; }
+        }
+    }
+    return true;
+}
+
+void CollisionGrid::clear() {
+    m_entries.clear();
+    m_freeEntries.clear();
+    m_movedEntries.clear();
+    m_ids.clear();
+    m_cells.clear();
+}
+
+void CollisionGrid::setBoxes(Entry& _entry, const AABB& _aabb, const OBB& _obb) const {
+    _entry.min = _aabb.min - m_origin;
+    _entry.max = _aabb.max - m_origin;
+
+    const auto& quad = _obb.getQuad();
+    for (int i = 0; i < 4; i++) {
+        _entry.quad[i] = quad[i] - m_origin;
+    }
+}
+
+bool CollisionGrid::sameBoxes(const Entry& _entry, const AABB& _aabb, const OBB& _obb) const {
+    Entry boxes;
+    setBoxes(boxes, _aabb, _obb);
+
+    glm::vec2 dmin = glm::abs(boxes.min - _entry.min);
+    glm::vec2 dmax = glm::abs(boxes.max - _entry.max);
+    if (std::max(std::max(dmin.x, dmin.y), std::max(dmax.x, dmax.y)) > move_tolerance) {
+        return false;
+    }
+    return sameQuads(boxes.quad, _entry.quad, move_tolerance);
+}
+
+void CollisionGrid::update(uint64_t _labelId, const AABB& _aabb, const OBB& _obb, uint32_t _index) {
+
+    uint32_t id;
+    auto it = m_ids.find(_labelId);
+
+    if (it == m_ids.end()) {
+        if (m_freeEntries.empty()) {
+            id = m_entries.size();
+            m_entries.emplace_back();
+        } else {
+            id = m_freeEntries.back();
+            m_freeEntries.pop_back();
+        }
+        m_ids.emplace(_labelId, id);
+
+        auto& entry = m_entries[id];
+        entry.label = _labelId;
+        setBoxes(entry, _aabb, _obb);
+        insertCells(id);
+
+    } else {
+        id = it->second;
+
+        auto& entry = m_entries[id];
+        entry.index = _index;
+
+        // Keep the boxes that were tested, so that small differences
+        // do not add up over frames
+        if (sameBoxes(entry, _aabb, _obb)) {
+            entry.frame = m_frame;
+            return;
+        }
+
+        removeCells(id);
+        setBoxes(entry, _aabb, _obb);
+        insertCells(id);
+    }
+
+    auto& entry = m_entries[id];
+    entry.index = _index;
+    entry.frame = m_frame;
+
+    if (!entry.moved) {
+        entry.moved = true;
+        m_movedEntries.push_back(id);
+    }
+}
+
+void CollisionGrid::insertCells(uint32_t _id) {
+    auto& entry = m_entries[_id];
+
+    entry.cellMin = glm::ivec2(glm::floor(entry.min / m_cellSize));
+    entry.cellMax = glm::ivec2(glm::floor(entry.max / m_cellSize));
+
+    for (int y = entry.cellMin.y; y <= entry.cellMax.y; y++) {
+        for (int x = entry.cellMin.x; x <= entry.cellMax.x; x++) {
+            m_cells[cellKey(x, y)].push_back(_id);
+        }
+    }
+}
+
+void CollisionGrid::removeCells(uint32_t _id) {
+    auto& entry = m_entries[_id];
+
+    for (int y = entry.cellMin.y; y <= entry.cellMax.y; y++) {
+        for (int x = entry.cellMin.x; x <= entry.cellMax.x; x++) {
+            auto it = m_cells.find(cellKey(x, y));
+            if (it == m_cells.end()) { continue; }
+
+            eraseValue(it->second, _id);
+            if (it->second.empty()) { m_cells.erase(it); }
+        }
+    }
+}
+
+void CollisionGrid::unlinkCollisions(uint32_t _id) {
+    auto& entry = m_entries[_id];
+
+    for (uint32_t other : entry.collisions) {
+        eraseValue(m_entries[other].collisions, _id);
+    }
+    entry.collisions.clear();
+}
+
+void CollisionGrid::commit() {
+
+    // Remove labels that were not updated in this frame
+    for (auto it = m_ids.begin(); it != m_ids.end(); ) {
+        uint32_t id = it->second;
+        auto& entry = m_entries[id];
+
+        if (entry.frame == m_frame) {
+            ++it;
+            continue;
+        }
+        removeCells(id);
+        unlinkCollisions(id);
+
+        entry.label = 0;
+        entry.moved = false;
+        m_freeEntries.push_back(id);
+
+        it = m_ids.erase(it);
+    }
+
+    // Drop the collisions of moved labels, including those that were
+    // removed again in this frame
+    m_movedEntries.erase(std::remove_if(m_movedEntries.begin(), m_movedEntries.end(),
+                                        [&](uint32_t id) { return m_entries[id].label == 0; }),
+                         m_movedEntries.end());
+
+    for (uint32_t id : m_movedEntries) {
+        unlinkCollisions(id);
+    }
+
+    // Re-test moved labels against all labels in their cells. A pair of
+    // moved labels is tested by the first one of the two.
+    for (uint32_t id : m_movedEntries) {
+        auto& entry = m_entries[id];
+        entry.tested = m_frame;
+        m_visit++;
+
+        for (int y = entry.cellMin.y; y <= entry.cellMax.y; y++) {
+            for (int x = entry.cellMin.x; x <= entry.cellMax.x; x++) {
+                auto cell = m_cells.find(cellKey(x, y));
+                if (cell == m_cells.end()) { continue; }
+
+                for (uint32_t other : cell->second) {
+                    auto& candidate = m_entries[other];
+
+                    if (other == id || candidate.visit == m_visit) { continue; }
+                    candidate.visit = m_visit;
+
+                    if (candidate.tested == m_frame) { continue; }
+
+                    if (entry.min.x > candidate.max.x || entry.max.x < candidate.min.x ||
+                        entry.min.y > candidate.max.y || entry.max.y < candidate.min.y) {
+                        continue;
+                    }
+                    if (!quadsIntersect(entry.quad, candidate.quad)) { continue; }
+
+                    entry.collisions.push_back(other);
+                    candidate.collisions.push_back(id);
+                }
+            }
+        }
+        entry.moved = false;
+    }
+
+    m_numMoved = m_movedEntries.size();
+    m_movedEntries.clear();
+
+    m_frame++;
+}
+
+}
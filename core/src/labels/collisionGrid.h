@@ -0,0 +1,123 @@
+#pragma once
+
+#include "glm/vec2.hpp"
+#include <climits> // needed in aabb.h
+#include "isect2d.h"
+#include "glm_vec.h" // for isect2d.h
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+/* Broadphase for label collisions that persists across frames
+ *
+ * Labels are kept in a uniform grid together with the bounding boxes they
+ * had when they were last tested. The boxes are stored relative to the
+ * screen position of a fixed map point (see setOrigin()), so that panning
+ * the view does not move them. update() only moves a label when its boxes
+ * changed by more than a fraction of a pixel, and commit() only re-tests
+ * moved labels against the labels in their cells. Collisions between labels
+ * that did not move are kept from the previous frame. Labels that were not
+ * updated since the last commit() are removed.
+ *
+ * Labels are keyed by Label::id(), so that the grid can be updated from a
+ * snapshot of the label boxes on another thread.
+ */
+class CollisionGrid {
+
+public:
+
+    using AABB = isect2d::AABB<glm::vec2>;
+    using OBB = isect2d::OBB<glm::vec2>;
+
+    // Boxes that changed by at most this many pixels are not re-tested
+    static constexpr float move_tolerance = 0.25f;
+
+    explicit CollisionGrid(float _cellSize = 128.f) : m_cellSize(_cellSize) {}
+
+    // Set the screen position of the map point that the boxes of the
+    // following update() calls are relative to
+    void setOrigin(glm::vec2 _screenOrigin) { m_origin = _screenOrigin; }
+
+    // Insert the label @_labelId or update its bounding boxes, given in screen
+    // space. @_index is passed back by forEachCollision() until the next update.
+    void update(uint64_t _labelId, const AABB& _aabb, const OBB& _obb, uint32_t _index);
+
+    // Remove labels that were not updated and re-test the moved ones
+    void commit();
+
+    void clear();
+
+    // Call @_fn with the index of each label whose OBB intersects the OBB
+    // of the label @_labelId, valid after commit()
+    template<typename F>
+    void forEachCollision(uint64_t _labelId, F _fn) const {
+        auto it = m_ids.find(_labelId);
+        if (it == m_ids.end()) { return; }
+
+        for (uint32_t id : m_entries[it->second].collisions) {
+            _fn(m_entries[id].index);
+        }
+    }
+
+    size_t size() const { return m_ids.size(); }
+
+    // Number of labels re-tested by the last commit()
+    size_t moved() const { return m_numMoved; }
+
+private:
+
+    using Quad = std::array<glm::vec2, 4>;
+
+    struct Entry {
+        // Zero for unused entries
+        uint64_t label = 0;
+        uint32_t index = 0;
+        // Boxes relative to the origin
+        glm::vec2 min, max;
+        Quad quad;
+        // Covered cell range, inclusive
+        glm::ivec2 cellMin;
+        glm::ivec2 cellMax;
+        // Frame of the last update()
+        uint32_t frame = 0;
+        // Frame of the last re-test
+        uint32_t tested = 0;
+        // Query that last visited this entry, to skip duplicates across cells
+        uint32_t visit = 0;
+        bool moved = false;
+        std::vector<uint32_t> collisions;
+    };
+
+    void setBoxes(Entry& _entry, const AABB& _aabb, const OBB& _obb) const;
+    bool sameBoxes(const Entry& _entry, const AABB& _aabb, const OBB& _obb) const;
+
+    void insertCells(uint32_t _id);
+    void removeCells(uint32_t _id);
+    void unlinkCollisions(uint32_t _id);
+
+    static uint64_t cellKey(int _x, int _y) {
+        return (uint64_t(uint32_t(_x)) << 32) | uint32_t(_y);
+    }
+
+    float m_cellSize;
+    glm::vec2 m_origin = glm::vec2(0.f);
+
+    std::vector<Entry> m_entries;
+    std::vector<uint32_t> m_freeEntries;
+    std::vector<uint32_t> m_movedEntries;
+    std::unordered_map<uint64_t, uint32_t> m_ids;
+
+    // Only cells that contain labels, the grid is not bounded by the screen
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells;
+
+    uint32_t m_frame = 1;
+    uint32_t m_visit = 0;
+    size_t m_numMoved = 0;
+};
+
+}
@@ -4,8 +4,12 @@
 #include "glm/gtx/rotate_vector.hpp"
 #include "tangram.h"
 
+#include <atomic>
+
 namespace Tangram {
 
+static std::atomic<uint64_t> s_nextLabelId(1);
+
 Label::Label(Label::Transform _transform, glm::vec2 _size, Type _type, Options _options, LabelProperty::Anchor _anchor)
     : m_type(_type),
       m_transform(_transform),
@@ -13,6 +17,8 @@ Label::Label(Label::Transform _transform, glm::vec2 _size, Type _type, Options _
       m_options(_options),
       m_anchorType(_anchor) {
 
+    m_id = s_nextLabelId++;
+
     if (!m_options.collide || m_type == Type::debug){
         enterState(State::visible, 1.0);
     } else {
@@ -36,26 +42,36 @@ void Label::setProxy(bool _proxy) {
     m_proxy = _proxy;
 }
 
-bool Label::updateScreenTransform(const glm::mat4& _mvp, const glm::vec2& _screenSize, bool _testVisibility) {
+Label::Shape Label::shape() const {
+    Shape shape;
+    shape.type = m_type;
+    shape.modelPosition1 = m_transform.modelPosition1;
+    shape.modelPosition2 = m_transform.modelPosition2;
+    shape.dim = m_dim;
+    shape.offset = m_options.offset;
+    shape.rotation = m_transform.state.rotation;
+    shape.anchor = anchor();
+    shapeBox(shape);
+    return shape;
+}
+
+bool Label::screenTransform(const Shape& _shape, const glm::mat4& _mvp, const glm::vec2& _screenSize,
+                            bool _testVisibility, glm::vec2& _screenPos, float& _rotation) {
 
     glm::vec2 screenPosition;
     float rot = 0;
 
-    glm::vec2 ap1, ap2;
-
-    switch (m_type) {
+    switch (_shape.type) {
         case Type::debug:
         case Type::point:
         {
-            glm::vec4 v1 = worldToClipSpace(_mvp, glm::vec4(m_transform.modelPosition1, 0.0, 1.0));
+            glm::vec4 v1 = worldToClipSpace(_mvp, glm::vec4(_shape.modelPosition1, 0.0, 1.0));
 
             if (_testVisibility && (v1.w <= 0)) {
                 return false;
             }
 
-            screenPosition = clipToScreenSpace(v1, _screenSize);
-
-            ap1 = ap2 = screenPosition;
+            screenPosition = clipToScreenSpace(v1, _screenSize) + _shape.anchor;
 
             break;
         }
@@ -63,8 +79,8 @@ bool Label::updateScreenTransform(const glm::mat4& _mvp, const glm::vec2& _scree
         {
             // project label position from mercator world space to clip
             // coordinates
-            glm::vec4 v1 = worldToClipSpace(_mvp, glm::vec4(m_transform.modelPosition1, 0.0, 1.0));
-            glm::vec4 v2 = worldToClipSpace(_mvp, glm::vec4(m_transform.modelPosition2, 0.0, 1.0));
+            glm::vec4 v1 = worldToClipSpace(_mvp, glm::vec4(_shape.modelPosition1, 0.0, 1.0));
+            glm::vec4 v2 = worldToClipSpace(_mvp, glm::vec4(_shape.modelPosition2, 0.0, 1.0));
 
             // check whether the label is behind the camera using the
             // perspective division factor
@@ -88,44 +104,68 @@ bool Label::updateScreenTransform(const glm::mat4& _mvp, const glm::vec2& _scree
 
             float exceedHeuristic = 30; // default heuristic : 30%
 
-            if (_testVisibility && (m_dim.x > length)) {
-                float exceed = (1 - (length / m_dim.x)) * 100;
+            if (_testVisibility && (_shape.dim.x > length)) {
+                float exceed = (1 - (length / _shape.dim.x)) * 100;
                 if (exceed > exceedHeuristic) {
                     return false;
                 }
             }
 
-            ap1 = p1;
-            ap2 = p2;
+            // anchor at line center
+            screenPosition = (p1 + p2) * 0.5f;
 
             break;
         }
     }
 
-    align(screenPosition, ap1, ap2);
+    glm::vec2 offset = _shape.offset;
 
-    // update screen position
-    glm::vec2 offset = m_options.offset;
+    if (_shape.rotation != 0.f) {
+        offset = glm::rotate(offset, _shape.rotation);
+    }
+
+    _screenPos = screenPosition + offset;
+    _rotation = rot;
+
+    return true;
+}
+
+Label::OBB Label::screenBox(const Shape& _shape, const glm::vec2& _screenPos, float _rotation, float _zoomFract) {
+    glm::vec2 center = _screenPos + _shape.boxOffset;
+    glm::vec2 size = _shape.boxSize + glm::vec2(_shape.boxExtrude * 2.f * _zoomFract);
+
+    return OBB(center.x, center.y, _rotation, size.x, size.y);
+}
+
+bool Label::updateScreenTransform(const glm::mat4& _mvp, const glm::vec2& _screenSize, bool _testVisibility) {
+
+    glm::vec2 screenPos;
+    float rotation;
 
-    if (m_transform.state.rotation != 0.f) {
-        offset = glm::rotate(offset, m_transform.state.rotation);
+    if (!screenTransform(shape(), _mvp, _screenSize, _testVisibility, screenPos, rotation)) {
+        return false;
     }
 
-    glm::vec2 newScreenPos = screenPosition + offset;
-    if (newScreenPos != m_transform.state.screenPos) {
-        m_transform.state.screenPos = newScreenPos;
+    // update screen position
+    if (screenPos != m_transform.state.screenPos) {
+        m_transform.state.screenPos = screenPos;
         m_dirty = true;
     }
 
     // update screen rotation
-    if (m_transform.state.rotation != rot) {
-        m_transform.state.rotation = rot;
+    if (m_transform.state.rotation != rotation) {
+        m_transform.state.rotation = rotation;
         m_dirty = true;
     }
 
     return true;
 }
 
+void Label::updateBBoxes(float _zoomFract) {
+    m_obb = screenBox(shape(), m_transform.state.screenPos, m_transform.state.rotation, _zoomFract);
+    m_aabb = m_obb.getExtent();
+}
+
 void Label::setParent(const Label& _parent, bool _definePriority) {
     m_parent = &_parent;
 
@@ -140,8 +180,8 @@ void Label::setParent(const Label& _parent, bool _definePriority) {
     m_options.offset += _parent.options().offset;
 }
 
-bool Label::offViewport(const glm::vec2& _screenSize) {
-    const auto& quad = m_obb.getQuad();
+bool Label::offViewport(const OBB& _obb, const glm::vec2& _screenSize) {
+    const auto& quad = _obb.getQuad();
 
     for (int i = 0; i < 4; ++i) {
         const auto& p = quad[i];
@@ -249,7 +289,7 @@ bool Label::update(const glm::mat4& _mvp, const glm::vec2& _screenSize, float _z
     updateBBoxes(_zoomFract);
 
     // checks whether the label is out of the viewport
-    if (offViewport(_screenSize)) {
+    if (offViewport(m_obb, _screenSize)) {
         enterState(State::out_of_screen, 0.0);
     }
 
@@ -300,7 +340,7 @@ bool Label::evalState(const glm::vec2& _screenSize, float _dt) {
             }
             break;
         case State::out_of_screen:
-            if (!offViewport(_screenSize)) {
+            if (!offViewport(m_obb, _screenSize)) {
                 enterState(State::wait_occ, 0.0);
             }
             break;
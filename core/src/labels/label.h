@@ -56,6 +56,25 @@ public:
         } state;
     };
 
+    /* Everything the screen transform and boxes of a label depend on, copied
+     * so that they can be computed without the label on another thread */
+    struct Shape {
+        Type type;
+        glm::vec2 modelPosition1;
+        glm::vec2 modelPosition2;
+        glm::vec2 dim;
+        glm::vec2 offset;
+        // Rotation of the last screen transform, which the offset follows
+        float rotation;
+        // Added to the screen position of point labels
+        glm::vec2 anchor;
+        // Center of the bounding box relative to the screen position and
+        // its size, which grows by boxExtrude per zoom fraction on each side
+        glm::vec2 boxOffset;
+        glm::vec2 boxSize;
+        float boxExtrude;
+    };
+
     struct Transition {
         FadeEffect::Interpolation ease = FadeEffect::Interpolation::sine;
         float time = 0.2;
@@ -84,6 +103,19 @@ public:
 
     bool update(const glm::mat4& _mvp, const glm::vec2& _screenSize, float _zoomFract);
 
+    /* Copy of the current projection inputs of the label */
+    Shape shape() const;
+
+    /* Screen position and rotation of @_shape, false when one of the label
+     * rules is not satisfied */
+    static bool screenTransform(const Shape& _shape, const glm::mat4& _mvp, const glm::vec2& _screenSize,
+                                bool _testVisibility, glm::vec2& _screenPos, float& _rotation);
+
+    /* Oriented bounding box of @_shape at a screen position */
+    static OBB screenBox(const Shape& _shape, const glm::vec2& _screenPos, float _rotation, float _zoomFract);
+
+    static bool offViewport(const OBB& _obb, const glm::vec2& _screenSize);
+
     /* Push the pending transforms to the vbo by updating the vertices */
     virtual void pushTransform() = 0;
 
@@ -93,7 +125,7 @@ public:
     bool updateScreenTransform(const glm::mat4& _mvp, const glm::vec2& _screenSize,
                                bool _testVisibility = true);
 
-    virtual void updateBBoxes(float _zoomFract) = 0;
+    void updateBBoxes(float _zoomFract);
 
     /* Occlude the label */
     void occlude(bool _occlusion = true);
@@ -110,8 +142,16 @@ public:
 
     void setProxy(bool _proxy);
 
+    /* Move a point label to @_position in model space */
+    void setModelPosition(glm::vec2 _position) {
+        m_transform.modelPosition1 = m_transform.modelPosition2 = _position;
+        m_dirty = true;
+    }
+
     /* Whether the label belongs to a proxy tile */
     bool isProxy() const { return m_proxy; }
+    /* Unique for the lifetime of the process, unlike the label address */
+    uint64_t id() const { return m_id; }
     size_t hash() const { return m_options.paramHash; }
     const glm::vec2& dimension() const { return m_dim; }
     /* Gets for label options: color and offset */
@@ -138,12 +178,11 @@ private:
     virtual void applyAnchor(const glm::vec2& _dimension, const glm::vec2& _origin,
         LabelProperty::Anchor _anchor) = 0;
 
-    bool offViewport(const glm::vec2& _screenSize);
-
     inline void enterState(const State& _state, float _alpha = 1.0f);
 
     void setAlpha(float _alpha);
 
+    uint64_t m_id;
     bool m_proxy;
     // the current label state
     State m_state;
@@ -155,8 +194,8 @@ private:
 
 protected:
 
-    // set alignment on _screenPosition based on anchor points _ap1, _ap2
-    virtual void align(glm::vec2& _screenPosition, const glm::vec2& _ap1, const glm::vec2& _ap2) = 0;
+    // set the bounding box parameters of @_shape
+    virtual void shapeBox(Shape& _shape) const = 0;
 
     // the label type (point/line)
     Type m_type;
@@ -12,6 +12,8 @@
 #include "tile/tileCache.h"
 #include "labels/labelSet.h"
 #include "labels/textLabel.h"
+#include "marker/markerManager.h"
+#include "util/geom.h"
 
 #include "glm/glm.hpp"
 #include "glm/gtc/matrix_transform.hpp"
@@ -20,11 +22,49 @@
 
 namespace Tangram {
 
+// Maximum distance of the collision grid origin from the view in pixels
+static const double max_grid_origin_distance = 100000;
+
 Labels::Labels()
     : m_needUpdate(false),
-      m_lastZoom(0.0f) {}
+      m_needPlacement(false),
+      m_placementRunning(false),
+      m_gridOrigin(0.0),
+      m_lastZoom(0.0f),
+      m_jobQueued(false),
+      m_jobDone(false),
+      m_stopWorker(false) {
+
+    m_worker = std::thread(&Labels::runPlacementWorker, this);
+}
+
+Labels::~Labels() {
+    {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        m_stopWorker = true;
+    }
+    m_workerCondition.notify_one();
+    m_worker.join();
+}
+
+void Labels::runPlacementWorker() {
+
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+
+    while (true) {
+        m_workerCondition.wait(lock, [&]{ return m_jobQueued || m_stopWorker; });
+        if (m_stopWorker) { return; }
 
-Labels::~Labels() {}
+        m_jobQueued = false;
+
+        // The main thread does not touch the job until m_jobDone is set
+        lock.unlock();
+        resolveOcclusions(m_workerJob);
+        lock.lock();
+
+        m_jobDone = true;
+    }
+}
 
 // int Labels::LODDiscardFunc(float _maxZoom, float _zoom) {
 //     return (int) MIN(floor(((log(-_zoom + (_maxZoom + 2)) / log(_maxZoom + 2) * (_maxZoom )) * 0.5)), MAX_LOD);
@@ -33,7 +73,15 @@ Labels::~Labels() {}
 void Labels::updateLabels(const View& _view, float _dt,
                           const std::vector<std::unique_ptr<Style>>& _styles,
                           const std::vector<std::shared_ptr<Tile>>& _tiles,
-                          bool _onlyTransitions) {
+                          bool _onlyTransitions, const MarkerManager* _markers) {
+
+    if (_onlyTransitions && placementPending()) {
+        // Apply the placement results or start the postponed placement
+        m_labels.clear();
+        updateLabels(_view, _dt, _styles, _tiles, false, _markers);
+        placeLabels(_view, _dt);
+        return;
+    }
 
     m_needUpdate = false;
 
@@ -42,6 +90,45 @@ void Labels::updateLabels(const View& _view, float _dt,
     // int lodDiscard = LODDiscardFunc(View::s_maxZoom, _view.getZoom());
     float dz = _view.getZoom() - std::floor(_view.getZoom());
 
+    m_matrices.clear();
+    if (!_onlyTransitions) {
+        m_labelMatrices.clear();
+        m_projected.clear();
+    }
+
+    auto updateLabel = [&](Label& _label, uint32_t _matrix, bool _proxy) {
+        if (_label.state() == Label::State::sleep) {
+            // Not drawn, leave the projection to the placement worker
+            if (!_onlyTransitions) {
+                _label.setProxy(_proxy);
+                m_labels.push_back(&_label);
+                m_labelMatrices.push_back(_matrix);
+                m_projected.push_back(false);
+            }
+            return;
+        }
+
+        if (!_label.update(m_matrices[_matrix], screenSize, dz)) {
+            // skip dead labels
+            return;
+        }
+
+        if (_onlyTransitions) {
+            if (!_label.canOcclude() || _label.visibleState()) {
+                m_needUpdate |= _label.evalState(screenSize, _dt);
+                _label.pushTransform();
+            }
+        } else if (_label.canOcclude()) {
+            _label.setProxy(_proxy);
+            m_labels.push_back(&_label);
+            m_labelMatrices.push_back(_matrix);
+            m_projected.push_back(true);
+        } else {
+            m_needUpdate |= _label.evalState(screenSize, _dt);
+            _label.pushTransform();
+        }
+    };
+
     for (const auto& tile : _tiles) {
 
         // discard based on level of detail
@@ -51,7 +138,8 @@ void Labels::updateLabels(const View& _view, float _dt,
 
         bool proxyTile = tile->isProxy();
 
-        glm::mat4 mvp = _view.getViewProjectionMatrix() * tile->getModelMatrix();
+        uint32_t matrix = m_matrices.size();
+        m_matrices.push_back(_view.getViewProjectionMatrix() * tile->getModelMatrix());
 
         for (const auto& style : _styles) {
             const auto& mesh = tile->getMesh(*style);
@@ -60,26 +148,19 @@ void Labels::updateLabels(const View& _view, float _dt,
             auto labelMesh = dynamic_cast<const LabelSet*>(mesh.get());
             if (!labelMesh) { continue; }
             for (auto& label : labelMesh->getLabels()) {
-                if (!label->update(mvp, screenSize, dz)) {
-                    // skip dead labels
-                    continue;
-                }
-
-                if (_onlyTransitions) {
-                    if (!label->canOcclude() || label->visibleState()) {
-                        m_needUpdate |= label->evalState(screenSize, _dt);
-                        label->pushTransform();
-                    }
-                } else if (label->canOcclude()) {
-                    label->setProxy(proxyTile);
-                    m_labels.push_back(label.get());
-                } else {
-                    m_needUpdate |= label->evalState(screenSize, _dt);
-                    label->pushTransform();
-                }
+                updateLabel(*label, matrix, proxyTile);
             }
         }
     }
+
+    if (_markers) {
+        uint32_t matrix = m_matrices.size();
+        m_matrices.push_back(_view.getViewProjectionMatrix() * _markers->modelMatrix());
+
+        for (auto* label : _markers->labels()) {
+            updateLabel(*label, matrix, false);
+        }
+    }
 }
 
 void Labels::skipTransitions(const std::vector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const {
@@ -169,47 +250,52 @@ void Labels::skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
     }
 }
 
-void Labels::checkRepeatGroups(std::vector<Label*>& _visibleSet) const {
+void Labels::checkRepeatGroups(std::vector<Placement*>& _visibleSet) {
 
-    struct GroupElement {
-        Label* label;
+    // Sort by repeat group and within a group by position, so that the labels
+    // are always treated in the same order and each group is one range
+    std::sort(_visibleSet.begin(), _visibleSet.end(),
+              [](auto* _a, auto* _b) {
+        if (_a->repeatGroup != _b->repeatGroup) {
+            return _a->repeatGroup < _b->repeatGroup;
+        }
+        return _a->modelDistance2 < _b->modelDistance2;
+    });
 
-        bool operator==(const GroupElement& _ge) {
-            return _ge.label->center() == label->center();
-        };
-    };
+    auto& group = m_repeatGroup;
 
-    std::map<size_t, std::vector<GroupElement>> repeatGroups;
+    for (size_t i = 0; i < _visibleSet.size(); i++) {
+        Placement* textLabel = _visibleSet[i];
 
-    for (Label* textLabel : _visibleSet) {
-        auto& options = textLabel->options();
-        GroupElement element { textLabel };
+        if (i == 0 || _visibleSet[i-1]->repeatGroup != textLabel->repeatGroup) {
+            group.clear();
+        }
 
-        auto& group = repeatGroups[options.repeatGroup];
         if (group.empty()) {
-            group.push_back(element);
+            group.push_back(textLabel);
             continue;
         }
 
-        if (std::find(group.begin(), group.end(), element) != group.end()) {
+        if (std::find_if(group.begin(), group.end(), [&](auto* _label) {
+                    return _label->center == textLabel->center; }) != group.end()) {
             //Two tiles contain the same label - have the same screen position.
             continue;
         }
 
-        float threshold2 = pow(options.repeatDistance, 2);
+        float threshold2 = pow(textLabel->repeatDistance, 2);
 
         bool add = true;
-        for (GroupElement& ge : group) {
+        for (Placement*& ge : group) {
 
-            float d2 = distance2(ge.label->center(), textLabel->center());
+            float d2 = distance2(ge->center, textLabel->center);
             if (d2 < threshold2) {
-                if (textLabel->visibleState() && !ge.label->visibleState()) {
+                if (textLabel->visible && !ge->visible) {
                     // If textLabel is already visible, the added GroupElement is not
                     // replace GroupElement with textLabel and set the other occluded.
-                    ge.label->occlude();
-                    ge.label = textLabel;
+                    ge->occluded = true;
+                    ge = textLabel;
                 } else {
-                    textLabel->occlude();
+                    textLabel->occluded = true;
                 }
                 add = false;
                 break;
@@ -218,7 +304,7 @@ void Labels::checkRepeatGroups(std::vector<Label*>& _visibleSet) const {
 
         if (add) {
             // No other label of this group within repeatDistance
-            group.push_back(element);
+            group.push_back(textLabel);
         }
     }
 }
@@ -226,15 +312,15 @@ void Labels::checkRepeatGroups(std::vector<Label*>& _visibleSet) const {
 void Labels::updateLabelSet(const View& _view, float _dt,
                             const std::vector<std::unique_ptr<Style>>& _styles,
                             const std::vector<std::shared_ptr<Tile>>& _tiles,
-                            std::unique_ptr<TileCache>& _cache) {
+                            std::unique_ptr<TileCache>& _cache,
+                            const MarkerManager* _markers) {
 
     // Could clear this at end of function unless debug draw is active
     m_labels.clear();
-    m_aabbs.clear();
 
-    /// Collect and update labels from visible tiles
+    /// Collect and update labels from visible tiles and markers
 
-    updateLabels(_view, _dt, _styles, _tiles, false);
+    updateLabels(_view, _dt, _styles, _tiles, false, _markers);
 
     /// Mark labels to skip transitions
 
@@ -243,119 +329,248 @@ void Labels::updateLabelSet(const View& _view, float _dt,
         m_lastZoom = _view.getZoom();
     }
 
-    /// Manage occlusions
-
-    // Update collision context size
-    m_isect2d.resize({_view.getWidth() / 256, _view.getHeight() / 256},
-                     {_view.getWidth(), _view.getHeight()});
+    m_needPlacement = true;
 
-    // Broad phase collision detection
-    for (auto* label : m_labels) {
-        m_aabbs.push_back(label->aabb());
-        m_aabbs.back().m_userData = (void*)label;
-    }
+    placeLabels(_view, _dt);
+}
 
-    m_isect2d.intersect(m_aabbs);
+void Labels::placeLabels(const View& _view, float _dt) {
 
-    // Narrow Phase, resolve conflicts
-    for (auto& pair : m_isect2d.pairs) {
-        const auto& aabb1 = m_aabbs[pair.first];
-        const auto& aabb2 = m_aabbs[pair.second];
+    glm::vec2 screenSize = glm::vec2(_view.getWidth(), _view.getHeight());
+    float dz = _view.getZoom() - std::floor(_view.getZoom());
 
-        auto l1 = static_cast<Label*>(aabb1.m_userData);
-        auto l2 = static_cast<Label*>(aabb2.m_userData);
+    /// Take the results of a finished placement
 
-        if (l1->isOccluded() || l2->isOccluded()) {
-            // One of this pair is already occluded.
-            // => conflict solved
-            continue;
+    if (m_placementRunning) {
+        std::lock_guard<std::mutex> lock(m_workerMutex);
+        if (m_jobDone) {
+            m_jobDone = false;
+            m_placementRunning = false;
+            // The previous results become the buffers of the next job
+            std::swap(m_results, m_workerJob);
         }
+    }
 
-        if (!intersect(l1->obb(), l2->obb())) { continue; }
-
-        if (l1->isProxy() != l2->isProxy()) {
-            // check first is the label belongs to a proxy tile
-            if (l1->isProxy()) {
-                l1->occlude();
-            } else {
-                l2->occlude();
-            }
-        } else if (l1->options().priority != l2->options().priority) {
-            // lower numeric priority means higher priority
-            if(l1->options().priority > l2->options().priority) {
-                l1->occlude();
+    /// Start a placement of the current labels when the worker is idle
+
+    if (m_needPlacement && !m_placementRunning) {
+        m_needPlacement = false;
+
+        auto& job = m_nextJob;
+        job.matrices = m_matrices;
+        job.screenSize = screenSize;
+        job.gridOrigin = collisionGridOrigin(_view);
+        job.zoomFract = dz;
+        job.testVisibility = !Tangram::getDebugFlag(DebugFlags::all_labels);
+
+        job.placements.clear();
+        job.placements.reserve(m_labels.size());
+
+        for (size_t i = 0; i < m_labels.size(); i++) {
+            auto* label = m_labels[i];
+            auto& options = label->options();
+
+            Placement placement;
+            placement.id = label->id();
+            placement.hash = label->hash();
+            placement.shape = label->shape();
+            placement.matrix = m_labelMatrices[i];
+            placement.priority = options.priority;
+            placement.repeatDistance = options.repeatDistance;
+            placement.repeatGroup = options.repeatGroup;
+            placement.modelDistance2 = glm::length2(label->transform().modelPosition1);
+            placement.proxy = label->isProxy();
+            placement.visible = label->visibleState();
+            placement.repeat = options.repeatDistance != 0.f && dynamic_cast<TextLabel*>(label);
+
+            if (m_projected[i]) {
+                placement.occludedLastFrame = label->occludedLastFrame();
+                placement.occluded = label->isOccluded();
             } else {
-                l2->occlude();
+                // As Label::update() would have left a sleeping label
+                placement.occludedLastFrame = label->isOccluded();
+                placement.occluded = false;
             }
-        } else if (l1->occludedLastFrame() != l2->occludedLastFrame()) {
-            // keep the one that way active previously
-            if (l1->occludedLastFrame()) {
-                l1->occlude();
-            } else {
-                l2->occlude();
+
+            job.placements.push_back(placement);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_workerMutex);
+            std::swap(m_workerJob, m_nextJob);
+            m_jobQueued = true;
+        }
+        m_workerCondition.notify_one();
+        m_placementRunning = true;
+    }
+
+    /// Apply the last placement, labels that were not part of it keep
+    /// their state until the next one
+
+    m_placed.assign(m_labels.size(), false);
+
+    for (size_t i = 0; i < m_labels.size(); i++) {
+        auto* label = m_labels[i];
+
+        auto it = m_results.index.find(label->id());
+        if (it == m_results.index.end()) { continue; }
+
+        auto& placement = m_results.placements[it->second];
+
+        // Not tested against the other labels
+        if (!placement.projected) { continue; }
+
+        if (!m_projected[i]) {
+            // Stays asleep
+            if (placement.occluded) {
+                label->occlude();
+                continue;
             }
-        } else if (l1->visibleState() != l2->visibleState()) {
-            // keep the visible one, different from occludedLastframe
-            // when one lets labels fade out.
-            // (A label is also in visibleState() when skip_transition is set)
-            if (!l1->visibleState()) {
-                l1->occlude();
-            } else {
-                l2->occlude();
+            // Free to show up again, project it for drawing
+            if (!label->update(m_matrices[m_labelMatrices[i]], screenSize, dz) ||
+                !label->canOcclude()) {
+                continue;
             }
-        } else {
-            // just so it is consistent between two instances
-            if (l1->hash() < l2->hash()) {
-                l1->occlude();
-            } else {
-                l2->occlude();
+            m_projected[i] = true;
+        }
+
+        if (placement.occluded) { label->occlude(); }
+        m_placed[i] = true;
+    }
+
+    /// Update label meshes
+
+    for (size_t i = 0; i < m_labels.size(); i++) {
+        auto* label = m_labels[i];
+
+        if (m_placed[i]) {
+            // Manage link occlusion (unified icon labels)
+            if (label->parent() && (label->parent()->isOccluded() || !label->parent()->visibleState())) {
+                label->occlude();
             }
+
+            m_needUpdate |= label->evalState(screenSize, _dt);
         }
+        label->pushTransform();
     }
 
-    /// Apply repeat groups
+    m_needUpdate |= placementPending();
+}
 
-    std::vector<Label*> repeatGroupSet;
-    for (auto* label : m_labels) {
-        if (label->isOccluded()) {
-            continue;
+glm::vec2 Labels::collisionGridOrigin(const View& _view) {
+
+    glm::dvec2 viewPosition(_view.getPosition().x, _view.getPosition().y);
+
+    // Keep the origin close enough to the view for float precision
+    if (glm::length(viewPosition - m_gridOrigin) * _view.pixelsPerMeter() > max_grid_origin_distance) {
+        m_gridOrigin = viewPosition;
+    }
+
+    glm::vec2 screenSize(_view.getWidth(), _view.getHeight());
+    glm::vec4 origin(glm::vec2(m_gridOrigin - viewPosition), 0.f, 1.f);
+
+    glm::vec2 screenOrigin = worldToScreenSpace(_view.getViewProjectionMatrix(), origin, screenSize);
+
+    // Behind the camera of a tilted view. Any other fixed point would do,
+    // labels are only re-tested when the origin jumps.
+    if (!std::isfinite(screenOrigin.x) || !std::isfinite(screenOrigin.y)) {
+        return glm::vec2(0.f);
+    }
+    return screenOrigin;
+}
+
+void Labels::resolveOcclusions(PlacementJob& _job) {
+
+    auto& placements = _job.placements;
+
+    /// Project the labels
+
+    for (auto& placement : placements) {
+        glm::vec2 screenPos;
+        float rotation;
+
+        placement.projected = Label::screenTransform(placement.shape, _job.matrices[placement.matrix],
+                                                     _job.screenSize, _job.testVisibility,
+                                                     screenPos, rotation);
+        if (!placement.projected) { continue; }
+
+        placement.obb = Label::screenBox(placement.shape, screenPos, rotation, _job.zoomFract);
+        placement.aabb = placement.obb.getExtent();
+        placement.center = placement.obb.getCentroid();
+    }
+
+    // Sort by priority: a label that is not occluded by one that comes
+    // before occludes all it collides with
+    std::stable_sort(placements.begin(), placements.end(),
+                     [](auto& l1, auto& l2) {
+        if (l1.proxy != l2.proxy) {
+            // labels of proxy tiles come last
+            return !l1.proxy;
         }
-        if (label->options().repeatDistance == 0.f) {
-            continue;
+        if (l1.priority != l2.priority) {
+            // lower numeric priority means higher priority
+            return l1.priority < l2.priority;
         }
-        if (!dynamic_cast<TextLabel*>(label)) {
-            continue;
+        if (l1.occludedLastFrame != l2.occludedLastFrame) {
+            // keep the one that was active previously
+            return !l1.occludedLastFrame;
+        }
+        if (l1.visible != l2.visible) {
+            // keep the visible one, different from occludedLastframe
+            // when one lets labels fade out.
+            // (A label is also in visibleState() when skip_transition is set)
+            return l1.visible;
         }
+        // just so it is consistent between two instances
+        return l1.hash > l2.hash;
+    });
 
-        repeatGroupSet.push_back(label);
-    }
+    /// Manage occlusions
 
-    // Ensure the labels are always treated in the same order in the visible set
-    std::sort(repeatGroupSet.begin(), repeatGroupSet.end(),
-              [](auto* _a, auto* _b) {
-        return glm::length2(_a->transform().modelPosition1) <
-               glm::length2(_b->transform().modelPosition1);
-    });
+    // Broad phase collision detection, only labels whose boxes moved
+    // relative to the map since the last placement are re-tested
+    m_collisions.setOrigin(_job.gridOrigin);
 
-    checkRepeatGroups(repeatGroupSet);
+    for (size_t i = 0; i < placements.size(); i++) {
+        auto& placement = placements[i];
+        if (!placement.projected) { continue; }
 
+        m_collisions.update(placement.id, placement.aabb, placement.obb, i);
+    }
 
-    /// Update label meshes
+    m_collisions.commit();
 
-    glm::vec2 screenSize = glm::vec2(_view.getWidth(), _view.getHeight());
+    // Narrow Phase, resolve conflicts in priority order
+    for (auto& placement : placements) {
+        // Occluded by a label with higher priority, or still fading out
+        if (!placement.projected || placement.occluded) { continue; }
 
-    for (auto* label : m_labels) {
+        m_collisions.forEachCollision(placement.id, [&](uint32_t _other) {
+            placements[_other].occluded = true;
+        });
+    }
 
-        // Manage link occlusion (unified icon labels)
-        if (label->parent() && (label->parent()->isOccluded() || !label->parent()->visibleState())) {
-            label->occlude();
+    /// Apply repeat groups
+
+    m_repeatGroupSet.clear();
+    for (auto& placement : placements) {
+        if (!placement.projected || placement.occluded || !placement.repeat) {
+            continue;
         }
+        m_repeatGroupSet.push_back(&placement);
+    }
 
-        m_needUpdate |= label->evalState(screenSize, _dt);
-        label->pushTransform();
+    checkRepeatGroups(m_repeatGroupSet);
+
+    /// Index the results for the main thread
+
+    _job.index.clear();
+    for (size_t i = 0; i < placements.size(); i++) {
+        _job.index[placements[i].id] = i;
     }
 }
 
+
 const std::vector<TouchItem>& Labels::getFeaturesAtPoint(const View& _view, float _dt,
                                                          const std::vector<std::unique_ptr<Style>>& _styles,
                                                          const std::vector<std::shared_ptr<Tile>>& _tiles,
@@ -1,14 +1,19 @@
 #pragma once
 
 #include "label.h"
+#include "collisionGrid.h"
 #include "spriteLabel.h"
 #include "tile/tileID.h"
 #include "data/properties.h"
 #include "isect2d.h"
 #include "glm_vec.h" // for isect2d.h
+#include "glm/vec2.hpp"
 
+#include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 #include <map>
 #include <set>
@@ -16,6 +21,7 @@
 namespace Tangram {
 
 class FontContext;
+class MarkerManager;
 class Tile;
 class View;
 class Style;
@@ -31,11 +37,21 @@ public:
 
     void drawDebug(const View& _view);
 
+    /* Update labels for a changed view, tile set or markers. Labels are
+     * projected and their collisions resolved on a long-lived worker thread,
+     * from a snapshot of their shapes. The results are applied by the first
+     * update after the placement finished. Labels of @_markers are placed
+     * together with those of the tiles. */
     void updateLabelSet(const View& _view, float _dt, const std::vector<std::unique_ptr<Style>>& _styles,
-                        const std::vector<std::shared_ptr<Tile>>& _tiles, std::unique_ptr<TileCache>& _cache);
+                        const std::vector<std::shared_ptr<Tile>>& _tiles, std::unique_ptr<TileCache>& _cache,
+                        const MarkerManager* _markers = nullptr);
 
+    /* Update label transitions. Applies the results of a pending placement
+     * when @_onlyTransitions is set, otherwise collects the occludable labels
+     * for updateLabelSet(). */
     void updateLabels(const View& _view, float _dt, const std::vector<std::unique_ptr<Style>>& _styles,
-                      const std::vector<std::shared_ptr<Tile>>& _tiles, bool _onlyTransitions = true);
+                      const std::vector<std::shared_ptr<Tile>>& _tiles, bool _onlyTransitions = true,
+                      const MarkerManager* _markers = nullptr);
 
     const std::vector<TouchItem>& getFeaturesAtPoint(const View& _view, float _dt,
                                                      const std::vector<std::unique_ptr<Style>>& _styles,
@@ -44,12 +60,60 @@ public:
 
     bool needUpdate() const { return m_needUpdate; }
 
+    // Whether a placement is running or postponed until the running one finished
+    bool placementPending() const { return m_needPlacement || m_placementRunning; }
+
 private:
 
     using AABB = isect2d::AABB<glm::vec2>;
     using OBB = isect2d::OBB<glm::vec2>;
-    using CollisionPairs = std::vector<isect2d::ISect2D<glm::vec2>::Pair>;
 
+    // Label state used for placement, copied so that the placement can run
+    // while the labels are updated on the main thread
+    struct Placement {
+        uint64_t id;
+        size_t hash;
+        Label::Shape shape;
+        // Index of the model-view-projection matrix in PlacementJob
+        uint32_t matrix;
+        float priority;
+        float repeatDistance;
+        size_t repeatGroup;
+        float modelDistance2;
+        bool proxy;
+        bool occludedLastFrame;
+        bool visible;
+        bool repeat;
+        // Projected by the worker
+        AABB aabb;
+        OBB obb;
+        glm::vec2 center;
+        // Whether the label rules were satisfied, otherwise the label was not placed
+        bool projected;
+        // Result of the placement
+        bool occluded;
+    };
+
+    struct PlacementJob {
+        std::vector<Placement> placements;
+        std::vector<glm::mat4> matrices;
+        glm::vec2 screenSize;
+        glm::vec2 gridOrigin;
+        float zoomFract;
+        bool testVisibility;
+        // Position of each label ID in placements, built by the worker
+        std::unordered_map<uint64_t, uint32_t> index;
+    };
+
+    void placeLabels(const View& _view, float _dt);
+
+    void runPlacementWorker();
+
+    // Screen position of the map point the collision grid is anchored to
+    glm::vec2 collisionGridOrigin(const View& _view);
+
+    // Runs on the placement worker
+    void resolveOcclusions(PlacementJob& _job);
 
     void skipTransitions(const std::vector<std::unique_ptr<Style>>& _styles,
                          const std::vector<std::shared_ptr<Tile>>& _tiles,
@@ -57,7 +121,7 @@ private:
 
     void skipTransitions(const std::vector<const Style*>& _styles, Tile& _tile, Tile& _proxy) const;
 
-    void checkRepeatGroups(std::vector<Label*>& _visibleSet) const;
+    void checkRepeatGroups(std::vector<Placement*>& _visibleSet);
 
     int LODDiscardFunc(float _maxZoom, float _zoom);
 
@@ -65,13 +129,49 @@ private:
 
     // temporary data used in update()
     std::vector<Label*> m_labels;
-    std::vector<AABB> m_aabbs;
-
-    isect2d::ISect2D<glm::vec2> m_isect2d;
+    std::vector<bool> m_placed;
+    // Model-view-projection matrices of the tiles and markers, and the
+    // matrix of each label in m_labels
+    std::vector<glm::mat4> m_matrices;
+    std::vector<uint32_t> m_labelMatrices;
+    // Whether each label in m_labels was projected in this update. Labels
+    // that sleep are not drawn, they are only projected by the worker.
+    std::vector<bool> m_projected;
+
+    // Next placement, filled by placeLabels()
+    PlacementJob m_nextJob;
+    // Results of the last finished placement
+    PlacementJob m_results;
+
+    // Set by updateLabelSet(), cleared when the next placement starts
+    bool m_needPlacement;
+    // A placement was handed to the worker and its results not taken yet
+    bool m_placementRunning;
+
+    // Map position in meters of the collision grid origin
+    glm::dvec2 m_gridOrigin;
+
+    // Only used by the placement worker. The collision grid is kept across
+    // updates so that only labels that moved are re-tested.
+    CollisionGrid m_collisions;
+    std::vector<Placement*> m_repeatGroupSet;
+    std::vector<Placement*> m_repeatGroup;
 
     std::vector<TouchItem> m_touchItems;
 
     float m_lastZoom;
+
+    // Owned by the worker from when it is queued until m_jobDone is set
+    PlacementJob m_workerJob;
+    // Guarded by m_workerMutex
+    bool m_jobQueued;
+    bool m_jobDone;
+    bool m_stopWorker;
+    std::mutex m_workerMutex;
+    std::condition_variable m_workerCondition;
+
+    // Declared last so that the worker starts after the other members
+    std::thread m_worker;
 };
 
 }
@@ -45,26 +45,11 @@ glm::vec2 SpriteLabel::anchor() const {
     return anchor;
 }
 
-void SpriteLabel::updateBBoxes(float _zoomFract) {
+void SpriteLabel::shapeBox(Shape& _shape) const {
     glm::vec2 halfSize = m_dim * 0.5f;
-    glm::vec2 sp = m_transform.state.screenPos;
-    glm::vec2 dim = m_dim + glm::vec2(m_extrudeScale * 2.f * _zoomFract);
-    m_obb = OBB(sp.x + halfSize.x, sp.y - halfSize.y, m_transform.state.rotation, dim.x, dim.y);
-    m_aabb = m_obb.getExtent();
-}
-
-void SpriteLabel::align(glm::vec2& _screenPosition, const glm::vec2& _ap1, const glm::vec2& _ap2) {
-
-    switch (m_type) {
-        case Type::debug:
-        case Type::point:
-            _screenPosition += anchor();
-            break;
-        case Type::line:
-            LOGW("Line sprite labels not implemented yet");
-            break;
-    }
-
+    _shape.boxOffset = glm::vec2(halfSize.x, -halfSize.y);
+    _shape.boxSize = m_dim;
+    _shape.boxExtrude = m_extrudeScale;
 }
 
 void SpriteLabel::pushTransform() {
@@ -34,8 +34,7 @@ public:
                 float _extrudeScale, LabelProperty::Anchor _anchor,
                 SpriteLabels& _labels, size_t _labelsPos);
 
-    void updateBBoxes(float _zoomFract) override;
-    void align(glm::vec2& _screenPosition, const glm::vec2& _ap1, const glm::vec2& _ap2) override;
+    void shapeBox(Shape& _shape) const override;
 
     void pushTransform() override;
 
@@ -27,31 +27,10 @@ void TextLabel::applyAnchor(const glm::vec2& _dimension, const glm::vec2& _origi
     m_anchor = _origin + LabelProperty::anchorDirection(_anchor) * _dimension * 0.5f;
 }
 
-void TextLabel::updateBBoxes(float _zoomFract) {
-
-    m_obb = OBB(m_transform.state.screenPos.x,
-                m_transform.state.screenPos.y,
-                m_transform.state.rotation,
-                m_dim.x - m_options.buffer,
-                m_dim.y - m_options.buffer);
-
-    m_aabb = m_obb.getExtent();
-}
-
-void TextLabel::align(glm::vec2& _screenPosition, const glm::vec2& _ap1, const glm::vec2& _ap2) {
-
-    switch (m_type) {
-        case Type::debug:
-        case Type::point: {
-            _screenPosition += m_anchor;
-            break;
-        }
-        case Type::line: {
-            // anchor at line center
-            _screenPosition = (_ap1 + _ap2) * 0.5f;
-            break;
-        }
-    }
+void TextLabel::shapeBox(Shape& _shape) const {
+    _shape.boxOffset = glm::vec2(0.f);
+    _shape.boxSize = m_dim - m_options.buffer;
+    _shape.boxExtrude = 0.f;
 }
 
 void TextLabel::pushTransform() {
@@ -49,10 +49,8 @@ public:
               LabelProperty::Anchor _anchor, TextLabel::FontVertexAttributes _attrib,
               glm::vec2 _dim, TextLabels& _labels, Range _vertexRange);
 
-    void updateBBoxes(float _zoomFract) override;
-
 protected:
-    void align(glm::vec2& _screenPosition, const glm::vec2& _ap1, const glm::vec2& _ap2) override;
+    void shapeBox(Shape& _shape) const override;
 
     void pushTransform() override;
 
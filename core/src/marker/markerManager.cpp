@@ -0,0 +1,259 @@
+#include "markerManager.h"
+
+#include "platform.h"
+#include "scene/scene.h"
+#include "style/pointStyle.h"
+#include "view/view.h"
+
+#include <cmath>
+
+namespace Tangram {
+
+// Maximum distance of the label origin from the view in pixels. Float model
+// positions within this distance are precise to a hundredth of a pixel.
+static const double max_origin_distance = 100000;
+
+MarkerManager::MarkerManager() : m_origin(0.0), m_modelMatrix(1.0) {}
+
+MarkerManager::~MarkerManager() {}
+
+void MarkerManager::setScene(std::shared_ptr<Scene> _scene) {
+    m_scene = _scene;
+    m_sceneChanged = true;
+    m_changed = true;
+}
+
+MarkerManager::Marker* MarkerManager::find(MarkerID _id) {
+    auto it = m_index.find(_id);
+    if (it == m_index.end()) { return nullptr; }
+    return &m_markers[it->second];
+}
+
+MarkerID MarkerManager::add() {
+    MarkerID id = m_nextId++;
+
+    m_index.emplace(id, m_markers.size());
+    m_markers.emplace_back();
+    m_markers.back().id = id;
+
+    m_restyle.push_back(id);
+    m_changed = true;
+
+    return id;
+}
+
+bool MarkerManager::remove(MarkerID _id) {
+    auto it = m_index.find(_id);
+    if (it == m_index.end()) { return false; }
+
+    size_t index = it->second;
+    m_index.erase(it);
+
+    // The label is deleted on the next update
+    m_removed.push_back(std::move(m_markers[index]));
+
+    if (index != m_markers.size() - 1) {
+        m_markers[index] = std::move(m_markers.back());
+        m_index[m_markers[index].id] = index;
+    }
+    m_markers.pop_back();
+
+    m_labelsChanged = true;
+    m_changed = true;
+    return true;
+}
+
+bool MarkerManager::setPosition(MarkerID _id, glm::dvec2 _meters) {
+    auto* marker = find(_id);
+    if (!marker) { return false; }
+
+    marker->position = _meters;
+
+    if (!marker->hasPosition) {
+        marker->hasPosition = true;
+        m_labelsChanged = true;
+    }
+    if (marker->label) {
+        marker->label->setModelPosition(glm::vec2(_meters - m_origin));
+    }
+
+    m_changed = true;
+    return true;
+}
+
+bool MarkerManager::setStyle(MarkerID _id, const MarkerStyle& _style) {
+    auto* marker = find(_id);
+    if (!marker) { return false; }
+
+    marker->style = _style;
+
+    if (!marker->restyle) {
+        marker->restyle = true;
+        m_restyle.push_back(_id);
+    }
+
+    m_changed = true;
+    return true;
+}
+
+bool MarkerManager::setVisible(MarkerID _id, bool _visible) {
+    auto* marker = find(_id);
+    if (!marker) { return false; }
+
+    if (marker->visible == _visible) { return true; }
+    marker->visible = _visible;
+
+    // Wait for the next placement instead of showing it where it was hidden
+    if (_visible && marker->label) { marker->label->resetState(); }
+
+    m_labelsChanged = true;
+    m_changed = true;
+    return true;
+}
+
+void MarkerManager::releaseLabel(Marker& _marker) {
+    if (!_marker.label) { return; }
+
+    _marker.label.reset();
+
+    if (_marker.styleId < m_styleQuads.size()) {
+        m_styleQuads[_marker.styleId].freeSlots.push_back(_marker.slot);
+    }
+}
+
+void MarkerManager::buildLabel(Marker& _marker) {
+
+    releaseLabel(_marker);
+
+    if (!m_scene) { return; }
+
+    auto& markerStyle = _marker.style;
+
+    auto* style = dynamic_cast<const PointStyle*>(m_scene->findStyle(markerStyle.style));
+    if (!style) {
+        LOGW("Marker style '%s' is not a point style", markerStyle.style.c_str());
+        return;
+    }
+
+    PointStyle::Parameters params;
+    params.sprite = markerStyle.sprite;
+    params.color = markerStyle.color;
+    params.labelOptions.priority = markerStyle.priority;
+    params.labelOptions.collide = markerStyle.collide;
+
+    if (markerStyle.width > 0.f) {
+        params.size = glm::vec2(markerStyle.width,
+                                markerStyle.height > 0.f ? markerStyle.height : markerStyle.width);
+    } else {
+        params.size = glm::vec2(NAN, NAN);
+    }
+
+    glm::vec4 uvQuad;
+    if (!style->getUVQuad(params, uvQuad)) {
+        LOGW("Marker sprite '%s' not found in style '%s'", markerStyle.sprite.c_str(),
+             markerStyle.style.c_str());
+        return;
+    }
+
+    std::hash<PointStyle::Parameters> hash;
+    params.labelOptions.paramHash = hash(params);
+
+    uint32_t styleId = style->getID();
+    if (styleId >= m_styleQuads.size()) {
+        m_styleQuads.resize(styleId + 1);
+    }
+
+    auto& styleQuads = m_styleQuads[styleId];
+    if (!styleQuads.quads) {
+        styleQuads.quads = std::make_unique<SpriteLabels>(*style);
+    }
+
+    auto& quads = styleQuads.quads->quads;
+    size_t slot;
+
+    if (styleQuads.freeSlots.empty()) {
+        slot = quads.size();
+        quads.emplace_back();
+    } else {
+        slot = styleQuads.freeSlots.back();
+        styleQuads.freeSlots.pop_back();
+    }
+    quads[slot] = PointStyle::spriteQuad(uvQuad, params);
+
+    _marker.styleId = styleId;
+    _marker.slot = slot;
+    _marker.label = std::make_unique<SpriteLabel>(Label::Transform{glm::vec2(_marker.position - m_origin)},
+                                                  params.size,
+                                                  params.labelOptions,
+                                                  params.extrudeScale,
+                                                  params.anchor,
+                                                  *styleQuads.quads,
+                                                  slot);
+}
+
+bool MarkerManager::update(const View& _view) {
+
+    for (auto& marker : m_removed) {
+        releaseLabel(marker);
+    }
+    m_removed.clear();
+
+    if (m_sceneChanged) {
+        m_sceneChanged = false;
+
+        // Labels refer to the quads of the styles of the previous scene
+        for (auto& marker : m_markers) {
+            releaseLabel(marker);
+        }
+        m_styleQuads.clear();
+
+        m_restyle.clear();
+        for (auto& marker : m_markers) {
+            marker.restyle = true;
+            m_restyle.push_back(marker.id);
+        }
+    }
+
+    glm::dvec2 viewPosition(_view.getPosition().x, _view.getPosition().y);
+
+    if (glm::length(viewPosition - m_origin) * _view.pixelsPerMeter() > max_origin_distance) {
+        m_origin = viewPosition;
+
+        for (auto& marker : m_markers) {
+            if (marker.label) {
+                marker.label->setModelPosition(glm::vec2(marker.position - m_origin));
+            }
+        }
+    }
+
+    for (MarkerID id : m_restyle) {
+        auto* marker = find(id);
+        if (!marker || !marker->restyle) { continue; }
+
+        marker->restyle = false;
+        buildLabel(*marker);
+        m_labelsChanged = true;
+    }
+    m_restyle.clear();
+
+    if (m_labelsChanged) {
+        m_labelsChanged = false;
+
+        m_labels.clear();
+        for (auto& marker : m_markers) {
+            if (marker.label && marker.visible && marker.hasPosition) {
+                m_labels.push_back(marker.label.get());
+            }
+        }
+    }
+
+    m_modelMatrix[3][0] = m_origin.x - viewPosition.x;
+    m_modelMatrix[3][1] = m_origin.y - viewPosition.y;
+
+    bool changed = m_changed;
+    m_changed = false;
+
+    return changed;
+}
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "tangram.h"
+#include "labels/spriteLabel.h"
+
+#include "glm/vec2.hpp"
+#include "glm/mat4x4.hpp"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Tangram {
+
+class PointStyle;
+class Scene;
+class View;
+
+/* Markers drawn as sprite labels of the point styles of the scene
+ *
+ * The quads of all markers of a point style are kept in one SpriteLabels
+ * container and their labels are pushed into the dynamic mesh of the style
+ * together with the labels of the tiles, so that markers are drawn in the
+ * same batch and take part in label placement.
+ *
+ * Setters only record the change. Labels are created, restyled and deleted
+ * in update(), between label updates, so that Labels never holds a pointer
+ * to a deleted marker label. Moving a marker only sets the position of its
+ * label, the cost of an update depends on the number of changed markers.
+ */
+class MarkerManager {
+
+public:
+
+    MarkerManager();
+    ~MarkerManager();
+
+    /* Use the point styles of @_scene, markers are styled again on the next
+     * update() */
+    void setScene(std::shared_ptr<Scene> _scene);
+
+    MarkerID add();
+    bool remove(MarkerID _id);
+
+    /* Set the position of a marker in projection meters */
+    bool setPosition(MarkerID _id, glm::dvec2 _meters);
+    bool setStyle(MarkerID _id, const MarkerStyle& _style);
+    bool setVisible(MarkerID _id, bool _visible);
+
+    /* Apply the pending changes and move the model origin of the markers
+     * along with @_view. Returns true when markers changed since the last
+     * update, i.e. labels have to be placed again. */
+    bool update(const View& _view);
+
+    // Whether there are changes for the next update()
+    bool hasChanges() const { return m_changed; }
+
+    // Labels of the visible markers, valid until the next update()
+    const std::vector<Label*>& labels() const { return m_labels; }
+
+    // Transforms the model positions of the labels into view space
+    const glm::mat4& modelMatrix() const { return m_modelMatrix; }
+
+    size_t size() const { return m_markers.size(); }
+
+private:
+
+    struct Marker {
+        MarkerID id;
+        glm::dvec2 position;
+        MarkerStyle style;
+        bool hasPosition = false;
+        bool visible = true;
+        // Style changed since the label was created
+        bool restyle = true;
+
+        // Null when the marker has no valid style
+        std::unique_ptr<SpriteLabel> label;
+        // Point style and quad slot of the label
+        uint32_t styleId = 0;
+        size_t slot = 0;
+    };
+
+    // Quads of the markers of one point style
+    struct StyleQuads {
+        std::unique_ptr<SpriteLabels> quads;
+        std::vector<size_t> freeSlots;
+    };
+
+    Marker* find(MarkerID _id);
+
+    void buildLabel(Marker& _marker);
+    void releaseLabel(Marker& _marker);
+
+    std::shared_ptr<Scene> m_scene;
+    bool m_sceneChanged = false;
+
+    // Markers are stored densely, removed ones are swapped with the last
+    std::vector<Marker> m_markers;
+    std::unordered_map<MarkerID, size_t> m_index;
+    MarkerID m_nextId = 1;
+
+    // Markers removed since the last update
+    std::vector<Marker> m_removed;
+
+    // Markers that have to be styled on the next update
+    std::vector<MarkerID> m_restyle;
+
+    // By point style ID
+    std::vector<StyleQuads> m_styleQuads;
+
+    std::vector<Label*> m_labels;
+    bool m_labelsChanged = false;
+
+    bool m_changed = false;
+
+    // Labels are positioned relative to this origin, in projection meters,
+    // which follows the view so that positions near the view stay precise
+    glm::dvec2 m_origin;
+    glm::mat4 m_modelMatrix;
+};
+
+}
@@ -1,6 +1,7 @@
 #include "drawRule.h"
 
 #include "tile/tileBuilder.h"
+#include "data/tileData.h"
 #include "scene/scene.h"
 #include "scene/sceneLayer.h"
 #include "scene/stops.h"
@@ -11,6 +12,7 @@
 #include "util/hash.h"
 
 #include <algorithm>
+#include <chrono>
 
 namespace Tangram {
 
@@ -115,6 +117,35 @@ void DrawRule::logGetError(StyleParamKey _expectedKey, const StyleParam& _param)
     LOGE("wrong type '%d'for StyleParam '%d'", _param.value.which(), _expectedKey);
 }
 
+namespace {
+
+size_t hashValue(const Value& _value) {
+    if (_value.is<std::string>()) { return std::hash<std::string>()(_value.get<std::string>()); }
+    if (_value.is<double>()) { return std::hash<double>()(_value.get<double>()); }
+    return 0;
+}
+
+bool sameValue(const Value& _a, const Value& _b) {
+    if (_a.is<std::string>()) {
+        return _b.is<std::string>() && _a.get<std::string>() == _b.get<std::string>();
+    }
+    if (_a.is<double>()) {
+        return _b.is<double>() && _a.get<double>() == _b.get<double>();
+    }
+    return _b.is<none_type>();
+}
+
+double seconds(std::chrono::steady_clock::time_point _start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+}
+
+}
+
+void DrawRuleMergeSet::clearCache() {
+    m_cache.clear();
+    m_cacheStats = CacheStats();
+}
+
 bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
 
     _ctx.setFeature(_feature);
@@ -126,8 +157,61 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
         return false;
     }
 
+    if (!_layer.cacheable()) {
+        return matchLayers(_feature, _layer, _ctx);
+    }
+
+    std::chrono::steady_clock::time_point start;
+    if (m_measureTime) { start = std::chrono::steady_clock::now(); }
+
+    const auto& keys = _layer.filterKeys();
+
+    size_t hash = std::hash<const SceneLayer*>()(&_layer);
+    hash_combine(hash, int(_feature.geometryType));
+    for (uint32_t key : keys) {
+        hash_combine(hash, hashValue(_feature.props.getById(key)));
+    }
+
+    auto it = m_cache.find(hash);
+    if (it != m_cache.end()) {
+        const auto& entry = it->second;
+
+        bool equal = entry.layer == &_layer &&
+            entry.geometryType == int(_feature.geometryType);
+
+        for (size_t i = 0; equal && i < keys.size(); i++) {
+            equal = sameValue(entry.values[i], _feature.props.getById(keys[i]));
+        }
+
+        if (equal) {
+            m_matchedRules = entry.rules;
+            m_cacheStats.hits++;
+            if (m_measureTime) { m_cacheStats.hitTime += seconds(start); }
+            return entry.matched;
+        }
+    }
+
+    bool matched = matchLayers(_feature, _layer, _ctx);
+
+    if (it == m_cache.end() && m_cache.size() < MAX_CACHE_ENTRIES) {
+        CacheEntry entry{ &_layer, int(_feature.geometryType), {}, m_matchedRules, matched };
+        entry.values.reserve(keys.size());
+        for (uint32_t key : keys) {
+            entry.values.push_back(_feature.props.getById(key));
+        }
+        m_cache.emplace(hash, std::move(entry));
+    }
+
+    m_cacheStats.misses++;
+    if (m_measureTime) { m_cacheStats.missTime += seconds(start); }
+
+    return matched;
+}
+
+bool DrawRuleMergeSet::matchLayers(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx) {
+
     // If the first filter doesn't match, return immediately
-    if (!_layer.filter().eval(_feature, _ctx)) { return false; }
+    if (!_layer.filterProgram().eval(_feature, _ctx)) { return false; }
 
     m_queuedLayers.push_back(&_layer);
 
@@ -148,7 +232,7 @@ bool DrawRuleMergeSet::match(const Feature& _feature, const SceneLayer& _layer,
                 continue;
             }
 
-            if (sublayer.filter().eval(_feature, _ctx)) {
+            if (sublayer.filterProgram().eval(_feature, _ctx)) {
                 m_queuedLayers.push_back(&sublayer);
             }
         }
@@ -173,6 +257,10 @@ void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
             continue;
         }
 
+        // Skip rules whose styles are built in another stage
+        bool buildStyle = _builder.isBuilding(*style);
+        if (!buildStyle && !rule.findParameter(StyleParamKey::outline_style)) { continue; }
+
         bool visible;
         if (rule.get(StyleParamKey::visible, visible) && !visible) {
             continue;
@@ -221,7 +309,7 @@ void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
                 auto* outlineStyle = _builder.getStyleBuilder(styleName);
                 if (!outlineStyle) {
                     LOGN("Invalid style %s", styleName.c_str());
-                } else {
+                } else if (_builder.isBuilding(*outlineStyle)) {
                     rule.isOutlineOnly = true;
                     outlineStyle->addFeature(_feature, rule);
                     rule.isOutlineOnly = false;
@@ -229,7 +317,9 @@ void DrawRuleMergeSet::apply(const Feature& _feature, const SceneLayer& _layer,
             }
 
             // build feature with style
-            style->addFeature(_feature, rule);
+            if (buildStyle) {
+                style->addFeature(_feature, rule);
+            }
         }
     }
 }
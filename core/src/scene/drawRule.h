@@ -5,6 +5,7 @@
 #include <vector>
 #include <set>
 #include <bitset>
+#include <unordered_map>
 
 namespace Tangram {
 
@@ -130,7 +131,48 @@ public:
 
     auto& matchedRules() { return m_matchedRules; }
 
+    struct CacheStats {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        // Time spent in matching, in seconds. Only measured with setMeasureTime()
+        double missTime = 0;
+        double hitTime = 0;
+
+        // Estimated time that cache hits saved
+        double savedTime() const {
+            return misses > 0 ? hits * (missTime / misses) - hitTime : 0;
+        }
+    };
+
+    /* Drop memoized matches, must be called when the keyword zoom changes
+     * (i.e. for each tile). Also resets the cache stats. */
+    void clearCache();
+
+    const CacheStats& cacheStats() const { return m_cacheStats; }
+
+    void setMeasureTime(bool _measure) { m_measureTime = _measure; }
+
 private:
+
+    // Evaluate the filters of @_layer and its sublayers, uncached
+    bool matchLayers(const Feature& _feature, const SceneLayer& _layer, StyleContext& _ctx);
+
+    // Matched and merged rules for features that have the same values
+    // for the filter keys of a layer
+    struct CacheEntry {
+        const SceneLayer* layer;
+        int geometryType;
+        std::vector<Value> values;
+        std::vector<DrawRule> rules;
+        bool matched;
+    };
+
+    static const size_t MAX_CACHE_ENTRIES = 256;
+
+    std::unordered_map<size_t, CacheEntry> m_cache;
+    CacheStats m_cacheStats;
+    bool m_measureTime = false;
+
     // Reusable containers 'matchedRules' and 'queuedLayers'
     std::vector<DrawRule> m_matchedRules;
     std::vector<const SceneLayer*> m_queuedLayers;
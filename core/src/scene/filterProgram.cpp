@@ -0,0 +1,193 @@
+#include "filterProgram.h"
+
+#include "data/propertyKeys.h"
+#include "data/tileData.h"
+#include "scene/styleContext.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Tangram {
+
+namespace {
+
+// Same semantics as the matchers in filters.cpp
+bool equal(const Value& _property, const Value& _value) {
+    if (_property.is<std::string>()) {
+        return _value.is<std::string>() &&
+            _property.get<std::string>() == _value.get<std::string>();
+    }
+    if (_property.is<double>()) {
+        if (!_value.is<double>()) { return false; }
+        double a = _property.get<double>();
+        double b = _value.get<double>();
+        return a == b || std::fabs(a - b) <= std::numeric_limits<double>::epsilon();
+    }
+    return false;
+}
+
+}
+
+FilterProgram::FilterProgram(const Filter& _filter) {
+    compile(_filter);
+
+    if (m_code.size() == 1 && m_code[0].op == Op::pass) {
+        m_code.clear();
+    }
+
+    for (auto& ins : m_code) {
+        switch (ins.op) {
+        case Op::existence:
+            m_keys.push_back(ins.key);
+            break;
+        case Op::equality:
+        case Op::range:
+            if (ins.keyword == FilterKeyword::undefined) { m_keys.push_back(ins.key); }
+            break;
+        case Op::function:
+            m_hasFunction = true;
+            break;
+        default:
+            break;
+        }
+    }
+    std::sort(m_keys.begin(), m_keys.end());
+    m_keys.erase(std::unique(m_keys.begin(), m_keys.end()), m_keys.end());
+}
+
+void FilterProgram::compile(const Filter& _filter) {
+
+    Instruction ins{};
+    ins.keyword = FilterKeyword::undefined;
+
+    const auto& data = _filter.data;
+
+    switch (data.get_type_index()) {
+    case Filter::Data::type<Filter::OperatorAny>::value:
+    case Filter::Data::type<Filter::OperatorAll>::value:
+    case Filter::Data::type<Filter::OperatorNone>::value: {
+        ins.op = data.is<Filter::OperatorAny>() ? Op::any
+            : data.is<Filter::OperatorAll>() ? Op::all
+            : Op::none;
+
+        size_t pos = m_code.size();
+        m_code.push_back(ins);
+        // Operands are already sorted by cost
+        for (const auto& operand : _filter.operands()) {
+            compile(operand);
+        }
+        m_code[pos].arg = m_code.size();
+        return;
+    }
+    case Filter::Data::type<Filter::Existence>::value: {
+        auto& f = data.get<Filter::Existence>();
+        ins.op = Op::existence;
+        ins.key = PropertyKeys::intern(f.key);
+        ins.exists = f.exists;
+        break;
+    }
+    case Filter::Data::type<Filter::EqualitySet>::value: {
+        auto& f = data.get<Filter::EqualitySet>();
+        ins.op = Op::equality;
+        ins.keyword = f.keyword;
+        ins.key = PropertyKeys::intern(f.key);
+        ins.arg = m_values.size();
+        ins.count = f.values.size();
+        m_values.insert(m_values.end(), f.values.begin(), f.values.end());
+        break;
+    }
+    case Filter::Data::type<Filter::Equality>::value: {
+        auto& f = data.get<Filter::Equality>();
+        ins.op = Op::equality;
+        ins.keyword = f.keyword;
+        ins.key = PropertyKeys::intern(f.key);
+        ins.arg = m_values.size();
+        ins.count = 1;
+        m_values.push_back(f.value);
+        break;
+    }
+    case Filter::Data::type<Filter::Range>::value: {
+        auto& f = data.get<Filter::Range>();
+        ins.op = Op::range;
+        ins.keyword = f.keyword;
+        ins.key = PropertyKeys::intern(f.key);
+        ins.min = f.min;
+        ins.max = f.max;
+        break;
+    }
+    case Filter::Data::type<Filter::Function>::value:
+        ins.op = Op::function;
+        ins.key = data.get<Filter::Function>().id;
+        break;
+
+    default:
+        ins.op = Op::pass;
+        break;
+    }
+
+    m_code.push_back(ins);
+}
+
+bool FilterProgram::eval(const Feature& _feature, StyleContext& _ctx) const {
+    if (m_code.empty()) { return true; }
+
+    size_t pc = 0;
+    return exec(pc, _feature, _ctx);
+}
+
+bool FilterProgram::exec(size_t& _pc, const Feature& _feature, StyleContext& _ctx) const {
+
+    const auto& ins = m_code[_pc++];
+
+    switch (ins.op) {
+    case Op::pass:
+        return true;
+
+    case Op::any:
+        while (_pc < ins.arg) {
+            if (exec(_pc, _feature, _ctx)) { _pc = ins.arg; return true; }
+        }
+        return false;
+
+    case Op::all:
+        while (_pc < ins.arg) {
+            if (!exec(_pc, _feature, _ctx)) { _pc = ins.arg; return false; }
+        }
+        return true;
+
+    case Op::none:
+        while (_pc < ins.arg) {
+            if (exec(_pc, _feature, _ctx)) { _pc = ins.arg; return false; }
+        }
+        return true;
+
+    case Op::existence:
+        return ins.exists == !_feature.props.getById(ins.key).is<none_type>();
+
+    case Op::equality: {
+        auto& value = (ins.keyword == FilterKeyword::undefined)
+            ? _feature.props.getById(ins.key)
+            : _ctx.getKeyword(ins.keyword);
+
+        for (uint32_t i = ins.arg, end = ins.arg + ins.count; i < end; i++) {
+            if (equal(value, m_values[i])) { return true; }
+        }
+        return false;
+    }
+    case Op::range: {
+        auto& value = (ins.keyword == FilterKeyword::undefined)
+            ? _feature.props.getById(ins.key)
+            : _ctx.getKeyword(ins.keyword);
+
+        if (!value.is<double>()) { return false; }
+        double num = value.get<double>();
+        return num >= ins.min && num < ins.max;
+    }
+    case Op::function:
+        return _ctx.evalFilter(ins.key);
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "scene/filters.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+class StyleContext;
+struct Feature;
+
+/* Flat form of a Filter for evaluation
+ *
+ * The Filter tree is compiled into a vector of instructions in depth-first
+ * order. Operators store the end of their operands so that evaluation can
+ * skip over them when the result is known. Property keys are interned, see
+ * PropertyKeys, so that properties are found by integer compare.
+ */
+class FilterProgram {
+
+public:
+
+    // Program that passes everything
+    FilterProgram() {}
+
+    explicit FilterProgram(const Filter& _filter);
+
+    bool eval(const Feature& _feature, StyleContext& _ctx) const;
+
+    size_t size() const { return m_code.size(); }
+
+    // Interned property keys that the filter reads
+    const std::vector<uint32_t>& keys() const { return m_keys; }
+
+    // Whether the filter calls JS functions, which may read anything
+    bool hasFunction() const { return m_hasFunction; }
+
+private:
+
+    enum class Op : uint8_t {
+        pass,
+        any,
+        all,
+        none,
+        existence,
+        equality,
+        range,
+        function,
+    };
+
+    struct Instruction {
+        Op op;
+        FilterKeyword keyword;
+        // existence: whether the property must exist
+        bool exists;
+        // Interned property key, or function ID
+        uint32_t key;
+        // Operators: index after the last operand, equality: first value
+        uint32_t arg;
+        // equality: number of values
+        uint32_t count;
+        float min;
+        float max;
+    };
+
+    void compile(const Filter& _filter);
+
+    bool exec(size_t& _pc, const Feature& _feature, StyleContext& _ctx) const;
+
+    std::vector<Instruction> m_code;
+    std::vector<Value> m_values;
+
+    std::vector<uint32_t> m_keys;
+    bool m_hasFunction = false;
+};
+
+}
@@ -0,0 +1,549 @@
+#include "nativeFunction.h"
+
+#include "data/propertyKeys.h"
+#include "data/tileData.h"
+#include "scene/filters.h"
+#include "scene/styleContext.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+
+namespace Tangram {
+
+using JsValue = NativeFunction::JsValue;
+using Type = JsValue::Type;
+using Expression = NativeFunction::Expression;
+using Env = NativeFunction::Env;
+
+namespace {
+
+const double NaN = std::numeric_limits<double>::quiet_NaN();
+
+JsValue makeNumber(double _number) {
+    JsValue value;
+    value.type = Type::number;
+    value.number = _number;
+    return value;
+}
+
+JsValue makeBoolean(bool _boolean) {
+    JsValue value;
+    value.type = Type::boolean;
+    value.number = _boolean ? 1 : 0;
+    return value;
+}
+
+JsValue makeString(const std::string* _string) {
+    JsValue value;
+    value.type = Type::string;
+    value.string = _string;
+    return value;
+}
+
+JsValue fromValue(const Value& _value) {
+    if (_value.is<std::string>()) { return makeString(&_value.get<std::string>()); }
+    if (_value.is<double>()) { return makeNumber(_value.get<double>()); }
+    return JsValue();
+}
+
+// Number::toString, ECMAScript 7.1.12.1
+std::string numberToString(double _number) {
+    if (std::isnan(_number)) { return "NaN"; }
+    if (_number == 0) { return "0"; }
+    if (_number < 0) { return "-" + numberToString(-_number); }
+    if (std::isinf(_number)) { return "Infinity"; }
+
+    // Shortest digits that read back as the same number
+    char buffer[32];
+    for (int precision = 0; precision < 17; precision++) {
+        snprintf(buffer, sizeof(buffer), "%.*e", precision, _number);
+        if (strtod(buffer, nullptr) == _number) { break; }
+    }
+
+    // buffer is 'd[.ddd]e[+-]xx'
+    std::string digits;
+    const char* c = buffer;
+    for (; *c != 'e'; c++) {
+        if (*c != '.') { digits += *c; }
+    }
+    int k = digits.size();
+    int n = std::atoi(c + 1) + 1;
+
+    if (k <= n && n <= 21) {
+        return digits + std::string(n - k, '0');
+    }
+    if (0 < n && n <= 21) {
+        return digits.substr(0, n) + "." + digits.substr(n);
+    }
+    if (-6 < n && n <= 0) {
+        return "0." + std::string(-n, '0') + digits;
+    }
+
+    std::string exponent = (n - 1 < 0 ? "e-" : "e+") + std::to_string(std::abs(n - 1));
+    if (k == 1) { return digits + exponent; }
+    return digits.substr(0, 1) + "." + digits.substr(1) + exponent;
+}
+
+const std::string* toString(const JsValue& _value, Env& _env) {
+    static const std::string s_undefined = "undefined";
+    static const std::string s_null = "null";
+    static const std::string s_true = "true";
+    static const std::string s_false = "false";
+
+    switch (_value.type) {
+    case Type::undefined: return &s_undefined;
+    case Type::null: return &s_null;
+    case Type::boolean: return _value.number != 0 ? &s_true : &s_false;
+    case Type::string: return _value.string;
+    case Type::number:
+        _env.strings.push_back(numberToString(_value.number));
+        return &_env.strings.back();
+    }
+    return &s_undefined;
+}
+
+bool strictEquals(const JsValue& _a, const JsValue& _b) {
+    if (_a.type != _b.type) { return false; }
+
+    switch (_a.type) {
+    case Type::undefined:
+    case Type::null:
+        return true;
+    case Type::boolean:
+    case Type::number:
+        return _a.number == _b.number;
+    case Type::string:
+        return *_a.string == *_b.string;
+    }
+    return false;
+}
+
+bool looseEquals(const JsValue& _a, const JsValue& _b) {
+    if (_a.type == _b.type) { return strictEquals(_a, _b); }
+
+    bool aNull = _a.type == Type::null || _a.type == Type::undefined;
+    bool bNull = _b.type == Type::null || _b.type == Type::undefined;
+    if (aNull || bNull) { return aNull && bNull; }
+
+    // Remaining combinations of boolean, number and string compare as numbers
+    return _a.toNumber() == _b.toNumber();
+}
+
+enum class Compare { less, lessEqual, greater, greaterEqual };
+
+bool compare(Compare _op, const JsValue& _a, const JsValue& _b) {
+    if (_a.type == Type::string && _b.type == Type::string) {
+        int c = _a.string->compare(*_b.string);
+        switch (_op) {
+        case Compare::less: return c < 0;
+        case Compare::lessEqual: return c <= 0;
+        case Compare::greater: return c > 0;
+        case Compare::greaterEqual: return c >= 0;
+        }
+    }
+    // Comparisons with NaN are false
+    double a = _a.toNumber();
+    double b = _b.toNumber();
+    switch (_op) {
+    case Compare::less: return a < b;
+    case Compare::lessEqual: return a <= b;
+    case Compare::greater: return a > b;
+    case Compare::greaterEqual: return a >= b;
+    }
+    return false;
+}
+
+struct Token {
+    enum class Kind { end, number, string, identifier, punctuator, invalid };
+
+    Kind kind = Kind::end;
+    std::string text;
+    double number = 0;
+};
+
+class Parser {
+
+public:
+
+    Parser(const std::string& _source) : m_src(_source) { next(); }
+
+    // 'function() { return <expr>; }'
+    Expression parseFunction() {
+        if (!acceptIdentifier("function")) { return nullptr; }
+        if (!accept("(") || !accept(")") || !accept("{")) { return nullptr; }
+        if (!acceptIdentifier("return")) { return nullptr; }
+
+        auto expression = parseExpression();
+        if (!expression) { return nullptr; }
+
+        accept(";");
+        if (!accept("}") || m_token.kind != Token::Kind::end) { return nullptr; }
+
+        return expression;
+    }
+
+private:
+
+    void next() {
+        m_token = Token();
+
+        while (m_pos < m_src.size() && isspace(static_cast<unsigned char>(m_src[m_pos]))) {
+            m_pos++;
+        }
+        if (m_pos >= m_src.size()) { return; }
+
+        char c = m_src[m_pos];
+
+        if (isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$') {
+            size_t start = m_pos;
+            while (m_pos < m_src.size() &&
+                   (isalnum(static_cast<unsigned char>(m_src[m_pos])) ||
+                    m_src[m_pos] == '_' || m_src[m_pos] == '$')) {
+                m_pos++;
+            }
+            m_token.kind = Token::Kind::identifier;
+            m_token.text = m_src.substr(start, m_pos - start);
+            return;
+        }
+
+        if (isdigit(static_cast<unsigned char>(c)) ||
+            (c == '.' && m_pos + 1 < m_src.size() && isdigit(static_cast<unsigned char>(m_src[m_pos + 1])))) {
+            const char* start = m_src.c_str() + m_pos;
+            char* end = nullptr;
+            if (start[0] == '0' && (start[1] == 'x' || start[1] == 'X')) {
+                m_token.number = static_cast<double>(strtoull(start + 2, &end, 16));
+                if (end == start + 2) { end = const_cast<char*>(start); }
+            } else {
+                m_token.number = strtod(start, &end);
+            }
+            // Octal and other forms of number literals are left to Duktape
+            if (end == start || (end < m_src.c_str() + m_src.size() && isalnum(static_cast<unsigned char>(*end))) ||
+                (start[0] == '0' && isdigit(static_cast<unsigned char>(start[1])))) {
+                m_token.kind = Token::Kind::invalid;
+                return;
+            }
+            m_token.kind = Token::Kind::number;
+            m_pos += end - start;
+            return;
+        }
+
+        if (c == '\'' || c == '"') {
+            m_pos++;
+            while (m_pos < m_src.size() && m_src[m_pos] != c) {
+                if (m_src[m_pos] == '\\') {
+                    if (m_pos + 1 >= m_src.size()) { break; }
+                    char e = m_src[m_pos + 1];
+                    if (e != '\\' && e != '\'' && e != '"') {
+                        // Other escape sequences are left to Duktape
+                        m_token.kind = Token::Kind::invalid;
+                        return;
+                    }
+                    m_token.text += e;
+                    m_pos += 2;
+                    continue;
+                }
+                m_token.text += m_src[m_pos++];
+            }
+            if (m_pos >= m_src.size()) {
+                m_token.kind = Token::Kind::invalid;
+                return;
+            }
+            m_pos++;
+            m_token.kind = Token::Kind::string;
+            return;
+        }
+
+        static const char* punctuators[] = {
+            "===", "!==", "==", "!=", "<=", ">=", "&&", "||",
+            "(", ")", "{", "}", "[", "]", ".", ";", "?", ":",
+            "!", "+", "-", "*", "/", "%", "<", ">",
+        };
+        for (auto* p : punctuators) {
+            size_t len = strlen(p);
+            if (m_src.compare(m_pos, len, p) == 0) {
+                m_token.kind = Token::Kind::punctuator;
+                m_token.text = p;
+                m_pos += len;
+                return;
+            }
+        }
+        m_token.kind = Token::Kind::invalid;
+    }
+
+    bool is(const char* _punctuator) const {
+        return m_token.kind == Token::Kind::punctuator && m_token.text == _punctuator;
+    }
+
+    bool accept(const char* _punctuator) {
+        if (!is(_punctuator)) { return false; }
+        next();
+        return true;
+    }
+
+    bool acceptIdentifier(const char* _name) {
+        if (m_token.kind != Token::Kind::identifier || m_token.text != _name) { return false; }
+        next();
+        return true;
+    }
+
+    Expression parseExpression() {
+        auto condition = parseBinary(0);
+        if (!condition || !accept("?")) { return condition; }
+
+        auto a = parseExpression();
+        if (!a || !accept(":")) { return nullptr; }
+        auto b = parseExpression();
+        if (!b) { return nullptr; }
+
+        return [=](Env& _env) {
+            return condition(_env).toBoolean() ? a(_env) : b(_env);
+        };
+    }
+
+    // Binary operators by increasing precedence
+    int precedence(const Token& _token) const {
+        if (_token.kind != Token::Kind::punctuator) { return -1; }
+        const auto& op = _token.text;
+        if (op == "||") { return 0; }
+        if (op == "&&") { return 1; }
+        if (op == "==" || op == "!=" || op == "===" || op == "!==") { return 2; }
+        if (op == "<" || op == "<=" || op == ">" || op == ">=") { return 3; }
+        if (op == "+" || op == "-") { return 4; }
+        if (op == "*" || op == "/" || op == "%") { return 5; }
+        return -1;
+    }
+
+    Expression parseBinary(int _minPrecedence) {
+        auto lhs = parseUnary();
+
+        while (lhs) {
+            int prec = precedence(m_token);
+            if (prec < _minPrecedence) { break; }
+
+            std::string op = m_token.text;
+            next();
+
+            // All supported binary operators are left-associative
+            auto rhs = parseBinary(prec + 1);
+            if (!rhs) { return nullptr; }
+
+            lhs = binary(op, std::move(lhs), std::move(rhs));
+        }
+        return lhs;
+    }
+
+    Expression binary(const std::string& _op, Expression _a, Expression _b) {
+        if (_op == "||") {
+            return [=](Env& _env) { auto a = _a(_env); return a.toBoolean() ? a : _b(_env); };
+        }
+        if (_op == "&&") {
+            return [=](Env& _env) { auto a = _a(_env); return a.toBoolean() ? _b(_env) : a; };
+        }
+        if (_op == "===") {
+            return [=](Env& _env) { auto a = _a(_env); return makeBoolean(strictEquals(a, _b(_env))); };
+        }
+        if (_op == "!==") {
+            return [=](Env& _env) { auto a = _a(_env); return makeBoolean(!strictEquals(a, _b(_env))); };
+        }
+        if (_op == "==") {
+            return [=](Env& _env) { auto a = _a(_env); return makeBoolean(looseEquals(a, _b(_env))); };
+        }
+        if (_op == "!=") {
+            return [=](Env& _env) { auto a = _a(_env); return makeBoolean(!looseEquals(a, _b(_env))); };
+        }
+        if (_op == "<" || _op == "<=" || _op == ">" || _op == ">=") {
+            Compare cmp = _op == "<" ? Compare::less
+                : _op == "<=" ? Compare::lessEqual
+                : _op == ">" ? Compare::greater
+                : Compare::greaterEqual;
+            return [=](Env& _env) { auto a = _a(_env); return makeBoolean(compare(cmp, a, _b(_env))); };
+        }
+        if (_op == "+") {
+            return [=](Env& _env) {
+                auto a = _a(_env);
+                auto b = _b(_env);
+                if (a.type == Type::string || b.type == Type::string) {
+                    _env.strings.push_back(*toString(a, _env) + *toString(b, _env));
+                    return makeString(&_env.strings.back());
+                }
+                return makeNumber(a.toNumber() + b.toNumber());
+            };
+        }
+        if (_op == "-") {
+            return [=](Env& _env) { double a = _a(_env).toNumber(); return makeNumber(a - _b(_env).toNumber()); };
+        }
+        if (_op == "*") {
+            return [=](Env& _env) { double a = _a(_env).toNumber(); return makeNumber(a * _b(_env).toNumber()); };
+        }
+        if (_op == "/") {
+            return [=](Env& _env) { double a = _a(_env).toNumber(); return makeNumber(a / _b(_env).toNumber()); };
+        }
+        if (_op == "%") {
+            return [=](Env& _env) { double a = _a(_env).toNumber(); return makeNumber(std::fmod(a, _b(_env).toNumber())); };
+        }
+        return nullptr;
+    }
+
+    Expression parseUnary() {
+        if (accept("!")) {
+            auto a = parseUnary();
+            if (!a) { return nullptr; }
+            return [=](Env& _env) { return makeBoolean(!a(_env).toBoolean()); };
+        }
+        if (accept("-")) {
+            auto a = parseUnary();
+            if (!a) { return nullptr; }
+            return [=](Env& _env) { return makeNumber(-a(_env).toNumber()); };
+        }
+        if (accept("+")) {
+            auto a = parseUnary();
+            if (!a) { return nullptr; }
+            return [=](Env& _env) { return makeNumber(a(_env).toNumber()); };
+        }
+        return parsePrimary();
+    }
+
+    Expression parsePrimary() {
+        Token token = m_token;
+
+        switch (token.kind) {
+        case Token::Kind::number: {
+            next();
+            double number = token.number;
+            return [=](Env&) { return makeNumber(number); };
+        }
+        case Token::Kind::string: {
+            next();
+            auto string = std::make_shared<std::string>(token.text);
+            return [=](Env&) { return makeString(string.get()); };
+        }
+        case Token::Kind::punctuator: {
+            if (!accept("(")) { return nullptr; }
+            auto expression = parseExpression();
+            if (!expression || !accept(")")) { return nullptr; }
+            return expression;
+        }
+        case Token::Kind::identifier:
+            next();
+            return identifier(token.text);
+
+        default:
+            return nullptr;
+        }
+    }
+
+    Expression identifier(const std::string& _name) {
+        if (_name == "true" || _name == "false") {
+            bool value = _name == "true";
+            return [=](Env&) { return makeBoolean(value); };
+        }
+        if (_name == "null") {
+            return [](Env&) { JsValue v; v.type = Type::null; return v; };
+        }
+        if (_name == "undefined") {
+            return [](Env&) { return JsValue(); };
+        }
+        if (_name == "point" || _name == "line" || _name == "polygon") {
+            double value = _name == "point" ? GeometryType::points
+                : _name == "line" ? GeometryType::lines
+                : GeometryType::polygons;
+            return [=](Env&) { return makeNumber(value); };
+        }
+        if (_name == "$zoom" || _name == "$geometry") {
+            FilterKeyword keyword = Filter::keywordType(_name);
+            return [=](Env& _env) {
+                auto& value = _env.ctx.getKeyword(keyword);
+                // Unset keywords are undefined globals in Duktape
+                if (value.is<none_type>()) { _env.error = true; }
+                return fromValue(value);
+            };
+        }
+        if (_name == "feature") {
+            std::string key;
+            if (accept(".")) {
+                if (m_token.kind != Token::Kind::identifier) { return nullptr; }
+                key = m_token.text;
+                next();
+            } else if (accept("[")) {
+                if (m_token.kind != Token::Kind::string) { return nullptr; }
+                key = m_token.text;
+                next();
+                if (!accept("]")) { return nullptr; }
+            } else {
+                return nullptr;
+            }
+            uint32_t keyId = PropertyKeys::intern(key);
+            return [=](Env& _env) {
+                if (!_env.feature) { return JsValue(); }
+                return fromValue(_env.feature->props.getById(keyId));
+            };
+        }
+        // Globals, builtins and local variables are left to Duktape
+        return nullptr;
+    }
+
+    const std::string& m_src;
+    size_t m_pos = 0;
+    Token m_token;
+};
+
+}
+
+bool JsValue::toBoolean() const {
+    switch (type) {
+    case Type::undefined:
+    case Type::null:
+        return false;
+    case Type::boolean:
+        return number != 0;
+    case Type::number:
+        return number != 0 && !std::isnan(number);
+    case Type::string:
+        return !string->empty();
+    }
+    return false;
+}
+
+double JsValue::toNumber() const {
+    switch (type) {
+    case Type::undefined:
+        return NaN;
+    case Type::null:
+        return 0;
+    case Type::boolean:
+    case Type::number:
+        return number;
+    case Type::string: {
+        const char* start = string->c_str();
+        while (isspace(static_cast<unsigned char>(*start))) { start++; }
+        if (*start == '\0') { return 0; }
+
+        // strtod also accepts 'inf', 'nan' and others that are NaN in JS
+        const char* digits = (*start == '+' || *start == '-') ? start + 1 : start;
+        if (isalpha(static_cast<unsigned char>(*digits)) && strncmp(digits, "Infinity", 8) != 0) {
+            return NaN;
+        }
+
+        char* end = nullptr;
+        double result = strtod(start, &end);
+        while (isspace(static_cast<unsigned char>(*end))) { end++; }
+        return *end == '\0' ? result : NaN;
+    }
+    }
+    return NaN;
+}
+
+std::unique_ptr<NativeFunction> NativeFunction::compile(const std::string& _source) {
+
+    Parser parser(_source);
+
+    auto expression = parser.parseFunction();
+    if (!expression) { return nullptr; }
+
+    return std::unique_ptr<NativeFunction>(new NativeFunction(std::move(expression)));
+}
+
+}
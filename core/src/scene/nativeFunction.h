@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Tangram {
+
+class StyleContext;
+struct Feature;
+
+/* Native evaluation of simple JS style and filter functions
+ *
+ * Scene functions are mostly of the form 'function() { return <expr>; }'
+ * where <expr> reads feature properties, $zoom and $geometry and combines
+ * them with comparisons, arithmetic, logical operators and ternaries. These
+ * are compiled into a tree of closures that follow the JS semantics for
+ * the supported operators. compile() returns null for everything else, e.g.
+ * function calls, arrays, 'global' or statements other than 'return', so
+ * that the function is evaluated by Duktape.
+ */
+class NativeFunction {
+
+public:
+
+    struct JsValue {
+        enum class Type : uint8_t { undefined, null, boolean, number, string };
+
+        Type type = Type::undefined;
+        double number = 0;
+        const std::string* string = nullptr;
+
+        bool toBoolean() const;
+        double toNumber() const;
+    };
+
+    struct Env {
+        const Feature* feature;
+        const StyleContext& ctx;
+        // Scratch space for strings created during evaluation
+        std::deque<std::string> strings;
+        // Set when Duktape would have thrown, e.g. for an unset keyword
+        bool error = false;
+    };
+
+    using Expression = std::function<JsValue(Env&)>;
+
+    static std::unique_ptr<NativeFunction> compile(const std::string& _source);
+
+    /* Evaluate for the current feature and keywords of @_ctx. String results
+     * point into the feature properties, the keywords, the function or
+     * @_env.strings */
+    JsValue eval(Env& _env) const { return m_expression(_env); }
+
+private:
+
+    NativeFunction(Expression _expression) : m_expression(std::move(_expression)) {}
+
+    Expression m_expression;
+};
+
+}
@@ -9,6 +9,7 @@ SceneLayer::SceneLayer(std::string _name, Filter _filter,
                        std::vector<SceneLayer> _sublayers,
                        bool _visible) :
     m_filter(std::move(_filter)),
+    m_filterProgram(m_filter),
     m_name(_name),
     m_rules(_rules),
     m_sublayers(std::move(_sublayers)),
@@ -16,6 +17,16 @@ SceneLayer::SceneLayer(std::string _name, Filter _filter,
 
     setDepth(1);
 
+    m_filterKeys = m_filterProgram.keys();
+    m_cacheable = !m_filterProgram.hasFunction();
+
+    for (auto& layer : m_sublayers) {
+        m_filterKeys.insert(m_filterKeys.end(), layer.m_filterKeys.begin(), layer.m_filterKeys.end());
+        m_cacheable &= layer.m_cacheable;
+    }
+    std::sort(m_filterKeys.begin(), m_filterKeys.end());
+    m_filterKeys.erase(std::unique(m_filterKeys.begin(), m_filterKeys.end()), m_filterKeys.end());
+
 }
 
 void SceneLayer::setDepth(size_t _d) {
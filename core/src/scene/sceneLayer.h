@@ -2,6 +2,7 @@
 
 #include "scene/drawRule.h"
 #include "scene/filters.h"
+#include "scene/filterProgram.h"
 #include "scene/styleParam.h"
 
 #include <string>
@@ -14,12 +15,18 @@ struct Feature;
 class SceneLayer {
 
     Filter m_filter;
+    FilterProgram m_filterProgram;
     std::string m_name;
     std::vector<DrawRuleData> m_rules;
     std::vector<SceneLayer> m_sublayers;
     size_t m_depth = 0;
     bool m_visible;
 
+    // Property keys read by the filters of this layer and its sublayers
+    std::vector<uint32_t> m_filterKeys;
+    // Whether matching depends only on m_filterKeys, zoom and geometry type
+    bool m_cacheable = true;
+
 public:
 
     SceneLayer(std::string _name, Filter _filter,
@@ -29,10 +36,13 @@ public:
 
     const auto& name() const { return m_name; }
     const auto& filter() const { return m_filter; }
+    const auto& filterProgram() const { return m_filterProgram; }
     const auto& rules() const { return m_rules; }
     const auto& sublayers() const { return m_sublayers; }
     const auto& depth() const { return m_depth; }
     const auto& visible() const { return m_visible; }
+    const auto& filterKeys() const { return m_filterKeys; }
+    bool cacheable() const { return m_cacheable; }
 
     void setDepth(size_t _d);
 };
@@ -3,6 +3,7 @@
 #include "scene.h"
 #include "sceneLoader.h"
 #include "lights.h"
+#include "data/clientClusterSource.h"
 #include "data/clientGeoJsonSource.h"
 #include "data/geoJsonSource.h"
 #include "data/mvtSource.h"
@@ -608,6 +609,12 @@ void SceneLoader::loadStyleProps(Style& style, Node styleNode, Scene& scene) {
         style.setTexCoordsGeneration(texcoordsNode.as<bool>());
     }
 
+    if (Node compactNode = styleNode["compact_vertices"]) {
+        if (auto polygonStyle = dynamic_cast<PolygonStyle*>(&style)) {
+            polygonStyle->setCompactVertices(compactNode.as<bool>());
+        }
+    }
+
     if (Node shadersNode = styleNode["shaders"]) {
         loadShaderConfig(shadersNode, style, scene);
     }
@@ -752,6 +759,15 @@ void SceneLoader::loadSource(const std::string& name, const Node& source, const
     if (type == "GeoJSON") {
         if (tiled) {
             sourcePtr = std::shared_ptr<DataSource>(new GeoJsonSource(name, url, maxZoom));
+        } else if (source["cluster"].as<bool>(false)) {
+            ClusterIndex::Options options;
+            if (auto radius = source["cluster_radius"]) {
+                options.radius = radius.as<float>(options.radius);
+            }
+            if (auto clusterMaxZoom = source["cluster_max_zoom"]) {
+                options.maxZoom = clusterMaxZoom.as<int32_t>(options.maxZoom);
+            }
+            sourcePtr = std::shared_ptr<DataSource>(new ClientClusterSource(name, url, options, maxZoom));
         } else {
             sourcePtr = std::shared_ptr<DataSource>(new ClientGeoJsonSource(name, url, maxZoom));
         }
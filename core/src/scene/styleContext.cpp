@@ -4,11 +4,14 @@
 #include "data/propertyItem.h"
 #include "data/tileData.h"
 #include "scene/filters.h"
+#include "scene/nativeFunction.h"
 #include "scene/scene.h"
 #include "util/builders.h"
 
 #include "duktape.h"
 
+#include <cmath>
+
 #define DUMP(...) // do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 #define DBG(...) do { logMsg(__VA_ARGS__); duk_dump_context_stderr(m_ctx); } while(0)
 
@@ -194,6 +197,11 @@ bool StyleContext::setFunctions(const std::vector<std::string>& _functions) {
         LOGE("'fns' object not set");
     }
 
+    m_nativeFunctions.clear();
+    for (auto& function : _functions) {
+        m_nativeFunctions.push_back(m_useNativeFunctions ? NativeFunction::compile(function) : nullptr);
+    }
+
     DUMP("setFunctions\n");
     return ok;
 }
@@ -278,8 +286,77 @@ bool StyleContext::evalFunction(FunctionID id) {
     return true;
 }
 
+static void parseStyleBoolean(StyleParamKey _key, bool _value, StyleParam::Value& _val) {
+    switch (_key) {
+        case StyleParamKey::interactive:
+        case StyleParamKey::text_interactive:
+        case StyleParamKey::visible:
+            _val = _value;
+            break;
+        case StyleParamKey::extrude:
+            _val = _value ? glm::vec2(NAN, NAN) : glm::vec2(0.0f, 0.0f);
+            break;
+        default:
+            break;
+    }
+}
+
+// Same clamping as duk_get_uint()
+static uint32_t toUint32(double _value) {
+    if (std::isnan(_value) || _value < 0) { return 0; }
+    if (_value > double(UINT32_MAX)) { return UINT32_MAX; }
+    return static_cast<uint32_t>(_value);
+}
+
+static void parseStyleNumber(StyleParamKey _key, double _value, StyleParam::Value& _val) {
+    // NaN or Infinity, e.g. from arithmetic on missing properties, sets no value
+    if (!std::isfinite(_value)) { return; }
+
+    switch (_key) {
+        case StyleParamKey::extrude:
+            _val = glm::vec2(0.f, static_cast<float>(_value));
+            break;
+        case StyleParamKey::width:
+        case StyleParamKey::outline_width: {
+            // TODO more efficient way to return pixels.
+            // atm this only works by return value as string
+            _val = StyleParam::Width{static_cast<float>(_value)};
+            break;
+        }
+        case StyleParamKey::text_font_stroke_width: {
+            _val = static_cast<float>(_value);
+            break;
+        }
+        case StyleParamKey::order:
+        case StyleParamKey::outline_order:
+        case StyleParamKey::priority:
+        case StyleParamKey::color:
+        case StyleParamKey::outline_color:
+        case StyleParamKey::text_font_fill:
+        case StyleParamKey::text_font_stroke_color: {
+            _val = toUint32(_value);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+const NativeFunction* StyleContext::nativeFunction(FunctionID _id) const {
+    if (_id >= m_nativeFunctions.size()) { return nullptr; }
+    return m_nativeFunctions[_id].get();
+}
+
 bool StyleContext::evalFilter(FunctionID _id) {
 
+    if (auto* function = nativeFunction(_id)) {
+        NativeFunction::Env env{ m_feature, *this };
+        auto value = function->eval(env);
+        if (env.error) { return false; }
+
+        return value.type == NativeFunction::JsValue::Type::boolean && value.number != 0;
+    }
+
     bool result = false;
 
     if (!evalFunction(_id)) { return false; };
@@ -297,6 +374,29 @@ bool StyleContext::evalFilter(FunctionID _id) {
 
 bool StyleContext::evalStyle(FunctionID _id, StyleParamKey _key, StyleParam::Value& _val) {
 
+    if (auto* function = nativeFunction(_id)) {
+        NativeFunction::Env env{ m_feature, *this };
+        auto value = function->eval(env);
+        _val = none_type{};
+        if (env.error) { return false; }
+
+        using Type = NativeFunction::JsValue::Type;
+        switch (value.type) {
+            case Type::string:
+                _val = StyleParam::parseString(_key, *value.string);
+                break;
+            case Type::boolean:
+                parseStyleBoolean(_key, value.number != 0, _val);
+                break;
+            case Type::number:
+                parseStyleNumber(_key, value.number, _val);
+                break;
+            default:
+                break;
+        }
+        return !_val.is<none_type>();
+    }
+
     if (!evalFunction(_id)) { return false; }
 
     // parse evaluated result at stack top
@@ -316,20 +416,7 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
         _val = StyleParam::parseString(_key, value);
 
     } else if (duk_is_boolean(m_ctx, -1)) {
-        bool value = duk_get_boolean(m_ctx, -1);
-
-        switch (_key) {
-            case StyleParamKey::interactive:
-            case StyleParamKey::text_interactive:
-            case StyleParamKey::visible:
-                _val = value;
-                break;
-            case StyleParamKey::extrude:
-                _val = value ? glm::vec2(NAN, NAN) : glm::vec2(0.0f, 0.0f);
-                break;
-            default:
-                break;
-        }
+        parseStyleBoolean(_key, duk_get_boolean(m_ctx, -1), _val);
 
     } else if (duk_is_array(m_ctx, -1)) {
         duk_get_prop_string(m_ctx, -1, "length");
@@ -395,36 +482,8 @@ void StyleContext::parseStyleResult(StyleParamKey _key, StyleParam::Value& _val)
         // Ignore setting value
         LOGD("duk evaluates JS method to NAN.\n");
     } else if (duk_is_number(m_ctx, -1)) {
+        parseStyleNumber(_key, duk_get_number(m_ctx, -1), _val);
 
-        switch (_key) {
-            case StyleParamKey::extrude:
-                _val = glm::vec2(0.f, static_cast<float>(duk_get_number(m_ctx, -1)));
-                break;
-            case StyleParamKey::width:
-            case StyleParamKey::outline_width: {
-                // TODO more efficient way to return pixels.
-                // atm this only works by return value as string
-                double v = duk_get_number(m_ctx, -1);
-                _val = StyleParam::Width{static_cast<float>(v)};
-                break;
-            }
-            case StyleParamKey::text_font_stroke_width: {
-                _val = static_cast<float>(duk_get_number(m_ctx, -1));
-                break;
-            }
-            case StyleParamKey::order:
-            case StyleParamKey::outline_order:
-            case StyleParamKey::priority:
-            case StyleParamKey::color:
-            case StyleParamKey::outline_color:
-            case StyleParamKey::text_font_fill:
-            case StyleParamKey::text_font_stroke_color: {
-                _val = static_cast<uint32_t>(duk_get_uint(m_ctx, -1));
-                break;
-            }
-            default:
-                break;
-        }
     } else if (duk_is_null_or_undefined(m_ctx, -1)) {
         // Ignore setting value
         LOGD("duk evaluates JS method to null or undefined.");
@@ -8,6 +8,7 @@
 #include <memory>
 #include <array>
 #include <unordered_map>
+#include <vector>
 
 struct duk_hthread;
 typedef struct duk_hthread duk_context;
@@ -19,6 +20,7 @@ namespace YAML {
 namespace Tangram {
 
 class Scene;
+class NativeFunction;
 struct Feature;
 struct StyleParam;
 
@@ -69,6 +71,11 @@ public:
     void clear();
 
     bool setFunctions(const std::vector<std::string>& _functions);
+
+    /* Evaluate simple functions natively instead of with Duktape, see
+     * NativeFunction. Applies to functions set after this call. */
+    void setNativeFunctions(bool _enable) { m_useNativeFunctions = _enable; }
+
     void setSceneGlobals(const std::unordered_map<std::string, YAML::Node>& sceneGlobals);
 
     void setKeyword(const std::string& _key, Value _value);
@@ -79,6 +86,7 @@ private:
     static int jsHasProperty(duk_context *_ctx);
 
     bool evalFunction(FunctionID id);
+    const NativeFunction* nativeFunction(FunctionID id) const;
     void parseStyleResult(StyleParamKey _key, StyleParam::Value& _val) const;
     void parseSceneGlobals(const YAML::Node& node, const std::string& key, int seqIndex, int dukObject);
 
@@ -90,6 +98,10 @@ private:
 
     const Feature* m_feature = nullptr;
 
+    // Compiled functions by FunctionID, null when evaluated by Duktape
+    std::vector<std::unique_ptr<NativeFunction>> m_nativeFunctions;
+    bool m_useNativeFunctions = true;
+
     mutable duk_context *m_ctx;
 };
 
@@ -9,6 +9,8 @@
 #include "style/pointStyleBuilder.h"
 #include "view/view.h"
 
+#include <cmath>
+
 namespace Tangram {
 
 PointStyle::PointStyle(std::string _name, Blending _blendMode, GLenum _drawMode)
@@ -86,6 +88,63 @@ void PointStyle::onBeginDrawFrame(const View& _view, Scene& _scene) {
     m_textStyle->onBeginDrawFrame(_view, _scene);
 }
 
+bool PointStyle::getUVQuad(Parameters& _params, glm::vec4& _quad) const {
+    _quad = glm::vec4(0.0, 0.0, 1.0, 1.0);
+
+    if (m_spriteAtlas) {
+        SpriteNode spriteNode;
+
+        if (!m_spriteAtlas->getSpriteNode(_params.sprite, spriteNode) &&
+            !m_spriteAtlas->getSpriteNode(_params.spriteDefault, spriteNode)) {
+            return false;
+        }
+
+        if (std::isnan(_params.size.x)) {
+            _params.size = spriteNode.m_size;
+        }
+
+        _quad.x = spriteNode.m_uvBL.x;
+        _quad.y = spriteNode.m_uvBL.y;
+        _quad.z = spriteNode.m_uvTR.x;
+        _quad.w = spriteNode.m_uvTR.y;
+    } else {
+        // default point size
+        if (std::isnan(_params.size.x)) {
+            _params.size = glm::vec2(8.0);
+        }
+    }
+
+    _params.size *= m_pixelScale;
+
+    return true;
+}
+
+SpriteQuad PointStyle::spriteQuad(const glm::vec4& _quad, const Parameters& _params) {
+
+    glm::i16vec2 size = _params.size * SpriteVertex::position_scale;
+
+    // Attribute will be normalized - scale to max short;
+    glm::vec2 uvTR = glm::vec2{_quad.z, _quad.w} * SpriteVertex::texture_scale;
+    glm::vec2 uvBL = glm::vec2{_quad.x, _quad.y} * SpriteVertex::texture_scale;
+
+    int16_t extrude = _params.extrudeScale * SpriteVertex::extrusion_scale;
+
+    return {
+        {{{0, 0},
+          {uvBL.x, uvTR.y},
+          {-extrude, extrude}},
+         {{size.x, 0},
+          {uvTR.x, uvTR.y},
+          {extrude, extrude}},
+         {{0, -size.y},
+          {uvBL.x, uvBL.y},
+          {-extrude, -extrude}},
+         {{size.x, -size.y},
+          {uvTR.x, uvBL.y},
+          {extrude, -extrude}}},
+        _params.color};
+}
+
 std::unique_ptr<StyleBuilder> PointStyle::createBuilder() const {
     return std::make_unique<PointStyleBuilder>(*this);
 }
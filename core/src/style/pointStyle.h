@@ -3,6 +3,7 @@
 #include "style.h"
 #include "glm/vec2.hpp"
 #include "glm/vec3.hpp"
+#include "glm/vec4.hpp"
 #include "labels/spriteLabel.h"
 #include "labels/labelProperty.h"
 #include "gl/dynamicQuadMesh.h"
@@ -51,6 +52,15 @@ public:
     virtual void constructVertexLayout() override;
     virtual void constructShaderProgram() override;
 
+    /* Get the texture coordinates of the sprite of @_params, or the whole
+     * texture when the style has no sprite atlas. Sets the size of the sprite
+     * when no size is given and scales it by the pixel scale. Returns false
+     * when the sprite is not in the atlas. */
+    bool getUVQuad(Parameters& _params, glm::vec4& _quad) const;
+
+    /* Create the quad of a sprite with texture coordinates @_quad */
+    static SpriteQuad spriteQuad(const glm::vec4& _quad, const Parameters& _params);
+
     TextStyle& textStyle() const { return *m_textStyle; }
     virtual void setPixelScale(float _pixelScale) override;
 
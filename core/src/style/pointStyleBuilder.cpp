@@ -105,59 +105,11 @@ void PointStyleBuilder::addLabel(const Point& _point, const glm::vec4& _quad,
                                                      *m_spriteLabels,
                                                      m_quads.size()));
 
-    glm::i16vec2 size = _params.size * SpriteVertex::position_scale;
-
-    // Attribute will be normalized - scale to max short;
-    glm::vec2 uvTR = glm::vec2{_quad.z, _quad.w} * SpriteVertex::texture_scale;
-    glm::vec2 uvBL = glm::vec2{_quad.x, _quad.y} * SpriteVertex::texture_scale;
-
-    int16_t extrude = _params.extrudeScale * SpriteVertex::extrusion_scale;
-
-    m_quads.push_back({
-            {{{0, 0},
-             {uvBL.x, uvTR.y},
-             {-extrude, extrude}},
-            {{size.x, 0},
-             {uvTR.x, uvTR.y},
-             {extrude, extrude}},
-            {{0, -size.y},
-             {uvBL.x, uvBL.y},
-             {-extrude, -extrude}},
-            {{size.x, -size.y},
-             {uvTR.x, uvBL.y},
-             {extrude, -extrude}}},
-            _params.color});
+    m_quads.push_back(PointStyle::spriteQuad(_quad, _params));
 }
 
 bool PointStyleBuilder::getUVQuad(PointStyle::Parameters& _params, glm::vec4& _quad) const {
-    _quad = glm::vec4(0.0, 0.0, 1.0, 1.0);
-
-    if (m_style.spriteAtlas()) {
-        SpriteNode spriteNode;
-
-        if (!m_style.spriteAtlas()->getSpriteNode(_params.sprite, spriteNode) &&
-            !m_style.spriteAtlas()->getSpriteNode(_params.spriteDefault, spriteNode)) {
-            return false;
-        }
-
-        if (std::isnan(_params.size.x)) {
-            _params.size = spriteNode.m_size;
-        }
-
-        _quad.x = spriteNode.m_uvBL.x;
-        _quad.y = spriteNode.m_uvBL.y;
-        _quad.z = spriteNode.m_uvTR.x;
-        _quad.w = spriteNode.m_uvTR.y;
-    } else {
-        // default point size
-        if (std::isnan(_params.size.x)) {
-            _params.size = glm::vec2(8.0);
-        }
-    }
-
-    _params.size *= m_style.pixelScale();
-
-    return true;
+    return m_style.getUVQuad(_params, _quad);
 }
 
 void PointStyleBuilder::addPoint(const Point& _point, const Properties& _props,
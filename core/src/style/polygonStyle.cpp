@@ -5,6 +5,7 @@
 #include "material.h"
 #include "util/builders.h"
 #include "util/extrude.h"
+#include "util/parallel.h"
 #include "gl/shaderProgram.h"
 #include "gl/mesh.h"
 #include "tile/tile.h"
@@ -15,8 +16,11 @@
 #include "glm/gtc/type_precision.hpp"
 
 #include <cmath>
+#include <cstring>
 
 constexpr float position_scale = 8192.0f;
+// Minimum number of polygon points per tessellation thread
+constexpr size_t min_chunk_points = 8192;
 constexpr float texture_scale = 65535.0f;
 constexpr float normal_scale = 127.0f;
 
@@ -44,13 +48,65 @@ struct PolygonVertex : PolygonVertexNoUVs {
     glm::u16vec2 texcoord;
 };
 
+// Octahedral encoding of a unit vector, decoded by unpackNormal() in polygon.vs
+static glm::i8vec2 encodeNormal(glm::vec3 n) {
+    n /= std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    glm::vec2 e(n.x, n.y);
+    if (n.z < 0) {
+        e = glm::vec2((1.f - std::abs(n.y)) * (n.x >= 0 ? 1.f : -1.f),
+                      (1.f - std::abs(n.x)) * (n.y >= 0 ? 1.f : -1.f));
+    }
+    return glm::i8vec2(glm::round(e * normal_scale));
+}
+
+// Compact layout: 14 bytes with the normal in two bytes, the color is
+// stored as bytes to avoid padding. Opt-in, see setCompactVertices().
+struct PolygonVertexCompactNoUVs {
+
+    PolygonVertexCompactNoUVs(glm::vec3 position, uint32_t order, glm::vec3 normal, glm::vec2 uv, GLuint abgr)
+        : pos(glm::i16vec4{ glm::round(position * position_scale), order }),
+          norm(encodeNormal(normal)) {
+        std::memcpy(color, &abgr, sizeof(color));
+    }
+
+    glm::i16vec4 pos; // pos.w contains layer (params.order)
+    uint8_t color[4];
+    glm::i8vec2 norm;
+};
+
+struct PolygonVertexCompact : PolygonVertexCompactNoUVs {
+
+    PolygonVertexCompact(glm::vec3 position, uint32_t order, glm::vec3 normal, glm::vec2 uv, GLuint abgr)
+        : PolygonVertexCompactNoUVs(position, order, normal, uv, abgr), texcoord(uv * texture_scale) {}
+
+    glm::u16vec2 texcoord;
+};
+
+static_assert(sizeof(PolygonVertexCompactNoUVs) == 14, "Unexpected padding in compact polygon vertex");
+static_assert(sizeof(PolygonVertexCompact) == 18, "Unexpected padding in compact polygon vertex");
+
 PolygonStyle::PolygonStyle(std::string _name, Blending _blendMode, GLenum _drawMode)
     : Style(_name, _blendMode, _drawMode)
 {}
 
 void PolygonStyle::constructVertexLayout() {
 
-    if (m_texCoordsGeneration) {
+    if (compactVertices()) {
+        if (m_texCoordsGeneration) {
+            m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
+                {"a_position", 4, GL_SHORT, false, 0},
+                {"a_color", 4, GL_UNSIGNED_BYTE, true, 0},
+                {"a_packed_normal", 2, GL_BYTE, true, 0},
+                {"a_texcoord", 2, GL_UNSIGNED_SHORT, true, 0},
+            }));
+        } else {
+            m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
+                {"a_position", 4, GL_SHORT, false, 0},
+                {"a_color", 4, GL_UNSIGNED_BYTE, true, 0},
+                {"a_packed_normal", 2, GL_BYTE, true, 0},
+            }));
+        }
+    } else if (m_texCoordsGeneration) {
         m_vertexLayout = std::shared_ptr<VertexLayout>(new VertexLayout({
             {"a_position", 4, GL_SHORT, false, 0},
             {"a_normal", 4, GL_BYTE, true, 0}, // The 4th byte is for padding
@@ -77,6 +133,10 @@ void PolygonStyle::constructShaderProgram() {
     if (m_texCoordsGeneration) {
         m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_USE_TEX_COORDS\n");
     }
+
+    if (compactVertices()) {
+        m_shaderProgram->addSourceBlock("defines", "#define TANGRAM_PACKED_NORMAL\n");
+    }
 }
 
 template <class V>
@@ -95,7 +155,7 @@ public:
     void setup(const Tile& _tile) override {
         m_tileUnitsPerMeter = _tile.getInverseScale();
         m_zoom = _tile.getID().z;
-        m_meshData.clear();
+        m_polygons.clear();
     }
 
     void addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule) override;
@@ -112,11 +172,25 @@ public:
 
 private:
 
+    // Polygon with the parameters of its rule, tessellated in build()
+    struct StyledPolygon {
+        const Polygon* polygon;
+        uint32_t order;
+        uint32_t color;
+        float height;
+        float minHeight;
+    };
+
+    void buildPolygon(const StyledPolygon& _polygon, PolygonBuilder& _builder, MeshData<V>& _mesh);
+
     const PolygonStyle& m_style;
 
     PolygonBuilder m_builder;
 
-    MeshData<V> m_meshData;
+    std::vector<StyledPolygon> m_polygons;
+
+    // Mesh data per tessellation chunk
+    std::vector<MeshData<V>> m_meshData;
 
     float m_tileUnitsPerMeter;
     int m_zoom;
@@ -125,12 +199,44 @@ private:
 
 template <class V>
 std::unique_ptr<StyledMesh> PolygonStyleBuilder<V>::build() {
-    if (m_meshData.vertices.empty()) { return nullptr; }
+    if (m_polygons.empty()) { return nullptr; }
+
+    // Tessellate consecutive chunks of polygons concurrently for large tiles.
+    // Chunks are compiled in order so the mesh does not depend on scheduling.
+    std::vector<size_t> points;
+    points.reserve(m_polygons.size());
+    for (auto& p : m_polygons) {
+        size_t n = 0;
+        for (auto& ring : *p.polygon) { n += ring.size(); }
+        points.push_back(n);
+    }
+
+    auto chunks = Parallel::split(points, min_chunk_points);
+    m_meshData.resize(chunks.size());
+
+    Parallel::forEachChunk(chunks, [&](size_t i, Parallel::Chunk chunk) {
+        PolygonBuilder builder;
+        builder.useTexCoords = m_builder.useTexCoords;
+        // Keep the buffers of the shared builder for the common case
+        auto& b = (i == 0) ? m_builder : builder;
+
+        for (size_t j = chunk.begin; j < chunk.end; j++) {
+            buildPolygon(m_polygons[j], b, m_meshData[i]);
+        }
+    });
+    m_polygons.clear();
+
+    size_t vertices = 0;
+    for (auto& m : m_meshData) { vertices += m.vertices.size(); }
+
+    std::unique_ptr<Mesh<V>> mesh;
+    if (vertices > 0) {
+        mesh = std::make_unique<Mesh<V>>(m_style.vertexLayout(), m_style.drawMode());
+        mesh->setRetainData(m_style.retainMeshData());
+        mesh->compile(m_meshData);
+    }
 
-    auto mesh = std::make_unique<Mesh<V>>(m_style.vertexLayout(),
-                                                      m_style.drawMode());
-    mesh->compile(m_meshData);
-    m_meshData.clear();
+    for (auto& m : m_meshData) { m.clear(); }
 
     return std::move(mesh);
 }
@@ -156,29 +262,48 @@ void PolygonStyleBuilder<V>::addPolygon(const Polygon& _polygon, const Propertie
 
     parseRule(_rule, _props);
 
-    m_builder.addVertex = [this](const glm::vec3& coord,
-                                 const glm::vec3& normal,
-                                 const glm::vec2& uv) {
-        m_meshData.vertices.push_back({ coord, m_params.order, normal, uv, m_params.color });
+    m_polygons.push_back({ &_polygon, m_params.order, m_params.color,
+                           m_params.height, m_params.minHeight });
+}
+
+template <class V>
+void PolygonStyleBuilder<V>::buildPolygon(const StyledPolygon& _polygon, PolygonBuilder& _builder,
+                                          MeshData<V>& _mesh) {
+
+    auto addVertex = [&](const glm::vec3& coord,
+                         const glm::vec3& normal,
+                         const glm::vec2& uv) {
+        _mesh.vertices.push_back({ coord, _polygon.order, normal, uv, _polygon.color });
     };
 
-    if (m_params.minHeight != m_params.height) {
-        Builders::buildPolygonExtrusion(_polygon, m_params.minHeight,
-                                        m_params.height, m_builder);
+    if (_polygon.minHeight != _polygon.height) {
+        Builders::buildPolygonExtrusion(*_polygon.polygon, _polygon.minHeight,
+                                        _polygon.height, _builder, addVertex);
     }
 
-    Builders::buildPolygon(_polygon, m_params.height, m_builder);
+    Builders::buildPolygon(*_polygon.polygon, _polygon.height, _builder, addVertex);
 
-    m_meshData.indices.insert(m_meshData.indices.end(),
-                              m_builder.indices.begin(),
-                              m_builder.indices.end());
+    _mesh.indices.insert(_mesh.indices.end(),
+                         _builder.indices.begin(),
+                         _builder.indices.end());
 
-    m_meshData.offsets.emplace_back(m_builder.indices.size(),
-                                    m_builder.numVertices);
-    m_builder.clear();
+    _mesh.offsets.emplace_back(_builder.indices.size(),
+                               _builder.numVertices);
+    _builder.clear();
 }
 
 std::unique_ptr<StyleBuilder> PolygonStyle::createBuilder() const {
+    if (compactVertices()) {
+        if (m_texCoordsGeneration) {
+            auto builder = std::make_unique<PolygonStyleBuilder<PolygonVertexCompact>>(*this);
+            builder->polygonBuilder().useTexCoords = true;
+            return std::move(builder);
+        }
+        auto builder = std::make_unique<PolygonStyleBuilder<PolygonVertexCompactNoUVs>>(*this);
+        builder->polygonBuilder().useTexCoords = false;
+        return std::move(builder);
+    }
+
     if (m_texCoordsGeneration) {
         auto builder = std::make_unique<PolygonStyleBuilder<PolygonVertex>>(*this);
         builder->polygonBuilder().useTexCoords = true;
@@ -18,6 +18,18 @@ public:
     virtual std::unique_ptr<StyleBuilder> createBuilder() const override;
     virtual ~PolygonStyle() {}
 
+    /* Use the compact vertex layout with octahedral encoded normals. It saves
+     * two bytes per vertex, but its 14 and 18 byte strides are not 4-byte
+     * aligned, which some GLES drivers handle slowly, so it is opt-in.
+     * Styles that draw rasters always use the default layout. Must be set
+     * before the style is built */
+    void setCompactVertices(bool _compact) { m_compactVertices = _compact; }
+    bool compactVertices() const { return m_compactVertices && !hasRasters(); }
+
+protected:
+
+    bool m_compactVertices = false;
+
 };
 
 }
@@ -11,14 +11,19 @@
 #include "util/builders.h"
 #include "util/mapProjection.h"
 #include "util/extrude.h"
+#include "util/parallel.h"
 
 #include "glm/vec3.hpp"
 #include "glm/gtc/type_precision.hpp"
 
+#include <algorithm>
+
 constexpr float extrusion_scale = 4096.0f;
 constexpr float position_scale = 8192.0f;
 constexpr float texture_scale = 8192.0f;
 constexpr float order_scale = 2.0f;
+// Minimum number of line points per tessellation thread
+constexpr size_t min_chunk_points = 8192;
 
 namespace Tangram {
 
@@ -125,13 +130,13 @@ public:
     std::unique_ptr<StyledMesh> build() override;
 
     PolylineStyleBuilder(const PolylineStyle& _style)
-        : StyleBuilder(_style), m_style(_style),
-          m_meshData(2) {}
+        : StyleBuilder(_style), m_style(_style) {}
 
-    void addMesh(const Line& _line, const Parameters& _params);
+    void addMesh(const Line& _line, const Parameters& _params, PolyLineBuilder& _builder,
+                 MeshData<V>& _fill, MeshData<V>& _stroke);
 
     void buildLine(const Line& _line, const typename Parameters::Attributes& _att,
-                   MeshData<V>& _mesh);
+                   PolyLineBuilder& _builder, MeshData<V>& _mesh);
 
     Parameters parseRule(const DrawRule& _rule, const Properties& _props);
 
@@ -141,9 +146,18 @@ public:
 
 private:
 
+    // Line with the parameters of its rule, tessellated in build()
+    struct StyledLine {
+        const Line* line;
+        Parameters params;
+    };
+
     const PolylineStyle& m_style;
     PolyLineBuilder m_builder;
 
+    std::vector<StyledLine> m_lines;
+
+    // Fill mesh data per tessellation chunk, followed by the outline mesh data
     std::vector<MeshData<V>> m_meshData;
 
     float m_tileUnitsPerMeter;
@@ -169,26 +183,52 @@ void PolylineStyleBuilder<V>::setup(const Tile& tile) {
 
 template <class V>
 std::unique_ptr<StyledMesh> PolylineStyleBuilder<V>::build() {
-    if (m_meshData[0].vertices.empty() &&
-        m_meshData[1].vertices.empty()) {
-        return nullptr;
-    }
+    if (m_lines.empty()) { return nullptr; }
+
+    // Tessellate consecutive chunks of lines concurrently for large tiles.
+    // Chunks are compiled in order so the mesh does not depend on scheduling.
+    std::vector<size_t> points;
+    points.reserve(m_lines.size());
+    for (auto& l : m_lines) { points.push_back(l.line->size()); }
+
+    auto chunks = Parallel::split(points, min_chunk_points);
+    size_t nChunks = chunks.size();
+    m_meshData.resize(2 * nChunks);
+
+    Parallel::forEachChunk(chunks, [&](size_t i, Parallel::Chunk chunk) {
+        PolyLineBuilder builder;
+        builder.useTexCoords = m_builder.useTexCoords;
+        // Keep the buffers of the shared builder for the common case
+        auto& b = (i == 0) ? m_builder : builder;
+
+        for (size_t j = chunk.begin; j < chunk.end; j++) {
+            addMesh(*m_lines[j].line, m_lines[j].params, b,
+                    m_meshData[i], m_meshData[nChunks + i]);
+        }
+    });
+    m_lines.clear();
+
+    size_t vertices = 0;
+    for (auto& m : m_meshData) { vertices += m.vertices.size(); }
 
-    auto mesh = std::make_unique<Mesh<V>>(m_style.vertexLayout(), m_style.drawMode());
+    std::unique_ptr<Mesh<V>> mesh;
+    if (vertices > 0) {
+        mesh = std::make_unique<Mesh<V>>(m_style.vertexLayout(), m_style.drawMode());
+        mesh->setRetainData(m_style.retainMeshData());
 
-    bool painterMode = (m_style.blendMode() == Blending::overlay ||
-                        m_style.blendMode() == Blending::inlay);
+        bool painterMode = (m_style.blendMode() == Blending::overlay ||
+                            m_style.blendMode() == Blending::inlay);
 
-    // Swap draw order to draw outline first when not using depth testing
-    if (painterMode) { std::swap(m_meshData[0], m_meshData[1]); }
+        auto outlines = m_meshData.begin() + nChunks;
 
-    mesh->compile(m_meshData);
+        // Swap draw order to draw outline first when not using depth testing
+        if (painterMode) { std::rotate(m_meshData.begin(), outlines, m_meshData.end()); }
+
+        mesh->compile(m_meshData);
+    }
 
-    // Swapping back since fill mesh may have more vertices than outline
-    if (painterMode) { std::swap(m_meshData[0], m_meshData[1]); }
+    for (auto& m : m_meshData) { m.clear(); }
 
-    m_meshData[0].clear();
-    m_meshData[1].clear();
     return std::move(mesh);
 }
 
@@ -337,14 +377,14 @@ void PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
         params.keepTileEdges = true;
 
         for (auto& line : _feat.lines) {
-            addMesh(line, params);
+            m_lines.push_back({ &line, params });
         }
     } else {
         params.closedPolygon = true;
 
         for (auto& polygon : _feat.polygons) {
             for (const auto& line : polygon) {
-                addMesh(line, params);
+                m_lines.push_back({ &line, params });
             }
         }
     }
@@ -352,37 +392,39 @@ void PolylineStyleBuilder<V>::addFeature(const Feature& _feat, const DrawRule& _
 
 template <class V>
 void PolylineStyleBuilder<V>::buildLine(const Line& _line, const typename Parameters::Attributes& _att,
-                        MeshData<V>& _mesh) {
+                        PolyLineBuilder& _builder, MeshData<V>& _mesh) {
 
-    m_builder.addVertex = [&_mesh, &_att](const glm::vec3& coord,
-                                   const glm::vec2& normal,
-                                   const glm::vec2& uv) {
+    auto addVertex = [&_mesh, &_att](const glm::vec3& coord,
+                                     const glm::vec2& normal,
+                                     const glm::vec2& uv) {
         _mesh.vertices.push_back({{ coord.x,coord.y }, normal, uv,
                               _att.width, _att.height, _att.color});
     };
 
-    Builders::buildPolyLine(_line, m_builder);
+    Builders::buildPolyLine(_line, _builder, addVertex);
 
     _mesh.indices.insert(_mesh.indices.end(),
-                         m_builder.indices.begin(),
-                         m_builder.indices.end());
+                         _builder.indices.begin(),
+                         _builder.indices.end());
 
-    _mesh.offsets.emplace_back(m_builder.indices.size(),
-                               m_builder.numVertices);
+    _mesh.offsets.emplace_back(_builder.indices.size(),
+                               _builder.numVertices);
 
-    m_builder.clear();
+    _builder.clear();
 }
 
 template <class V>
-void PolylineStyleBuilder<V>::addMesh(const Line& _line, const Parameters& _params) {
+void PolylineStyleBuilder<V>::addMesh(const Line& _line, const Parameters& _params,
+                                      PolyLineBuilder& _builder,
+                                      MeshData<V>& _fill, MeshData<V>& _stroke) {
 
-    m_builder.cap = _params.fill.cap;
-    m_builder.join = _params.fill.join;
-    m_builder.miterLimit = _params.fill.miterLimit;
-    m_builder.keepTileEdges = _params.keepTileEdges;
-    m_builder.closedPolygon = _params.closedPolygon;
+    _builder.cap = _params.fill.cap;
+    _builder.join = _params.fill.join;
+    _builder.miterLimit = _params.fill.miterLimit;
+    _builder.keepTileEdges = _params.keepTileEdges;
+    _builder.closedPolygon = _params.closedPolygon;
 
-    if (_params.lineOn) { buildLine(_line, _params.fill, m_meshData[0]); }
+    if (_params.lineOn) { buildLine(_line, _params.fill, _builder, _fill); }
 
     if (!_params.outlineOn) { return; }
 
@@ -391,15 +433,15 @@ void PolylineStyleBuilder<V>::addMesh(const Line& _line, const Parameters& _para
         _params.stroke.join != _params.fill.join ||
         _params.stroke.miterLimit != _params.fill.miterLimit) {
         // need to re-triangulate with different cap and/or join
-        m_builder.cap = _params.stroke.cap;
-        m_builder.join = _params.stroke.join;
-        m_builder.miterLimit = _params.stroke.miterLimit;
+        _builder.cap = _params.stroke.cap;
+        _builder.join = _params.stroke.join;
+        _builder.miterLimit = _params.stroke.miterLimit;
 
-        buildLine(_line, _params.stroke, m_meshData[1]);
+        buildLine(_line, _params.stroke, _builder, _stroke);
 
     } else {
-        auto& fill = m_meshData[0];
-        auto& stroke = m_meshData[1];
+        auto& fill = _fill;
+        auto& stroke = _stroke;
 
         // reuse indices from original line, overriding color and width
         size_t nIndices = fill.offsets.back().first;
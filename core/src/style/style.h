@@ -50,6 +50,14 @@ struct StyledMesh {
     virtual bool draw(ShaderProgram& _shader) = 0;
     virtual size_t bufferSize() const = 0;
 
+    /* Bytes of bufferSize() held in client memory and in GL buffers */
+    virtual size_t clientBufferSize() const { return 0; }
+    virtual size_t gpuBufferSize() const { return 0; }
+
+    /* Whether the GL buffers were lost with the GL context and the mesh has
+     * no data left to upload them again */
+    virtual bool needsRebuild() const { return false; }
+
     virtual ~StyledMesh() {}
 };
 
@@ -73,7 +81,9 @@ public:
     /* Build styled vertex data for polygon geometry */
     virtual void addPolygon(const Polygon& _polygon, const Properties& _props, const DrawRule& _rule);
 
-    /* Create a new mesh object using the vertex layout corresponding to this style */
+    /* Create a new mesh object using the vertex layout corresponding to this style.
+     * Builders may defer work on the geometry passed to addFeature() until build(),
+     * so that geometry must stay valid until then */
     virtual std::unique_ptr<StyledMesh> build() = 0;
 
     virtual bool checkRule(const DrawRule& _rule) const;
@@ -128,6 +138,9 @@ protected:
     /* Whether the style should generate texture coordinates */
     bool m_texCoordsGeneration = false;
 
+    /* Keep compiled mesh data in client memory after upload */
+    bool m_retainMeshData = false;
+
     /* Set uniform values when @_updateUniforms is true,
      */
     void setupShaderUniforms(Scene& _scene);
@@ -251,6 +264,13 @@ public:
 
     bool genTexCoords() const { return m_texCoordsGeneration; }
 
+    /* By default the client side copy of static tile meshes is released once
+     * the mesh is uploaded. Tiles are then built again from the raw tile data
+     * when the GL context is lost. With @_retain meshes of this style keep
+     * their copy and are uploaded again instead */
+    void setRetainMeshData(bool _retain) { m_retainMeshData = _retain; }
+    bool retainMeshData() const { return m_retainMeshData; }
+
     void setID(uint32_t _id) { m_id = _id; }
 
     std::shared_ptr<Material> getMaterial() { return m_material.material; }
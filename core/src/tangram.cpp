@@ -7,6 +7,7 @@
 #include "style/material.h"
 #include "style/style.h"
 #include "labels/labels.h"
+#include "marker/markerManager.h"
 #include "tile/tileManager.h"
 #include "tile/tile.h"
 #include "gl/error.h"
@@ -17,6 +18,7 @@
 #include "tile/tileCache.h"
 #include "view/view.h"
 #include "data/clientGeoJsonSource.h"
+#include "data/diskTileCache.h"
 #include "gl.h"
 #include "gl/hardware.h"
 #include "util/ease.h"
@@ -28,10 +30,11 @@
 #include <bitset>
 #include <mutex>
 #include <queue>
+#include <thread>
 
 namespace Tangram {
 
-const static size_t MAX_WORKERS = 2;
+const static uint32_t DEFAULT_WORKERS = 2;
 
 std::mutex m_tilesMutex;
 std::mutex m_tasksMutex;
@@ -41,8 +44,10 @@ std::unique_ptr<TileManager> m_tileManager;
 std::shared_ptr<Scene> m_scene;
 std::shared_ptr<View> m_view;
 std::unique_ptr<Labels> m_labels;
+std::unique_ptr<MarkerManager> m_markerManager;
 std::unique_ptr<Skybox> m_skybox;
 std::unique_ptr<InputHandler> m_inputHandler;
+std::shared_ptr<DiskTileCache> m_diskCache;
 
 std::array<Ease, 4> m_eases;
 enum class EaseField { position, zoom, rotation, tilt };
@@ -57,6 +62,10 @@ void clearEase(EaseField _f) {
 
 static float g_time = 0.0;
 static std::bitset<8> g_flags = 0;
+static uint32_t g_workerCount = DEFAULT_WORKERS;
+static bool g_progressiveBuild = false;
+static std::vector<TileTaskScheduler::Reservation> g_sourceWorkers;
+static uint64_t g_tileMemoryBudget = 64*1024*1024;
 
 void initialize(const char* _scenePath) {
 
@@ -77,13 +86,16 @@ void initialize(const char* _scenePath) {
     m_inputHandler = std::make_unique<InputHandler>(m_view);
 
     // Instantiate workers
-    m_tileWorker = std::make_unique<TileWorker>(MAX_WORKERS);
+    m_tileWorker = std::make_unique<TileWorker>(g_workerCount, g_sourceWorkers);
+    m_tileWorker->setProgressiveBuild(g_progressiveBuild);
 
     // Create a tileManager
     m_tileManager = std::make_unique<TileManager>(*m_tileWorker);
+    m_tileManager->setMemoryBudget(g_tileMemoryBudget);
 
     // Label setup
     m_labels = std::make_unique<Labels>();
+    m_markerManager = std::make_unique<MarkerManager>();
 
     loadScene(_scenePath);
 
@@ -99,8 +111,15 @@ void setScene(std::shared_ptr<Scene>& _scene) {
     m_scene = _scene;
     m_view = _scene->view();
     m_inputHandler->setView(m_view);
+    for (auto& source : _scene->getAllDataSources()) {
+        source->setDiskCache(m_diskCache);
+    }
     m_tileManager->setDataSources(_scene->getAllDataSources());
     m_tileWorker->setScene(_scene);
+    {
+        std::lock_guard<std::mutex> lock(m_tilesMutex);
+        m_markerManager->setScene(_scene);
+    }
     setPixelScale(m_view->pixelScale());
 
     bool animated = m_scene->animated() == Scene::animate::yes;
@@ -216,17 +235,21 @@ bool update(float _dt) {
 
         auto& tiles = m_tileManager->getVisibleTiles();
 
+        bool markersChanged = m_markerManager->update(*m_view);
+
         if (m_view->changedOnLastUpdate() ||
-            m_tileManager->hasTileSetChanged()) {
+            m_tileManager->hasTileSetChanged() ||
+            markersChanged) {
 
             for (const auto& tile : tiles) {
                 tile->update(_dt, *m_view);
             }
             m_labels->updateLabelSet(*m_view, _dt, m_scene->styles(), tiles,
-                                     m_tileManager->getTileCache());
+                                     m_tileManager->getTileCache(), m_markerManager.get());
 
         } else {
-            m_labels->updateLabels(*m_view, _dt, m_scene->styles(), tiles);
+            m_labels->updateLabels(*m_view, _dt, m_scene->styles(), tiles, true,
+                                   m_markerManager.get());
         }
     }
 
@@ -276,7 +299,7 @@ void render() {
 
     m_labels->drawDebug(*m_view);
 
-    FrameInfo::draw(*m_view, *m_tileManager);
+    FrameInfo::draw(*m_view, *m_tileManager, m_scene->fontContext().get());
 
     while (Error::hadGlError("Tangram::render()")) {}
 }
@@ -431,6 +454,7 @@ void setPixelScale(float _pixelsPerPoint) {
 void addDataSource(std::shared_ptr<DataSource> _source) {
     if (!m_tileManager) { return; }
     std::lock_guard<std::mutex> lock(m_tilesMutex);
+    _source->setDiskCache(m_diskCache);
     m_scene->addClientDataSource(_source);
     m_tileManager->addDataSource(_source);
 }
@@ -452,6 +476,124 @@ void clearDataSource(DataSource& _source, bool _data, bool _tiles) {
     requestRender();
 }
 
+// Apply a change to the markers, requesting one render for all changes
+// until the next update
+template<typename F>
+static bool changeMarkers(F _change) {
+    if (!m_markerManager) { return false; }
+    std::lock_guard<std::mutex> lock(m_tilesMutex);
+
+    bool pending = m_markerManager->hasChanges();
+    bool changed = _change(*m_markerManager);
+
+    if (changed && !pending) { requestRender(); }
+    return changed;
+}
+
+MarkerID addMarker() {
+    MarkerID id = 0;
+    changeMarkers([&](MarkerManager& _markers) {
+        id = _markers.add();
+        return true;
+    });
+    return id;
+}
+
+bool removeMarker(MarkerID _marker) {
+    return changeMarkers([&](MarkerManager& _markers) {
+        return _markers.remove(_marker);
+    });
+}
+
+bool setMarkerPosition(MarkerID _marker, double _lon, double _lat) {
+    return changeMarkers([&](MarkerManager& _markers) {
+        glm::dvec2 meters = m_view->getMapProjection().LonLatToMeters({ _lon, _lat });
+        return _markers.setPosition(_marker, meters);
+    });
+}
+
+bool setMarkerStyle(MarkerID _marker, const MarkerStyle& _style) {
+    return changeMarkers([&](MarkerManager& _markers) {
+        return _markers.setStyle(_marker, _style);
+    });
+}
+
+bool setMarkerVisible(MarkerID _marker, bool _visible) {
+    return changeMarkers([&](MarkerManager& _markers) {
+        return _markers.setVisible(_marker, _visible);
+    });
+}
+
+void setTileDiskCache(const char* _path, uint64_t _maxSize, uint32_t _maxAge) {
+
+    if (_path && _path[0] != '\0') {
+        m_diskCache = std::make_shared<DiskTileCache>(_path, _maxSize, _maxAge);
+    } else {
+        m_diskCache.reset();
+    }
+
+    if (m_scene) {
+        for (auto& source : m_scene->getAllDataSources()) {
+            source->setDiskCache(m_diskCache);
+        }
+    }
+}
+
+void setWorkerCount(uint32_t _count) {
+
+    if (_count == 0) {
+        _count = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    g_workerCount = _count;
+
+    if (m_tileWorker) {
+        m_tileWorker->setWorkerCount(g_workerCount);
+    }
+}
+
+uint32_t getWorkerCount() {
+    return g_workerCount;
+}
+
+void setSourceWorkers(const char* _sourceName, uint32_t _count) {
+
+    // Keep the reservations for workers created by initialize()
+    TileWorker::updateReservations(g_sourceWorkers, _sourceName, _count);
+
+    if (m_tileWorker) {
+        m_tileWorker->setSourceWorkers(_sourceName, _count);
+    }
+}
+
+std::vector<WorkerInfo> getWorkerInfo() {
+    if (!m_tileWorker) { return {}; }
+    return m_tileWorker->getWorkerInfo();
+}
+
+void setTileMemoryBudget(uint64_t _bytes) {
+    g_tileMemoryBudget = _bytes;
+
+    if (m_tileManager) {
+        std::lock_guard<std::mutex> lock(m_tilesMutex);
+        m_tileManager->setMemoryBudget(_bytes);
+    }
+}
+
+TileMemoryInfo getTileMemoryInfo() {
+    if (!m_tileManager) { return TileMemoryInfo{ g_tileMemoryBudget }; }
+
+    std::lock_guard<std::mutex> lock(m_tilesMutex);
+    return m_tileManager->getMemoryInfo();
+}
+
+void setProgressiveTileBuild(bool _enable) {
+    g_progressiveBuild = _enable;
+
+    if (m_tileWorker) {
+        m_tileWorker->setProgressiveBuild(_enable);
+    }
+}
+
 void handleTapGesture(float _posX, float _posY) {
 
     m_inputHandler->handleTapGesture(_posX, _posY);
@@ -2,6 +2,7 @@
 
 #include "data/properties.h"
 #include "util/ease.h"
+#include <cstdint>
 #include <memory>
 #include <vector>
 #include <string>
@@ -101,6 +102,106 @@ bool removeDataSource(DataSource& _source);
 
 void clearDataSource(DataSource& _source, bool _data, bool _tiles);
 
+// Persistently cache raw tile data of all data sources in the directory at the
+// given path, using at most _maxSize bytes; entries older than _maxAge seconds
+// are requested again (0 keeps entries until they are evicted). An empty path
+// disables the cache
+void setTileDiskCache(const char* _path, uint64_t _maxSize, uint32_t _maxAge = 0);
+
+// Set the number of threads that build tiles; 0 uses one thread per hardware
+// thread. Defaults to 2, may be called before initialize()
+void setWorkerCount(uint32_t _count);
+
+// Get the number of threads that build tiles
+uint32_t getWorkerCount();
+
+// Reserve a number of the tile building threads for the data source with the
+// given name, so that tiles of other sources do not wait behind tiles of
+// expensive sources; reserved threads still build tiles of other sources when
+// idle. A count of 0 removes the reservation
+void setSourceWorkers(const char* _sourceName, uint32_t _count);
+
+struct WorkerInfo {
+    // Name of the data source this worker is reserved for, empty if shared
+    std::string source;
+    // Number of tiles built by this worker
+    uint64_t tasks;
+    // Seconds spent building tiles and seconds since the worker was started,
+    // busyTime / upTime gives the utilization of the worker
+    double busyTime;
+    double upTime;
+};
+
+// Get utilization counters of the tile building threads
+std::vector<WorkerInfo> getWorkerInfo();
+
+// Set the number of bytes of tile geometry that is kept in memory, covering
+// visible tiles, proxy tiles shown while tiles load and cached tiles. Cached
+// tiles are evicted first, then proxy tiles, those far from the view first.
+// Defaults to 64MB, may be called before initialize()
+void setTileMemoryBudget(uint64_t _bytes);
+
+struct TileMemoryInfo {
+    // The budget set with setTileMemoryBudget()
+    uint64_t budget;
+    // Bytes of geometry of visible, proxy and cached tiles, these count
+    // against the budget
+    uint64_t visibleTiles;
+    uint64_t proxyTiles;
+    uint64_t cachedTiles;
+    // Bytes of the geometry of all these tiles in client memory, i.e. not yet
+    // uploaded, and in GL buffers
+    uint64_t clientBuffers;
+    uint64_t gpuBuffers;
+    // Bytes of raster textures used by these tiles
+    uint64_t rasterTextures;
+};
+
+// Get the current memory usage of tiles
+TileMemoryInfo getTileMemoryInfo();
+
+// Build tiles in stages - polygons, lines, then points and labels - and draw
+// each stage as soon as it is finished instead of waiting for the whole tile.
+// Disabled by default, may be called before initialize()
+void setProgressiveTileBuild(bool _enable);
+
+// Markers are points that are drawn with a point style of the scene and
+// collide with its labels, but that are not part of any data source; they
+// can be moved, restyled and hidden without building tiles again
+using MarkerID = uint32_t;
+
+struct MarkerStyle {
+    // Name of the point style that draws the marker
+    std::string style = "points";
+    // Sprite in the sprite atlas of the style, unused without an atlas
+    std::string sprite;
+    // Color in ABGR format
+    uint32_t color = 0xffffffff;
+    // Size in logical pixels; 0 uses the size of the sprite
+    float width = 0;
+    float height = 0;
+    // Markers and labels with a lower priority value are placed first
+    float priority = 0;
+    // Whether the marker is hidden where it overlaps labels or markers that
+    // are placed before it
+    bool collide = true;
+};
+
+// Add a marker, it is shown once its position is set; returns its ID
+MarkerID addMarker();
+
+// Remove a marker; returns false if no marker with the given ID exists
+bool removeMarker(MarkerID _marker);
+
+// Set the position of a marker in degrees longitude and latitude
+bool setMarkerPosition(MarkerID _marker, double _lon, double _lat);
+
+// Set the style of a marker, see MarkerStyle
+bool setMarkerStyle(MarkerID _marker, const MarkerStyle& _style);
+
+// Show or hide a marker
+bool setMarkerVisible(MarkerID _marker, bool _visible);
+
 // Respond to a tap at the given screen coordinates (x right, y down)
 void handleTapGesture(float _posX, float _posY);
 
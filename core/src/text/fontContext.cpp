@@ -28,7 +28,10 @@ namespace Tangram {
 FontContext::FontContext() :
     m_sdfRadius(SDF_WIDTH),
     m_atlas(*this, GlyphTexture::size, m_sdfRadius),
-    m_batch(m_atlas, m_scratch) {
+    m_batch(m_atlas, m_scratch),
+    m_layouts(max_cached_layouts) {
+
+    for (auto& count : m_atlasRefCount) { count = 0; }
 
 // TODO: make this platform independent
 #if defined(PLATFORM_ANDROID)
@@ -151,11 +154,15 @@ void FontContext::releaseAtlas(std::bitset<max_textures> _refs) {
     for (size_t i = 0; i < m_textures.size(); i++) {
         if (!_refs[i]) { continue; }
 
-        if (--m_atlasRefCount[i] == 0) {
-            LOGD("CLEAR ATLAS %d", i);
-            m_atlas.clear(i);
-            m_textures[i].texData.assign(GlyphTexture::size * GlyphTexture::size, 0);
-        }
+        if (--m_atlasRefCount[i] != 0) { continue; }
+
+        // Cached layouts can add references until they are removed
+        m_layouts.removeIf([&](const TextLayout& _layout) { return _layout.atlases[i]; });
+        if (m_atlasRefCount[i] != 0) { continue; }
+
+        LOGD("CLEAR ATLAS %d", i);
+        m_atlas.clear(i);
+        m_textures[i].texData.assign(GlyphTexture::size * GlyphTexture::size, 0);
     }
 }
 
@@ -180,63 +187,95 @@ void FontContext::bindTexture(alfons::AtlasID _id, GLuint _unit) {
 bool FontContext::layoutText(TextStyle::Parameters& _params, const std::string& _text,
                              std::vector<GlyphQuad>& _quads, std::bitset<max_textures>& _refs, glm::vec2& _size) {
 
-    std::lock_guard<std::mutex> lock(m_mutex);
+    TextLayoutKey key { _text, _params.font.get(), _params.fontScale, _params.lineSpacing,
+                        _params.maxLineWidth, _params.wordWrap, _params.align };
 
-    alfons::LineLayout line = m_shaper.shape(_params.font, _text);
+    // The layouts of an atlas are removed before it is cleared, so while a
+    // layout is found its atlases are in use and references can be added
+    // without m_mutex.
+    bool cached = m_layouts.get(key, [&](const TextLayout& _layout) {
+        _quads.insert(_quads.end(), _layout.quads.begin(), _layout.quads.end());
 
-    if (line.shapes().size() == 0) {
-        LOGD("Empty text line");
-        return false;
-    }
+        for (size_t i = 0; i < max_textures; i++) {
+            if (_layout.atlases[i] && !_refs[i]) {
+                _refs[i] = true;
+                m_atlasRefCount[i]++;
+            }
+        }
+        _size = _layout.size;
+    });
 
-    line.setScale(_params.fontScale);
+    if (cached) { return true; }
 
-    // m_batch.drawShapeRange() calls FontContext's TextureCallback for new glyphs
-    // and MeshCallback (drawGlyph) for vertex quads of each glyph in LineLayout.
+    TextLayout layout;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
 
-    m_scratch.quads = &_quads;
+        alfons::LineLayout line = m_shaper.shape(_params.font, _text);
 
-    size_t quadsStart = _quads.size();
-    alfons::LineMetrics metrics;
+        if (line.shapes().size() == 0) {
+            LOGD("Empty text line");
+            return false;
+        }
 
-    if (_params.wordWrap) {
-        m_textWrapper.draw(m_batch, line, MIN_LINE_WIDTH,
-                           _params.maxLineWidth, _params.align,
-                           _params.lineSpacing, metrics);
-    } else {
-        glm::vec2 position(0);
-        m_batch.drawShapeRange(line, 0, line.shapes().size(), position, metrics);
-    }
+        line.setScale(_params.fontScale);
 
-    // TextLabel parameter: Dimension
-    float width = metrics.aabb.z - metrics.aabb.x;
-    float height = metrics.aabb.w - metrics.aabb.y;
+        // m_batch.drawShapeRange() calls FontContext's TextureCallback for new glyphs
+        // and MeshCallback (drawGlyph) for vertex quads of each glyph in LineLayout.
 
-    // Offset to center all glyphs around 0/0
-    glm::vec2 offset((metrics.aabb.x + width * 0.5) * TextVertex::position_scale,
-                     (metrics.aabb.y + height * 0.5) * TextVertex::position_scale);
+        m_scratch.quads = &layout.quads;
 
-    auto it = _quads.begin() + quadsStart;
-    if (it == _quads.end()) {
-        // No glyphs added
-        return false;
-    }
+        alfons::LineMetrics metrics;
 
-    while (it != _quads.end()) {
+        if (_params.wordWrap) {
+            m_textWrapper.draw(m_batch, line, MIN_LINE_WIDTH,
+                               _params.maxLineWidth, _params.align,
+                               _params.lineSpacing, metrics);
+        } else {
+            glm::vec2 position(0);
+            m_batch.drawShapeRange(line, 0, line.shapes().size(), position, metrics);
+        }
+
+        if (layout.quads.empty()) {
+            // No glyphs added
+            return false;
+        }
+
+        // TextLabel parameter: Dimension
+        float width = metrics.aabb.z - metrics.aabb.x;
+        float height = metrics.aabb.w - metrics.aabb.y;
+
+        // Offset to center all glyphs around 0/0
+        glm::vec2 offset((metrics.aabb.x + width * 0.5) * TextVertex::position_scale,
+                         (metrics.aabb.y + height * 0.5) * TextVertex::position_scale);
 
-        if (!_refs[it->atlas]) {
-            _refs[it->atlas] = true;
-            m_atlasRefCount[it->atlas]++;
+        for (auto& quad : layout.quads) {
+            layout.atlases[quad.atlas] = true;
+
+            quad.quad[0].pos -= offset;
+            quad.quad[1].pos -= offset;
+            quad.quad[2].pos -= offset;
+            quad.quad[3].pos -= offset;
         }
 
-        it->quad[0].pos -= offset;
-        it->quad[1].pos -= offset;
-        it->quad[2].pos -= offset;
-        it->quad[3].pos -= offset;
-        ++it;
+        // Add references for the label. The cache holds none, so that atlases
+        // are cleared once their labels are gone.
+        for (size_t i = 0; i < max_textures; i++) {
+            if (layout.atlases[i] && !_refs[i]) {
+                _refs[i] = true;
+                m_atlasRefCount[i]++;
+            }
+        }
+
+        layout.size = glm::vec2(width, height);
     }
 
-    _size = glm::vec2(width, height);
+    _quads.insert(_quads.end(), layout.quads.begin(), layout.quads.end());
+    _size = layout.size;
+
+    // The label references keep the atlases from being cleared until the
+    // layout is in the cache
+    m_layouts.put(key, std::move(layout));
 
     return true;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "textUtil.h"
+#include "textLayoutCache.h"
 
 // For textParameters
 #include "style/textStyle.h"
@@ -16,6 +17,7 @@
 
 #include "gl/texture.h"
 
+#include <atomic>
 #include <bitset>
 #include <mutex>
 
@@ -47,6 +49,9 @@ public:
 
     static constexpr int max_textures = 64;
 
+    // Number of text layouts kept in the layout cache
+    static constexpr size_t max_cached_layouts = 4096;
+
     FontContext();
 
     /* Synchronized on m_mutex on tile-worker threads
@@ -81,9 +86,23 @@ public:
 
     float maxStrokeWidth() { return m_sdfRadius; }
 
+    /* Append the glyph quads of @_text to @_quads. Layouts are cached by text,
+     * font and layout parameters, so that repeated strings are only shaped and
+     * wrapped once. */
     bool layoutText(TextStyle::Parameters& _params, const std::string& _text,
                     std::vector<GlyphQuad>& _quads, std::bitset<max_textures>& _refs, glm::vec2& _bbox);
 
+    struct TextLayout {
+        std::vector<GlyphQuad> quads;
+        glm::vec2 size;
+        // Atlases of the quads, the layout is removed when one is cleared
+        std::bitset<max_textures> atlases;
+    };
+
+    using LayoutCacheStats = TextLayoutCache<TextLayout>::Stats;
+
+    LayoutCacheStats layoutCacheStats() { return m_layouts.stats(); }
+
     struct ScratchBuffer : public alfons::MeshCallback {
         void drawGlyph(const alfons::Quad& q, const alfons::AtlasGlyph& altasGlyph) override {}
         void drawGlyph(const alfons::Rect& q, const alfons::AtlasGlyph& atlasGlyph) override;
@@ -96,7 +115,9 @@ private:
     std::vector<unsigned char> m_sdfBuffer;
 
     std::mutex m_mutex;
-    std::array<int, max_textures> m_atlasRefCount = {{0}};
+    // References of the labels using an atlas. Only changed on m_mutex, except
+    // for the increments when a cached layout is used under the cache lock.
+    std::array<std::atomic<int>, max_textures> m_atlasRefCount;
     alfons::GlyphAtlas m_atlas;
 
     alfons::FontManager m_alfons;
@@ -112,6 +133,9 @@ private:
     // textures and a MeshCallback implemented by TextStyleBuilder for adding glyph quads.
     alfons::TextBatch m_batch;
     TextWrapper m_textWrapper;
+
+    // Synchronized on its own mutex
+    TextLayoutCache<TextLayout> m_layouts;
 };
 
 }
@@ -0,0 +1,171 @@
+#pragma once
+
+#include "labels/labelProperty.h"
+#include "util/hash.h"
+
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace alfons {
+class Font;
+}
+
+namespace Tangram {
+
+// Everything that the shaped and wrapped glyph quads of a text depend on
+struct TextLayoutKey {
+    std::string text;
+    const alfons::Font* font;
+    float fontScale;
+    float lineSpacing;
+    uint32_t maxLineWidth;
+    bool wordWrap;
+    TextLabelProperty::Align align;
+
+    bool operator==(const TextLayoutKey& _other) const {
+        return font == _other.font &&
+            fontScale == _other.fontScale &&
+            lineSpacing == _other.lineSpacing &&
+            maxLineWidth == _other.maxLineWidth &&
+            wordWrap == _other.wordWrap &&
+            align == _other.align &&
+            text == _other.text;
+    }
+};
+
+}
+
+namespace std {
+    template <>
+    struct hash<Tangram::TextLayoutKey> {
+        size_t operator()(const Tangram::TextLayoutKey& k) const {
+            std::size_t seed = 0;
+            hash_combine(seed, k.text);
+            hash_combine(seed, k.font);
+            hash_combine(seed, k.fontScale);
+            hash_combine(seed, k.lineSpacing);
+            hash_combine(seed, k.maxLineWidth);
+            hash_combine(seed, k.wordWrap);
+            hash_combine(seed, int(k.align));
+            return seed;
+        }
+    };
+}
+
+namespace Tangram {
+
+/* Thread-safe LRU cache for text layouts shared by all tiles
+ *
+ * Lookups only hold the cache mutex, so that builder threads that find a
+ * layout do not wait for others that are shaping text.
+ */
+template<typename Layout>
+class TextLayoutCache {
+
+    struct CacheEntry {
+        TextLayoutKey key;
+        Layout layout;
+    };
+
+    using CacheList = std::list<CacheEntry>;
+    using CacheMap = std::unordered_map<TextLayoutKey, typename CacheList::iterator>;
+
+public:
+
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        size_t entries;
+
+        float hitRate() const {
+            uint64_t lookups = hits + misses;
+            return lookups ? float(hits) / lookups : 0.f;
+        }
+    };
+
+    explicit TextLayoutCache(size_t _maxEntries) : m_maxEntries(_maxEntries) {}
+
+    /* Call @_fn with the layout for @_key while the cache is locked, so that
+     * the layout can not be evicted meanwhile. Returns false on a miss. */
+    template<typename F>
+    bool get(const TextLayoutKey& _key, F _fn) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_cacheMap.find(_key);
+        if (it == m_cacheMap.end()) {
+            m_misses++;
+            return false;
+        }
+        m_hits++;
+
+        // Move to the front of the eviction order
+        m_cacheList.splice(m_cacheList.begin(), m_cacheList, it->second);
+
+        _fn(it->second->layout);
+        return true;
+    }
+
+    /* Add @_layout for @_key. Returns the layouts that were evicted, or
+     * @_layout itself when another thread added the key meanwhile. */
+    std::vector<Layout> put(const TextLayoutKey& _key, Layout _layout) {
+        std::vector<Layout> evicted;
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if (m_cacheMap.find(_key) != m_cacheMap.end()) {
+            evicted.push_back(std::move(_layout));
+            return evicted;
+        }
+
+        m_cacheList.push_front({_key, std::move(_layout)});
+        m_cacheMap.emplace(_key, m_cacheList.begin());
+
+        while (m_cacheList.size() > m_maxEntries) {
+            auto& entry = m_cacheList.back();
+            evicted.push_back(std::move(entry.layout));
+            m_cacheMap.erase(entry.key);
+            m_cacheList.pop_back();
+        }
+        return evicted;
+    }
+
+    /* Remove the layouts for which @_pred returns true */
+    template<typename F>
+    size_t removeIf(F _pred) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        size_t removed = 0;
+        for (auto it = m_cacheList.begin(); it != m_cacheList.end();) {
+            if (_pred(it->layout)) {
+                m_cacheMap.erase(it->key);
+                it = m_cacheList.erase(it);
+                removed++;
+            } else {
+                ++it;
+            }
+        }
+        return removed;
+    }
+
+    Stats stats() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return { m_hits, m_misses, m_cacheList.size() };
+    }
+
+private:
+
+    std::mutex m_mutex;
+
+    CacheMap m_cacheMap;
+    CacheList m_cacheList;
+
+    size_t m_maxEntries;
+
+    uint64_t m_hits = 0;
+    uint64_t m_misses = 0;
+};
+
+}
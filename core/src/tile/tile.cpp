@@ -75,6 +75,9 @@ void Tile::setMesh(const Style& _style, std::unique_ptr<StyledMesh> _mesh) {
         m_geometry.resize(id+1);
     }
     m_geometry[_style.getID()] = std::move(_mesh);
+
+    // Recompute on next use
+    m_memoryUsage = 0;
 }
 
 const std::unique_ptr<StyledMesh>& Tile::getMesh(const Style& _style) const {
@@ -96,4 +99,27 @@ size_t Tile::getMemoryUsage() const {
     return m_memoryUsage;
 }
 
+size_t Tile::getClientMemoryUsage() const {
+    size_t usage = 0;
+    for (auto& entry : m_geometry) {
+        if (entry) { usage += entry->clientBufferSize(); }
+    }
+    return usage;
+}
+
+bool Tile::needsRebuild() const {
+    for (auto& entry : m_geometry) {
+        if (entry && entry->needsRebuild()) { return true; }
+    }
+    return false;
+}
+
+size_t Tile::getGpuMemoryUsage() const {
+    size_t usage = 0;
+    for (auto& entry : m_geometry) {
+        if (entry) { usage += entry->gpuBufferSize(); }
+    }
+    return usage;
+}
+
 }
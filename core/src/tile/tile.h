@@ -8,6 +8,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Tangram {
@@ -38,6 +39,9 @@ class Tile {
 
 public:
 
+    /* Meshes of a progressive build stage, see TileBuilder::buildStaged() */
+    using MeshList = std::vector<std::pair<const Style*, std::unique_ptr<StyledMesh>>>;
+
     Tile(TileID _id, const MapProjection& _projection, const DataSource* _source = nullptr);
 
 
@@ -80,8 +84,21 @@ public:
     /* Get the sum in bytes of static <Mesh>es */
     size_t getMemoryUsage() const;
 
+    /* Bytes of getMemoryUsage() in client memory, i.e. not yet uploaded,
+     * and in GL buffers */
+    size_t getClientMemoryUsage() const;
+    size_t getGpuMemoryUsage() const;
+
+    /* Whether meshes lost their GL buffers with the GL context and can not
+     * be uploaded again, i.e. the tile has to be built again */
+    bool needsRebuild() const;
+
     int64_t sourceGeneration() const { return m_sourceGeneration; }
 
+    /* Mark the tile as up to date with @_generation of its DataSource, when
+     * none of the changes since its own generation affect it */
+    void setSourceGeneration(int64_t _generation) { m_sourceGeneration = _generation; }
+
     int32_t sourceID() const { return m_sourceId; }
 
     bool isProxy() const { return m_proxyState; }
@@ -101,8 +118,8 @@ private:
     /* ID of the DataSource */
     const int32_t m_sourceId;
 
-    /* State of the DataSource for which this tile was created */
-    const int64_t m_sourceGeneration;
+    /* State of the DataSource for which this tile is valid */
+    int64_t m_sourceGeneration;
 
     bool m_proxyState = false;
 
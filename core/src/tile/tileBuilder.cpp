@@ -3,23 +3,44 @@
 #include "gl/mesh.h"
 
 #include "data/dataSource.h"
+#include "platform.h"
+#include "tangram.h"
 
 #include "scene/dataLayer.h"
 #include "scene/scene.h"
+#include "style/pointStyle.h"
+#include "style/polylineStyle.h"
 #include "style/style.h"
+#include "style/textStyle.h"
 #include "tile/tile.h"
 
+#include <chrono>
+
 
 namespace Tangram {
 
 TileBuilder::TileBuilder(std::shared_ptr<Scene> _scene)
-    : m_scene(_scene) {
+    : m_scene(_scene),
+      m_dataFilter(*this) {
 
     m_styleContext.initFunctions(*_scene);
 
     // Initialize StyleBuilders
     for (auto& style : _scene->styles()) {
         m_styleBuilder[style->getName()] = style->createBuilder();
+
+        Stage stage = polygons;
+        if (dynamic_cast<const PolylineStyle*>(style.get())) {
+            stage = lines;
+        } else if (dynamic_cast<const PointStyle*>(style.get()) ||
+                   dynamic_cast<const TextStyle*>(style.get())) {
+            stage = labels;
+        }
+
+        if (style->getID() >= m_styleStages.size()) {
+            m_styleStages.resize(style->getID() + 1, polygons);
+        }
+        m_styleStages[style->getID()] = stage;
     }
 }
 
@@ -32,19 +53,31 @@ StyleBuilder* TileBuilder::getStyleBuilder(const std::string& _name) {
     return it->second.get();
 }
 
-std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const DataSource& _source) {
+bool TileBuilder::isBuilding(const StyleBuilder& _styleBuilder) const {
+    if (m_stage == stage_count) { return true; }
+
+    uint32_t id = _styleBuilder.style().getID();
+    return id < m_styleStages.size() && m_styleStages[id] == m_stage;
+}
+
+std::shared_ptr<Tile> TileBuilder::beginBuild(TileID _tileID, const DataSource& _source) {
 
     auto tile = std::make_shared<Tile>(_tileID, *m_scene->mapProjection(), &_source);
 
     tile->initGeometry(m_scene->styles().size());
 
-    m_styleContext.setKeywordZoom(_tileID.s);
+    beginTile(_tileID);
 
     for (auto& builder : m_styleBuilder) {
         if (builder.second)
             builder.second->setup(*tile);
     }
 
+    return tile;
+}
+
+void TileBuilder::addFeatures(const TileData& _tileData, const DataSource& _source) {
+
     for (const auto& datalayer : m_scene->layers()) {
 
         if (datalayer.source() != _source.name()) { continue; }
@@ -64,12 +97,133 @@ std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileDa
             }
         }
     }
+}
+
+std::shared_ptr<Tile> TileBuilder::build(TileID _tileID, const TileData& _tileData, const DataSource& _source) {
+
+    auto tile = beginBuild(_tileID, _source);
+
+    addFeatures(_tileData, _source);
 
     for (auto& builder : m_styleBuilder) {
         tile->setMesh(builder.second->style(), builder.second->build());
     }
 
+    logCacheStats(_tileID);
+
+    return tile;
+}
+
+std::shared_ptr<Tile> TileBuilder::buildStaged(TileID _tileID, const TileData& _tileData,
+                                               const DataSource& _source,
+                                               const StageCallback& _stageCallback) {
+
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    Clock::time_point firstStage;
+
+    auto tile = beginBuild(_tileID, _source);
+
+    // Features are matched once per stage, repeated matches are mostly
+    // served by the DrawRule cache
+    for (int stage = 0; stage < stage_count; stage++) {
+        m_stage = static_cast<Stage>(stage);
+
+        addFeatures(_tileData, _source);
+
+        Tile::MeshList meshes;
+        for (auto& builder : m_styleBuilder) {
+            if (!isBuilding(*builder.second)) { continue; }
+            meshes.emplace_back(&builder.second->style(), builder.second->build());
+        }
+
+        if (stage == 0) { firstStage = Clock::now(); }
+
+        // Builders of later stages did not get any features yet
+        if (!_stageCallback(tile, std::move(meshes))) {
+            tile.reset();
+            break;
+        }
+    }
+    m_stage = stage_count;
+
+    if (tile && Tangram::getDebugFlag(DebugFlags::tangram_infos)) {
+        using ms = std::chrono::duration<double, std::milli>;
+        LOG("Tile %s: first stage after %.3fms, built after %.3fms", _tileID.toString().c_str(),
+            ms(firstStage - start).count(), ms(Clock::now() - start).count());
+    }
+
+    logCacheStats(_tileID);
+
     return tile;
 }
 
+void TileBuilder::logCacheStats(TileID _tileID) {
+
+    if (Tangram::getDebugFlag(DebugFlags::tangram_infos)) {
+        const auto& stats = m_ruleSet.cacheStats();
+        uint32_t total = stats.hits + stats.misses;
+        LOG("Tile %s: draw rule cache %u/%u hits (%.0f%%), saved %.3fms",
+            _tileID.toString().c_str(), stats.hits, total,
+            total > 0 ? 100.0 * stats.hits / total : 0.0,
+            stats.savedTime() * 1000.0);
+    }
+}
+
+void TileBuilder::beginTile(TileID _tileID) {
+
+    m_styleContext.setKeywordZoom(_tileID.s);
+
+    // Matches are memoized per tile, i.e. for the keyword zoom of the tile
+    if (!(_tileID == m_cacheTile)) {
+        m_ruleSet.clearCache();
+        m_ruleSet.setMeasureTime(Tangram::getDebugFlag(DebugFlags::tangram_infos));
+        m_cacheTile = _tileID;
+    }
+}
+
+TileDataFilter& TileBuilder::dataFilter(TileID _tileID, const DataSource& _source) {
+
+    beginTile(_tileID);
+    m_dataFilter.setSource(_source);
+
+    return m_dataFilter;
+}
+
+void TileBuilder::DataFilter::setSource(const DataSource& _source) {
+
+    m_sourceLayers.clear();
+    m_collectionLayers.clear();
+
+    for (const auto& datalayer : m_builder.m_scene->layers()) {
+        if (datalayer.source() == _source.name()) {
+            m_sourceLayers.push_back(&datalayer);
+        }
+    }
+}
+
+bool TileBuilder::DataFilter::collection(const std::string& _name) {
+
+    m_collectionLayers.clear();
+
+    // Same selection as in build()
+    for (auto* datalayer : m_sourceLayers) {
+        const auto& dlc = datalayer->collections();
+        if (_name.empty() || std::find(dlc.begin(), dlc.end(), _name) != dlc.end()) {
+            m_collectionLayers.push_back(datalayer);
+        }
+    }
+    return !m_collectionLayers.empty();
+}
+
+bool TileBuilder::DataFilter::feature(const Feature& _feature) {
+
+    for (auto* datalayer : m_collectionLayers) {
+        if (m_builder.m_ruleSet.match(_feature, *datalayer, m_builder.m_styleContext)) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }
@@ -1,8 +1,12 @@
 #pragma once
 
 #include "data/dataSource.h"
+#include "data/tileData.h"
 #include "scene/styleContext.h"
 #include "scene/drawRule.h"
+#include "tile/tile.h"
+
+#include <functional>
 
 namespace Tangram {
 
@@ -24,15 +28,84 @@ public:
 
     std::shared_ptr<Tile> build(TileID _tileID, const TileData& _data, const DataSource& _source);
 
+    /* Called with the tile and the meshes of each finished stage, returns
+     * false to abort the build */
+    using StageCallback = std::function<bool(std::shared_ptr<Tile>&, Tile::MeshList&&)>;
+
+    /* Build the tile in stages - polygons, lines, then points and labels - and
+     * pass the meshes of each stage to @_stageCallback as soon as the stage is
+     * finished, so that the tile can be shown before it is complete. The meshes
+     * are not set on the returned tile. Returns null when aborted. */
+    std::shared_ptr<Tile> buildStaged(TileID _tileID, const TileData& _data, const DataSource& _source,
+                                      const StageCallback& _stageCallback);
+
+    /* Use buildStaged() in TileTask::process */
+    void setProgressive(bool _progressive) { m_progressive = _progressive; }
+    bool isProgressive() const { return m_progressive; }
+
+    /* Whether features are currently built with @_styleBuilder */
+    bool isBuilding(const StyleBuilder& _styleBuilder) const;
+
+    /* Returns a filter for DataSource::parseFiltered that selects the collections
+     * and features of @_source which match a DataLayer at the zoom of @_tileID */
+    TileDataFilter& dataFilter(TileID _tileID, const DataSource& _source);
+
     const Scene& scene() const { return *m_scene; }
 
 private:
+
+    enum Stage : uint8_t {
+        polygons = 0,
+        lines,
+        labels,
+        stage_count,
+    };
+
+    // Prepare the StyleContext and DrawRule cache for @_tileID
+    void beginTile(TileID _tileID);
+
+    // Create the tile and set up all StyleBuilders for it
+    std::shared_ptr<Tile> beginBuild(TileID _tileID, const DataSource& _source);
+
+    // Apply draw rules to all features of @_data for the current stage
+    void addFeatures(const TileData& _data, const DataSource& _source);
+
+    void logCacheStats(TileID _tileID);
+
+    class DataFilter : public TileDataFilter {
+    public:
+        DataFilter(TileBuilder& _builder) : m_builder(_builder) {}
+
+        void setSource(const DataSource& _source);
+
+        bool collection(const std::string& _name) override;
+        bool feature(const Feature& _feature) override;
+
+    private:
+        TileBuilder& m_builder;
+        // DataLayers of the current source and of the current collection
+        std::vector<const DataLayer*> m_sourceLayers;
+        std::vector<const DataLayer*> m_collectionLayers;
+    };
+
     std::shared_ptr<Scene> m_scene;
 
     StyleContext m_styleContext;
     DrawRuleMergeSet m_ruleSet;
 
     fastmap<std::string, std::unique_ptr<StyleBuilder>> m_styleBuilder;
+
+    DataFilter m_dataFilter;
+
+    // Tile for which m_ruleSet holds memoized matches
+    TileID m_cacheTile = { -1, -1, -1 };
+
+    // Build stage of each Style by Style ID and the stage being built,
+    // stage_count when building all stages at once
+    std::vector<Stage> m_styleStages;
+    Stage m_stage = stage_count;
+
+    bool m_progressive = false;
 };
 
 }
@@ -0,0 +1,105 @@
+#include "tile/tileCache.h"
+
+#include "platform.h"
+
+#include "glm/gtx/norm.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Tangram {
+
+std::vector<TileCacheKey> TileCache::put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
+    TileCacheKey k(_sourceId, _tile->getID());
+
+    m_cacheList.push_front({k, _tile});
+    m_cacheMap[k] = m_cacheList.begin();
+    m_cacheUsage += _tile->getMemoryUsage();
+
+    return limitCacheSize(m_cacheMaxUsage);
+}
+
+std::shared_ptr<Tile> TileCache::get(int32_t _sourceId, TileID _tileId) {
+    std::shared_ptr<Tile> tile;
+    TileCacheKey k(_sourceId, _tileId);
+
+    auto it = m_cacheMap.find(k);
+    if (it != m_cacheMap.end()) {
+        std::swap(tile, (*(it->second)).tile);
+        m_cacheList.erase(it->second);
+        m_cacheMap.erase(it);
+        m_cacheUsage -= tile->getMemoryUsage();
+    }
+    return tile;
+}
+
+std::shared_ptr<Tile> TileCache::contains(int32_t _source, TileID _tileID) {
+    TileCacheKey k(_source, _tileID);
+
+    auto it = m_cacheMap.find(k);
+    if (it != m_cacheMap.end()) {
+        return it->second->tile;
+    }
+    return nullptr;
+}
+
+void TileCache::setView(const glm::dvec2& _center, float _zoom) {
+    m_hasView = true;
+    m_viewCenter = _center;
+    m_viewZoom = _zoom;
+}
+
+double TileCache::score(const Tile& _tile) const {
+    glm::dvec2 center = _tile.getOrigin() + glm::dvec2(_tile.getScale() * 0.5);
+    double scaleDiv = exp2(_tile.getID().z - m_viewZoom);
+    if (scaleDiv < 1) { scaleDiv = 0.1 / scaleDiv; } // keep parent tiles longer
+    return glm::length2(center - m_viewCenter) * scaleDiv;
+}
+
+std::vector<TileCacheKey> TileCache::limitCacheSize(size_t _cacheSizeBytes) {
+    std::vector<TileCacheKey> poppedTiles;
+    m_cacheMaxUsage = _cacheSizeBytes;
+
+    if (m_cacheUsage <= m_cacheMaxUsage) { return poppedTiles; }
+
+    auto evict = [&](CacheList::iterator _it) {
+        poppedTiles.push_back(_it->key);
+        m_cacheUsage -= _it->tile->getMemoryUsage();
+        m_cacheMap.erase(_it->key);
+        m_cacheList.erase(_it);
+    };
+
+    if (m_hasView) {
+        std::vector<std::pair<double, CacheList::iterator>> order;
+        order.reserve(m_cacheList.size());
+        for (auto it = m_cacheList.begin(); it != m_cacheList.end(); ++it) {
+            order.emplace_back(score(*it->tile), it);
+        }
+        std::sort(order.begin(), order.end(),
+                  [](auto& a, auto& b) { return a.first > b.first; });
+
+        for (auto& entry : order) {
+            if (m_cacheUsage <= m_cacheMaxUsage) { break; }
+            evict(entry.second);
+        }
+    }
+
+    while (m_cacheUsage > m_cacheMaxUsage) {
+        if (m_cacheList.empty()) {
+            LOGE("Invalid cache state!");
+            m_cacheUsage = 0;
+            break;
+        }
+        evict(std::prev(m_cacheList.end()));
+    }
+
+    return poppedTiles;
+}
+
+void TileCache::clear() {
+    m_cacheMap.clear();
+    m_cacheList.clear();
+    m_cacheUsage = 0;
+}
+
+}
@@ -4,9 +4,12 @@
 #include "tile/tileHash.h"
 #include "tile/tileID.h"
 
+#include "glm/vec2.hpp"
+
 #include <unordered_map>
 #include <list>
 #include <memory>
+#include <vector>
 
 namespace Tangram {
 // TileSet serial + TileID
@@ -27,6 +30,13 @@ namespace std {
 
 namespace Tangram {
 
+/* Cache for <Tile>s that are not in the current view
+ *
+ * Usage is accounted in bytes of tile meshes. Without a view the least
+ * recently used tiles are evicted first, with a view those that are farthest
+ * from it, weighted by the difference to the view zoom like the load priority
+ * in <TileManager>.
+ */
 class TileCache {
     struct CacheEntry {
         TileCacheKey key;
@@ -38,84 +48,50 @@ class TileCache {
 
 public:
 
-    TileCache(size_t _cacheSizeMB) :
+    TileCache(size_t _cacheSizeBytes) :
         m_cacheUsage(0),
-        m_cacheMaxUsage(_cacheSizeMB) {}
+        m_cacheMaxUsage(_cacheSizeBytes) {}
 
-    std::vector<TileID> put(int32_t _sourceId, std::shared_ptr<Tile> _tile) {
-        TileCacheKey k(_sourceId, _tile->getID());
+    /* Add @_tile and evict tiles over the size limit, returns the evicted tiles */
+    std::vector<TileCacheKey> put(int32_t _sourceId, std::shared_ptr<Tile> _tile);
 
-        m_cacheList.push_front({k, _tile});
-        m_cacheMap[k] = m_cacheList.begin();
-        m_cacheUsage += _tile->getMemoryUsage();
+    /* Remove the tile from the cache and return it */
+    std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId);
 
-        return limitCacheSize(m_cacheMaxUsage);
-    }
+    std::shared_ptr<Tile> contains(int32_t _source, TileID _tileID);
 
-    std::shared_ptr<Tile> get(int32_t _sourceId, TileID _tileId) {
-        std::shared_ptr<Tile> tile;
-        TileCacheKey k(_sourceId, _tileId);
-
-        auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            std::swap(tile, (*(it->second)).tile);
-            m_cacheList.erase(it->second);
-            m_cacheMap.erase(it);
-            m_cacheUsage -= tile->getMemoryUsage();
-        }
-        return tile;
-    }
+    /* Evict tiles until at most @_cacheSizeBytes are used, returns the evicted tiles */
+    std::vector<TileCacheKey> limitCacheSize(size_t _cacheSizeBytes);
 
-    std::shared_ptr<Tile> contains(int32_t _source, TileID _tileID) {
-        std::shared_ptr<Tile> tile;
-        TileCacheKey k(_source, _tileID);
+    /* Set the view center in projection units and the zoom for eviction */
+    void setView(const glm::dvec2& _center, float _zoom);
 
-        auto it = m_cacheMap.find(k);
-        if (it != m_cacheMap.end()) {
-            return it->second->tile;
-        }
-        return nullptr;
-    }
+    size_t getMemoryUsage() const { return m_cacheUsage; }
 
-    std::vector<TileID> limitCacheSize(size_t _cacheSizeBytes) {
-        std::vector<TileID> poppedTileIDs;
-        m_cacheMaxUsage = _cacheSizeBytes;
-
-        while (m_cacheUsage > m_cacheMaxUsage) {
-            if (m_cacheList.empty()) {
-                LOGE("Invalid cache state!");
-                m_cacheUsage = 0;
-                break;
-            }
-            auto& tile = m_cacheList.back().tile;
-            poppedTileIDs.push_back(tile->getID());
-            m_cacheUsage -= tile->getMemoryUsage();
-            m_cacheMap.erase(m_cacheList.back().key);
-            m_cacheList.pop_back();
-        }
-        return poppedTileIDs;
-    }
+    size_t getMaxUsage() const { return m_cacheMaxUsage; }
 
-    size_t getMemoryUsage() const {
-        size_t sum = 0;
-        for (auto& entry : m_cacheList) {
-            sum += entry.tile->getMemoryUsage();
-        }
-        return sum;
+    /* Call @_fn for each cached tile */
+    template<typename F>
+    void forEach(F _fn) const {
+        for (auto& entry : m_cacheList) { _fn(*entry.tile); }
     }
 
-    void clear() {
-        m_cacheMap.clear();
-        m_cacheList.clear();
-        m_cacheUsage = 0;
-    }
+    void clear();
 
 private:
+
+    // Eviction order, higher scores are evicted first
+    double score(const Tile& _tile) const;
+
     CacheMap m_cacheMap;
     CacheList m_cacheList;
 
-    int m_cacheUsage;
-    int m_cacheMaxUsage;
+    size_t m_cacheUsage;
+    size_t m_cacheMaxUsage;
+
+    bool m_hasView = false;
+    glm::dvec2 m_viewCenter;
+    float m_viewZoom = 0;
 };
 
 }
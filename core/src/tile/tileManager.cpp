@@ -1,7 +1,9 @@
 #include "tileManager.h"
 
 #include "data/dataSource.h"
+#include "gl/renderState.h"
 #include "platform.h"
+#include "tangram.h"
 #include "tile/tile.h"
 #include "tileCache.h"
 #include "util/mapProjection.h"
@@ -9,6 +11,7 @@
 #include "glm/gtx/norm.hpp"
 
 #include <algorithm>
+#include <unordered_set>
 
 #define DBG(...) // LOGD(__VA_ARGS__)
 
@@ -16,7 +19,7 @@ namespace Tangram {
 
 TileManager::TileManager(TileTaskQueue& _tileWorker) : m_workers(_tileWorker) {
 
-    m_tileCache = std::unique_ptr<TileCache>(new TileCache(DEFAULT_CACHE_SIZE));
+    m_tileCache = std::unique_ptr<TileCache>(new TileCache(m_memoryBudget));
 
     // Callback to pass task from Download-Thread to Worker-Queue
     m_dataCallback = TileTaskCb{[this](std::shared_ptr<TileTask>&& task) {
@@ -119,12 +122,21 @@ void TileManager::updateTileSets(const ViewState& _view,
     m_loadPending = 0;
     m_tilesInProgress = 0;
 
+    checkRenderGeneration();
+
     for (auto& tileSet : m_tileSets) {
         updateTileSet(tileSet, _view, _visibleTiles);
     }
 
+    if (m_prioritiesChanged) {
+        m_workers.updatePriorities();
+        m_prioritiesChanged = false;
+    }
+
     loadTiles();
 
+    enforceMemoryBudget(_view);
+
     // Make m_tiles an unique list of tiles for rendering sorted from
     // high to low zoom-levels.
     std::sort(m_tiles.begin(), m_tiles.end(), [](auto& a, auto& b){
@@ -160,6 +172,7 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
 
             entry.tile = std::move(entry.task->tile());
             entry.task.reset();
+            entry.m_rebuild = false;
             newTiles = true;
 
             m_tileSetChanged = true;
@@ -180,8 +193,6 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
     auto curTilesIt = tiles.begin();
     auto visTilesIt = visibleTiles->begin();
 
-    auto generation = _tileSet.source->generation();
-
     while (visTilesIt != visibleTiles->end() || curTilesIt != tiles.end()) {
 
         auto& visTileId = visTilesIt == visibleTiles->end()
@@ -202,7 +213,7 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
                 m_tiles.push_back(entry.tile);
 
                 if (!entry.isLoading() &&
-                    (entry.tile->sourceGeneration() < generation)) {
+                    (isTileStale(_tileSet, visTileId, *entry.tile) || entry.m_rebuild)) {
                     // Tile needs update - enqueue for loading
                     enqueueTask(_tileSet, visTileId, _view);
                 }
@@ -213,14 +224,26 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
                         // check again for proxies
                         updateProxyTiles(_tileSet, visTileId, entry);
                     }
+                    // Show the finished stages of a progressive build on
+                    // top of the proxies. Rasters are only set on the tile
+                    // when it is complete.
+                    if (entry.task->subTasks().empty()) {
+                        if (entry.task->updatePartialTile()) {
+                            m_tileSetChanged = true;
+                        }
+                        if (auto& tile = entry.task->partialTile()) {
+                            m_tiles.push_back(tile);
+                        }
+                    }
                     m_tilesInProgress++;
                 } else if (!bool(entry.task) ||
                            (entry.rastersPending() > 0 && !entry.isCanceled()) ||
-                           (entry.isCanceled() && (entry.task->sourceGeneration() < generation))) {
+                           (entry.isCanceled() &&
+                            _tileSet.source->isTileStale(visTileId, entry.task->sourceGeneration()))) {
                     // Start loading when:
                     // no task is set,
                     // one of the raster for this task has not been loaded yet
-                    // or the task stems from an older tile source generation.
+                    // or the data of the tile changed since the task was created.
 
                     // Not yet available - enqueue for loading
                     enqueueTask(_tileSet, visTileId, _view);
@@ -315,8 +338,14 @@ void TileManager::updateTileSet(TileSet& _tileSet, const ViewState& _view,
             auto tileCenter = _view.mapProjection.TileCenter(id);
             double scaleDiv = exp2(id.z - _view.zoom);
             if (scaleDiv < 1) { scaleDiv = 0.1/scaleDiv; } // prefer parent tiles
-            task->setPriority(glm::length2(tileCenter - _view.center) * scaleDiv);
-            task->setProxyState(entry.getProxyCounter() > 0);
+            double priority = glm::length2(tileCenter - _view.center) * scaleDiv;
+            bool proxy = entry.getProxyCounter() > 0;
+
+            if (task->getPriority() != priority || task->isProxy() != proxy) {
+                task->setPriority(priority);
+                task->setProxyState(proxy);
+                m_prioritiesChanged = true;
+            }
 
             // Count tiles that are currently being downloaded to
             // limit download requests.
@@ -428,7 +457,7 @@ void TileManager::loadTiles() {
                 loadSubTasks(tileSet.source->rasterSources(), entry.task, tileId);
             } else {
                 // Set canceled state, so that tile will not be tried
-                // for reloading until sourceGeneration increased.
+                // for reloading until its data changed.
                 entry.task->cancel();
                 continue;
             }
@@ -447,7 +476,7 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
     auto tile = m_tileCache->get(_tileSet.source->id(), _tileID);
 
     if (tile) {
-        if (tile->sourceGeneration() == _tileSet.source->generation()) {
+        if (!isTileStale(_tileSet, _tileID, *tile)) {
             m_tiles.push_back(tile);
 
             // Update tile origin based on wrap (set in the new tileID)
@@ -474,6 +503,16 @@ bool TileManager::addTile(TileSet& _tileSet, const TileID& _tileID) {
     return bool(tile);
 }
 
+bool TileManager::isTileStale(const TileSet& _tileSet, const TileID& _tileID, Tile& _tile) {
+
+    if (_tile.sourceGeneration() >= _tileSet.sourceGeneration) { return false; }
+
+    if (_tileSet.source->isTileStale(_tileID, _tile.sourceGeneration())) { return true; }
+
+    _tile.setSourceGeneration(_tileSet.sourceGeneration);
+    return false;
+}
+
 void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::iterator& _tileIt) {
 
     auto& id = _tileIt->first;
@@ -489,10 +528,7 @@ void TileManager::removeTile(TileSet& _tileSet, std::map<TileID, TileEntry>::ite
 
     } else if (entry.isReady()) {
         // Add to cache
-        auto poppedTiles = m_tileCache->put(_tileSet.source->id(), entry.tile);
-        for (auto& tileID : poppedTiles) {
-            _tileSet.source->clearRaster(tileID);
-        }
+        clearEvictedRasters(m_tileCache->put(_tileSet.source->id(), entry.tile));
     }
 
     //remove tile from set
@@ -604,8 +640,136 @@ void TileManager::clearProxyTiles(TileSet& _tileSet, const TileID& _tileID, Tile
     }
 }
 
-void TileManager::setCacheSize(size_t _cacheSize) {
-    m_tileCache->limitCacheSize(_cacheSize);
+void TileManager::checkRenderGeneration() {
+
+    if (m_renderGeneration == RenderState::generation()) { return; }
+    m_renderGeneration = RenderState::generation();
+
+    // Load the tiles again, DataSources usually still have the raw data
+    for (auto& tileSet : m_tileSets) {
+        for (auto& it : tileSet.tiles) {
+            auto& entry = it.second;
+            if (entry.tile && entry.tile->needsRebuild()) {
+                entry.m_rebuild = true;
+            }
+        }
+    }
+
+    std::vector<TileCacheKey> lostTiles;
+    m_tileCache->forEach([&](const Tile& _tile) {
+            if (_tile.needsRebuild()) {
+                lostTiles.emplace_back(_tile.sourceID(), _tile.getID());
+            }
+        });
+    for (auto& key : lostTiles) {
+        m_tileCache->get(key.first, key.second);
+    }
+}
+
+void TileManager::clearEvictedRasters(const std::vector<TileCacheKey>& _evicted) {
+    for (auto& key : _evicted) {
+        for (auto& tileSet : m_tileSets) {
+            if (tileSet.source->id() == key.first) {
+                tileSet.source->clearRaster(key.second);
+                break;
+            }
+        }
+    }
+}
+
+void TileManager::enforceMemoryBudget(const ViewState& _view) {
+
+    m_tileCache->setView(_view.center, _view.zoom);
+
+    size_t usage = 0;
+    std::vector<std::tuple<double, TileSet*, TileID>> proxies;
+
+    for (auto& tileSet : m_tileSets) {
+        for (auto& it : tileSet.tiles) {
+            auto& entry = it.second;
+            if (!entry.isReady()) { continue; }
+
+            usage += entry.tile->getMemoryUsage();
+
+            if (!entry.isVisible()) {
+                // Same weighting as the load priority
+                auto tileCenter = _view.mapProjection.TileCenter(it.first);
+                double scaleDiv = exp2(it.first.z - _view.zoom);
+                if (scaleDiv < 1) { scaleDiv = 0.1/scaleDiv; }
+                proxies.emplace_back(glm::length2(tileCenter - _view.center) * scaleDiv,
+                                     &tileSet, it.first);
+            }
+        }
+    }
+
+    if (usage > m_memoryBudget && !proxies.empty()) {
+        std::sort(proxies.begin(), proxies.end(), [](auto& a, auto& b) {
+                return std::get<0>(a) > std::get<0>(b); });
+
+        for (auto& proxy : proxies) {
+            if (usage <= m_memoryBudget) { break; }
+
+            auto& tileSet = *std::get<1>(proxy);
+            auto it = tileSet.tiles.find(std::get<2>(proxy));
+            auto tile = it->second.tile;
+
+            DBG("drop proxy %s", it->first.toString().c_str());
+            usage -= tile->getMemoryUsage();
+            m_tiles.erase(std::remove(m_tiles.begin(), m_tiles.end(), tile), m_tiles.end());
+
+            // Tiles referencing the proxy keep their proxy flag, so that it
+            // will not be added again while it is loading.
+            removeTile(tileSet, it);
+        }
+        m_tileSetChanged = true;
+    }
+
+    size_t cacheSize = usage < m_memoryBudget ? m_memoryBudget - usage : 0;
+    clearEvictedRasters(m_tileCache->limitCacheSize(cacheSize));
+}
+
+void TileManager::setMemoryBudget(size_t _budget) {
+    m_memoryBudget = _budget;
+    clearEvictedRasters(m_tileCache->limitCacheSize(std::min(_budget, m_tileCache->getMaxUsage())));
+}
+
+TileMemoryInfo TileManager::getMemoryInfo() const {
+
+    TileMemoryInfo info{};
+    info.budget = m_memoryBudget;
+
+    std::unordered_set<const Texture*> textures;
+
+    auto addTile = [&](const Tile& _tile) {
+        info.clientBuffers += _tile.getClientMemoryUsage();
+        info.gpuBuffers += _tile.getGpuMemoryUsage();
+
+        // Rasters are shared between tiles
+        for (auto& raster : _tile.rasters()) {
+            if (raster.isValid() && textures.insert(raster.texture.get()).second) {
+                info.rasterTextures += raster.texture->bufferSize();
+            }
+        }
+    };
+
+    for (auto& tileSet : m_tileSets) {
+        for (auto& it : tileSet.tiles) {
+            auto& entry = it.second;
+            if (!entry.tile) { continue; }
+
+            if (entry.isVisible()) {
+                info.visibleTiles += entry.tile->getMemoryUsage();
+            } else {
+                info.proxyTiles += entry.tile->getMemoryUsage();
+            }
+            addTile(*entry.tile);
+        }
+    }
+
+    info.cachedTiles = m_tileCache->getMemoryUsage();
+    m_tileCache->forEach(addTile);
+
+    return info;
 }
 
 }
@@ -3,6 +3,7 @@
 #include "data/tileData.h"
 #include "tile/tileWorker.h"
 #include "tile/tile.h"
+#include "tile/tileCache.h"
 #include "tile/tileID.h"
 #include "tileTask.h"
 #include "util/fastmap.h"
@@ -18,7 +19,7 @@
 namespace Tangram {
 
 class DataSource;
-class TileCache;
+struct TileMemoryInfo;
 
 struct ViewState {
     const MapProjection& mapProjection;
@@ -34,7 +35,7 @@ struct ViewState {
  */
 class TileManager {
 
-    const static size_t DEFAULT_CACHE_SIZE = 32*1024*1024; // 32 MB
+    const static size_t DEFAULT_MEMORY_BUDGET = 64*1024*1024; // 64 MB
     const static int MAX_DOWNLOADS = 4;
 
 public:
@@ -68,10 +69,18 @@ public:
 
     const auto& getTileSets() { return m_tileSets; }
 
-    /* @_cacheSize: Set size of in-memory tile cache in bytes.
-     * This cache holds recently used <Tile>s that are ready for rendering.
+    /* @_budget: Set the size in bytes of tile meshes that are kept in memory:
+     * Visible and proxy tiles, and the tile cache which holds recently used
+     * <Tile>s that are ready for rendering. The cache gets what the visible
+     * and proxy tiles leave of the budget; when visible tiles alone exceed it
+     * proxy tiles are dropped, farthest from the view first.
      */
-    void setCacheSize(size_t _cacheSize);
+    void setMemoryBudget(size_t _budget);
+
+    size_t getMemoryBudget() const { return m_memoryBudget; }
+
+    /* Current memory usage of visible, proxy and cached tiles */
+    TileMemoryInfo getMemoryInfo() const;
 
 private:
 
@@ -166,6 +175,9 @@ private:
 
         bool m_visible = false;
 
+        /* Set when the tile lost its geometry with the GL context */
+        bool m_rebuild = false;
+
         /* Method to check whther this tile is in the current set of visible tiles
          * determined by view::updateTiles().
          */
@@ -199,6 +211,12 @@ private:
      */
     bool addTile(TileSet& _tileSet, const TileID& _tileID);
 
+    /*
+     * Whether @_tile has to be loaded again for changes of its DataSource.
+     * Tiles outside of the changed regions are marked as up to date.
+     */
+    bool isTileStale(const TileSet& _tileSet, const TileID& _tileID, Tile& _tile);
+
     /*
      * Removes a tile from m_tileSet
      */
@@ -217,6 +235,18 @@ private:
      */
     void clearProxyTiles(TileSet& _tileSet, const TileID& _tileID, TileEntry& _tile, std::vector<TileID>& _removes);
 
+    /*
+     * Limit the tile cache to the part of the memory budget that is not used
+     * by tiles in the tile sets and drop proxy tiles when these exceed it
+     */
+    void enforceMemoryBudget(const ViewState& _view);
+
+    /* Rebuild tiles that lost their geometry when the GL context was lost */
+    void checkRenderGeneration();
+
+    /* Clear the rasters of tiles evicted from the tile cache */
+    void clearEvictedRasters(const std::vector<TileCacheKey>& _evicted);
+
     int32_t m_loadPending = 0;
     int32_t m_tilesInProgress = 0;
 
@@ -227,10 +257,18 @@ private:
 
     std::unique_ptr<TileCache> m_tileCache;
 
+    size_t m_memoryBudget = DEFAULT_MEMORY_BUDGET;
+
+    /* RenderState generation of the tile geometry */
+    int m_renderGeneration = -1;
+
     TileTaskQueue& m_workers;
 
     bool m_tileSetChanged = false;
 
+    /* Set when the load priority of a pending task changed */
+    bool m_prioritiesChanged = false;
+
     /* Callback for DataSource:
      * Passes TileTask back with data for further processing by <TileWorker>s
      */
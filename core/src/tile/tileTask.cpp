@@ -4,6 +4,8 @@
 #include "scene/scene.h"
 #include "util/mapProjection.h"
 #include "tile/tile.h"
+#include "style/style.h"
+#include "platform.h"
 
 namespace Tangram {
 
@@ -14,19 +16,65 @@ TileTask::TileTask(TileID& _tileId, std::shared_ptr<DataSource> _source, int _su
     m_sourceGeneration(_source->generation()),
     m_priority(0) {}
 
+TileTask::~TileTask() {}
+
 void TileTask::process(TileBuilder& _tileBuilder) {
 
-    auto tileData = m_source->parse(*this, *_tileBuilder.scene().mapProjection());
+    auto& filter = _tileBuilder.dataFilter(m_tileId, *m_source);
+
+    auto tileData = m_source->parseFiltered(*this, *_tileBuilder.scene().mapProjection(), filter);
+
+    if (!tileData) {
+        cancel();
+        return;
+    }
 
-    if (tileData) {
+    if (!_tileBuilder.isProgressive()) {
         m_tile = _tileBuilder.build(m_tileId, *tileData, *m_source);
+        return;
+    }
+
+    auto tile = _tileBuilder.buildStaged(m_tileId, *tileData, *m_source,
+        [this](std::shared_ptr<Tile>& _tile, Tile::MeshList&& _meshes) {
+            {
+                std::lock_guard<std::mutex> lock(m_stageMutex);
+                m_stageTile = _tile;
+                for (auto& mesh : _meshes) {
+                    m_stageMeshes.push_back(std::move(mesh));
+                }
+            }
+            requestRender();
+            return !isCanceled();
+        });
+
+    if (tile) {
+        m_tile = std::move(tile);
     } else {
         cancel();
     }
 }
 
+bool TileTask::updatePartialTile() {
+
+    std::lock_guard<std::mutex> lock(m_stageMutex);
+
+    if (m_stageMeshes.empty()) { return false; }
+
+    m_partialTile = m_stageTile;
+    for (auto& mesh : m_stageMeshes) {
+        m_partialTile->setMesh(*mesh.first, std::move(mesh.second));
+    }
+    m_stageMeshes.clear();
+
+    return true;
+}
+
 void TileTask::complete() {
 
+    // Add the meshes of the last stages of a progressive build
+    updatePartialTile();
+    m_partialTile.reset();
+
     for (auto& subTask : m_subTasks) {
         assert(subTask->isReady());
         subTask->complete(*this);
@@ -1,8 +1,10 @@
 #pragma once
 
+#include "tile/tile.h"
 #include "tile/tileID.h"
 
 #include <memory>
+#include <mutex>
 #include <vector>
 #include <functional>
 #include <atomic>
@@ -12,7 +14,6 @@ namespace Tangram {
 class TileManager;
 class TileBuilder;
 class DataSource;
-class Tile;
 class MapProjection;
 struct TileData;
 
@@ -27,7 +28,7 @@ public:
     TileTask(const TileTask& _other) = delete;
     TileTask& operator=(const TileTask& _other) = delete;
 
-    virtual ~TileTask() {}
+    virtual ~TileTask();
 
     virtual bool hasData() const { return true; }
 
@@ -64,6 +65,13 @@ public:
     // running on main thread when the tile is added to
     virtual void complete();
 
+    // running on main thread: Add the meshes of finished stages of a
+    // progressive build to partialTile(), returns true when meshes were added
+    bool updatePartialTile();
+
+    // The tile of a progressive build while it is not ready, null otherwise
+    const std::shared_ptr<Tile>& partialTile() const { return m_partialTile; }
+
     // onDone for sub-tasks
     virtual void complete(TileTask& _mainTask) {}
 
@@ -86,6 +94,13 @@ protected:
 
     bool m_canceled = false;
 
+    // Progressive build: Meshes of finished stages wait in m_stageMeshes
+    // until they are added to the tile on the main thread
+    std::mutex m_stageMutex;
+    std::shared_ptr<Tile> m_stageTile;
+    Tile::MeshList m_stageMeshes;
+    std::shared_ptr<Tile> m_partialTile;
+
     std::atomic<double> m_priority;
     bool m_proxyState = false;
 };
@@ -104,6 +119,9 @@ public:
 
 struct TileTaskQueue {
     virtual void enqueue(std::shared_ptr<TileTask>&& task) = 0;
+
+    // Called after priorities of enqueued tasks have been updated
+    virtual void updatePriorities() {}
 };
 
 struct TileTaskCb {
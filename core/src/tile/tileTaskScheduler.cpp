@@ -0,0 +1,210 @@
+#include "tileTaskScheduler.h"
+
+#include "data/dataSource.h"
+#include "platform.h"
+
+#include <algorithm>
+
+namespace Tangram {
+
+TileTaskScheduler::TileTaskScheduler(size_t _numQueues, const std::vector<Reservation>& _reservations) :
+    m_size(0),
+    m_epoch(0) {
+
+    _numQueues = std::max<size_t>(_numQueues, 1);
+
+    auto addGroup = [this](const std::string& _source, size_t _begin, size_t _end) {
+        auto group = std::make_unique<Group>();
+        group->source = _source;
+        group->begin = _begin;
+        group->end = _end;
+        group->next = 0;
+        group->size = 0;
+
+        for (size_t i = _begin; i < _end; i++) {
+            m_queues.push_back(std::make_unique<Queue>());
+            m_queues.back()->group = m_groups.size();
+        }
+        m_groups.push_back(std::move(group));
+    };
+
+    size_t reserved = 0;
+    for (auto& reservation : _reservations) {
+        reserved += reservation.queues;
+    }
+
+    if (reserved >= _numQueues) {
+        LOGW("Cannot reserve %d of %d tile workers - need at least one shared worker",
+             int(reserved), int(_numQueues));
+        reserved = 0;
+    }
+
+    addGroup("", 0, _numQueues - reserved);
+
+    if (reserved > 0) {
+        for (auto& reservation : _reservations) {
+            if (reservation.queues == 0) { continue; }
+            size_t begin = m_queues.size();
+            addGroup(reservation.source, begin, begin + reservation.queues);
+        }
+    }
+}
+
+void TileTaskScheduler::push(std::shared_ptr<TileTask>&& _task) {
+
+    Group* group = m_groups[0].get();
+
+    for (size_t i = 1; i < m_groups.size(); i++) {
+        if (m_groups[i]->source == _task->source().name()) {
+            group = m_groups[i].get();
+            break;
+        }
+    }
+
+    size_t count = group->end - group->begin;
+    auto& queue = *m_queues[group->begin + (group->next++ % count)];
+    {
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.heap.emplace_back(std::move(_task));
+        std::push_heap(queue.heap.begin(), queue.heap.end());
+        group->size++;
+        m_size++;
+    }
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::popLocked(Queue& _queue) {
+
+    auto& heap = _queue.heap;
+    auto& group = *m_groups[_queue.group];
+
+    uint32_t epoch = m_epoch;
+    if (_queue.epoch != epoch) {
+        // Priorities changed since the heap was built: drop canceled tasks
+        // and rebuild the heap with current keys.
+        auto removes = std::remove_if(heap.begin(), heap.end(),
+                                      [](const auto& e) { return e.task->isCanceled(); });
+
+        size_t removed = std::distance(removes, heap.end());
+        group.size -= removed;
+        m_size -= removed;
+        heap.erase(removes, heap.end());
+
+        for (auto& entry : heap) { entry.update(); }
+        std::make_heap(heap.begin(), heap.end());
+
+        _queue.epoch = epoch;
+    }
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        auto task = std::move(heap.back().task);
+        heap.pop_back();
+        group.size--;
+        m_size--;
+
+        if (!task->isCanceled()) {
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::popGroup(Group& _group, size_t _first) {
+
+    if (_group.size == 0) { return nullptr; }
+
+    size_t count = _group.end - _group.begin;
+    size_t own = _group.begin + _first % count;
+
+    // Look into the own queue first
+    {
+        auto& queue = *m_queues[own];
+
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (auto task = popLocked(queue)) {
+            return task;
+        }
+    }
+
+    // Steal the best task of the other queues. Tops of stale heaps are
+    // compared with their old keys, popLocked() refreshes them.
+    while (_group.size > 0) {
+        Queue* best = nullptr;
+        Key bestKey;
+
+        for (size_t i = _group.begin; i < _group.end; i++) {
+            if (i == own) { continue; }
+
+            auto& queue = *m_queues[i];
+
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.heap.empty()) { continue; }
+
+            const Key& top = queue.heap.front();
+            if (!best || bestKey < top) {
+                best = &queue;
+                bestKey = top;
+            }
+        }
+
+        if (!best) { break; }
+
+        std::lock_guard<std::mutex> lock(best->mutex);
+        if (auto task = popLocked(*best)) {
+            return task;
+        }
+        // The queue was emptied meanwhile or held only canceled tasks
+    }
+    return nullptr;
+}
+
+std::shared_ptr<TileTask> TileTaskScheduler::pop(size_t _queue) {
+
+    _queue %= m_queues.size();
+
+    size_t groupId = m_queues[_queue]->group;
+    auto& group = *m_groups[groupId];
+
+    if (auto task = popGroup(group, _queue - group.begin)) {
+        return task;
+    }
+
+    if (groupId != 0) {
+        // Reserved queues help out with shared tasks
+        return popGroup(*m_groups[0], _queue);
+    }
+    return nullptr;
+}
+
+bool TileTaskScheduler::hasTasks(size_t _queue) const {
+
+    size_t groupId = m_queues[_queue % m_queues.size()]->group;
+
+    return m_groups[groupId]->size > 0 || m_groups[0]->size > 0;
+}
+
+const std::string& TileTaskScheduler::reservation(size_t _queue) const {
+    return m_groups[m_queues[_queue % m_queues.size()]->group]->source;
+}
+
+std::vector<std::shared_ptr<TileTask>> TileTaskScheduler::takeAll() {
+
+    std::vector<std::shared_ptr<TileTask>> tasks;
+
+    for (auto& queue : m_queues) {
+        std::lock_guard<std::mutex> lock(queue->mutex);
+        for (auto& entry : queue->heap) {
+            tasks.push_back(std::move(entry.task));
+        }
+        m_groups[queue->group]->size -= queue->heap.size();
+        m_size -= queue->heap.size();
+        queue->heap.clear();
+    }
+    return tasks;
+}
+
+void TileTaskScheduler::clear() {
+    takeAll();
+}
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include "tile/tileTask.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Tangram {
+
+/* Priority queue of <TileTask>s shared by a pool of workers
+ *
+ * Every worker owns one queue, a binary heap ordered by the task's proxy state,
+ * priority and source generation. Workers pop from their own queue and steal
+ * the best task of another queue when their own one runs empty, so that pops
+ * only contend when queues are unbalanced.
+ *
+ * The order is therefore relaxed: A pop returns the best task of the worker's
+ * own queue, which need not be the best task of all queues. Pushes are spread
+ * round-robin, so the urgent tiles of one frame end up at the tops of all
+ * queues and are started first, but there is no strict bound. A scheduler
+ * with a single queue pops in strict order. When the own queue is empty, a
+ * steal compares the tops of all other queues and takes the best one.
+ *
+ * TileTask priorities are updated by the TileManager while tasks are queued.
+ * The heap keys are snapshots of these values and are refreshed lazily on the
+ * next pop after reprioritize() was called. Canceled tasks are dropped lazily
+ * when they reach the top of a heap or when a heap is rebuilt.
+ *
+ * Queues can be reserved for the tasks of one DataSource (by name). Tasks of
+ * such a source only go to its reserved queues. Workers of reserved queues
+ * fall back to the shared queues when there are no tasks for their source,
+ * while workers of shared queues never take tasks of a reserved source.
+ */
+class TileTaskScheduler {
+
+public:
+
+    struct Reservation {
+        std::string source;
+        size_t queues;
+    };
+
+    /* The reserved queues are taken from @_numQueues, at least one shared
+     * queue is always kept */
+    TileTaskScheduler(size_t _numQueues, const std::vector<Reservation>& _reservations = {});
+
+    /* Add a task to one of the queues (round-robin) */
+    void push(std::shared_ptr<TileTask>&& _task);
+
+    /* Returns the highest priority task of queue @_queue or, when empty, the
+     * best task of all other queues of its group. Returns nullptr when no
+     * runnable task is left. */
+    std::shared_ptr<TileTask> pop(size_t _queue);
+
+    /* Mark the heap keys of all queued tasks as stale */
+    void reprioritize() { m_epoch++; }
+
+    /* Number of queued tasks, including canceled tasks not yet dropped */
+    size_t size() const { return m_size; }
+
+    bool empty() const { return m_size == 0; }
+
+    /* Whether a worker of queue @_queue could pop a task */
+    bool hasTasks(size_t _queue) const;
+
+    /* Source name queue @_queue is reserved for, or empty when shared */
+    const std::string& reservation(size_t _queue) const;
+
+    /* Remove and return all queued tasks */
+    std::vector<std::shared_ptr<TileTask>> takeAll();
+
+    void clear();
+
+    size_t numQueues() const { return m_queues.size(); }
+
+private:
+
+    struct Key {
+        bool proxy;
+        double priority;
+        int64_t generation;
+
+        // Heap comparator: true when 'this' has lower priority than _other
+        bool operator<(const Key& _other) const {
+            if (proxy != _other.proxy) { return proxy; }
+            if (priority != _other.priority) { return priority > _other.priority; }
+            return generation > _other.generation;
+        }
+    };
+
+    struct Entry : Key {
+        std::shared_ptr<TileTask> task;
+
+        Entry(std::shared_ptr<TileTask>&& _task) : task(std::move(_task)) { update(); }
+
+        void update() {
+            proxy = task->isProxy();
+            priority = task->getPriority();
+            generation = task->sourceGeneration();
+        }
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::vector<Entry> heap;
+        uint32_t epoch = 0;
+        size_t group = 0;
+    };
+
+    // Range of queues for one reservation, group 0 holds the shared queues
+    struct Group {
+        std::string source;
+        size_t begin;
+        size_t end;
+        std::atomic<size_t> next;
+        std::atomic<size_t> size;
+    };
+
+    // Returns the best non-canceled task of @_queue, must hold its mutex
+    std::shared_ptr<TileTask> popLocked(Queue& _queue);
+
+    std::shared_ptr<TileTask> popGroup(Group& _group, size_t _first);
+
+    std::vector<std::unique_ptr<Queue>> m_queues;
+    std::vector<std::unique_ptr<Group>> m_groups;
+
+    std::atomic<size_t> m_size;
+    std::atomic<uint32_t> m_epoch;
+};
+
+}
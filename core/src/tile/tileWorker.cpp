@@ -13,14 +13,14 @@
 
 namespace Tangram {
 
-TileWorker::TileWorker(int _num_worker) {
+TileWorker::TileWorker(int _num_worker, std::vector<TileTaskScheduler::Reservation> _reservations)
+    : m_numWorkers(std::max(_num_worker, 1)),
+      m_reservations(std::move(_reservations)) {
     m_running = true;
 
-    for (int i = 0; i < _num_worker; i++) {
-        auto worker = std::make_unique<Worker>();
-        worker->thread = std::thread(&TileWorker::run, this, worker.get());
-        m_workers.push_back(std::move(worker));
-    }
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue = std::make_unique<TileTaskScheduler>(m_numWorkers, m_reservations);
+    startWorkers();
 }
 
 TileWorker::~TileWorker(){
@@ -50,14 +50,8 @@ void TileWorker::run(Worker* instance) {
     std::unique_ptr<TileBuilder> builder;
 
     while (true) {
-
-        std::shared_ptr<TileTask> task;
         {
-            std::unique_lock<std::mutex> lock(m_mutex);
-
-            m_condition.wait(lock, [&, this]{
-                    return !m_running || !m_queue.empty();
-                });
+            std::unique_lock<std::mutex> lock(instance->mutex);
 
             if (instance->tileBuilder) {
                 disposeBuilder(std::move(builder));
@@ -67,86 +61,242 @@ void TileWorker::run(Worker* instance) {
             }
 
             // Check if thread should stop
-            if (!m_running) {
+            if (!m_running || instance->stop) {
                 disposeBuilder(std::move(builder));
                 break;
             }
+        }
 
-            if (!builder) {
-                LOGE("Missing Scene/StyleContext in TileWorker!");
-                continue;
-            }
-
-            // Remove all canceled tasks
-            auto removes = std::remove_if(m_queue.begin(), m_queue.end(),
-                                          [](const auto& a) { return a->isCanceled(); });
-
-            m_queue.erase(removes, m_queue.end());
-
-            if (m_queue.empty()) {
-                continue;
-            }
+        std::shared_ptr<TileTask> task;
 
-            // Pop highest priority tile from queue
-            auto it = std::min_element(m_queue.begin(), m_queue.end(),
-                [](const auto& a, const auto& b) {
-                    if (a->isProxy() != b->isProxy()) {
-                        return !a->isProxy();
-                    }
-                    if (a->source().id() == b->source().id() &&
-                        a->sourceGeneration() != b->sourceGeneration()) {
-                        return a->sourceGeneration() < b->sourceGeneration();
-                    }
-                    return a->getPriority() < b->getPriority();
-                });
-
-            task = std::move(*it);
-            m_queue.erase(it);
+        if (builder) {
+            // Pop highest priority tile from own queue or steal one from
+            // another worker. Canceled tasks are dropped on the way.
+            // m_queue is only replaced while all workers are stopped.
+            task = m_queue->pop(instance->id);
+        } else if (m_queue->hasTasks(instance->id)) {
+            LOGE("Missing Scene/StyleContext in TileWorker!");
         }
 
-        if (task->isCanceled()) {
+        if (!task) {
+            sleep(instance, bool(builder));
             continue;
         }
 
-        // const clock_t begin = clock();
+        auto begin = std::chrono::steady_clock::now();
 
+        builder->setProgressive(m_progressive);
         task->process(*builder);
 
-        // float loadTime = (float(clock() - begin) / CLOCKS_PER_SEC) * 1000;
-        // LOG("loadTime %s - %f", task->tileID.toString().c_str(), loadTime);
+        auto end = std::chrono::steady_clock::now();
+        instance->busyTime += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+        instance->tasks++;
 
         requestRender();
     }
 }
 
-void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
+void TileWorker::sleep(Worker* instance, bool _hasBuilder) {
+
+    std::unique_lock<std::mutex> lock(instance->mutex);
+
+    while (true) {
+        // Announce the wait before looking at the queue: enqueue() pushes
+        // before it looks for sleepers, so one of both sees the other.
+        instance->sleeping = true;
+
+        if (!m_running || instance->stop || instance->tileBuilder ||
+            (_hasBuilder && m_queue->hasTasks(instance->id))) {
+            break;
+        }
+        instance->condition.wait(lock);
+    }
+    instance->sleeping = false;
+}
+
+void TileWorker::wakeWorker() {
+
     for (auto& worker : m_workers) {
-        worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
+        // Only claim workers that may pop the new task, workers
+        // reserved for another source would go back to sleep
+        if (!m_queue->hasTasks(worker->id)) { continue; }
+
+        if (worker->sleeping.exchange(false)) {
+            // Taking the lock ensures that the worker either
+            // waits already or has not checked the queue yet
+            std::lock_guard<std::mutex> lock(worker->mutex);
+            worker->condition.notify_one();
+            return;
+        }
     }
 }
 
-void TileWorker::enqueue(std::shared_ptr<TileTask>&& task) {
+void TileWorker::startWorkers() {
+
+    auto scene = m_scene.lock();
+
+    for (int i = 0; i < m_numWorkers; i++) {
+        auto worker = std::make_unique<Worker>();
+        worker->id = i;
+        worker->started = std::chrono::steady_clock::now();
+        if (scene) {
+            worker->tileBuilder = std::make_unique<TileBuilder>(scene);
+        }
+        worker->thread = std::thread(&TileWorker::run, this, worker.get());
+        m_workers.push_back(std::move(worker));
+    }
+}
+
+void TileWorker::stopWorkers() {
     {
         std::unique_lock<std::mutex> lock(m_mutex);
-        if (!m_running) {
-            return;
+        for (auto& worker : m_workers) {
+            {
+                std::lock_guard<std::mutex> workerLock(worker->mutex);
+                worker->stop = true;
+            }
+            worker->condition.notify_one();
+        }
+    }
+
+    for (auto& worker : m_workers) {
+        worker->thread.join();
+    }
+
+    // enqueue() looks into m_workers to wake a sleeping worker
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_workers.clear();
+}
+
+void TileWorker::restart(int _num_worker, std::vector<TileTaskScheduler::Reservation> _reservations) {
+
+    if (!m_running) { return; }
+
+    stopWorkers();
+
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_numWorkers = _num_worker;
+        m_reservations = std::move(_reservations);
+
+        // Move pending tasks over to the new queues
+        auto tasks = m_queue->takeAll();
+        m_queue = std::make_unique<TileTaskScheduler>(m_numWorkers, m_reservations);
+        for (auto& task : tasks) {
+            m_queue->push(std::move(task));
+        }
+
+        startWorkers();
+    }
+}
+
+void TileWorker::setWorkerCount(int _num_worker) {
+
+    _num_worker = std::max(_num_worker, 1);
+
+    if (_num_worker == m_numWorkers) { return; }
+
+    restart(_num_worker, m_reservations);
+}
+
+bool TileWorker::updateReservations(std::vector<TileTaskScheduler::Reservation>& _reservations,
+                                    const std::string& _source, int _count) {
+
+    auto it = std::find_if(_reservations.begin(), _reservations.end(),
+                           [&](auto& r) { return r.source == _source; });
+
+    if (it != _reservations.end()) {
+        if (_count > 0) {
+            if (it->queues == size_t(_count)) { return false; }
+            it->queues = _count;
+        } else {
+            _reservations.erase(it);
+        }
+    } else if (_count > 0) {
+        _reservations.push_back({ _source, size_t(_count) });
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void TileWorker::setSourceWorkers(const std::string& _source, int _count) {
+
+    auto reservations = m_reservations;
+
+    if (!updateReservations(reservations, _source, _count)) { return; }
+
+    restart(m_numWorkers, std::move(reservations));
+}
+
+std::vector<WorkerInfo> TileWorker::getWorkerInfo() {
+
+    std::vector<WorkerInfo> infos;
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto now = std::chrono::steady_clock::now();
+
+    for (auto& worker : m_workers) {
+        WorkerInfo info;
+        info.source = m_queue->reservation(worker->id);
+        info.tasks = worker->tasks;
+        info.busyTime = worker->busyTime / 1e6;
+        info.upTime = std::chrono::duration<double>(now - worker->started).count();
+        infos.push_back(info);
+    }
+    return infos;
+}
+
+void TileWorker::setScene(std::shared_ptr<Scene>& _scene) {
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_scene = _scene;
+
+    for (auto& worker : m_workers) {
+        {
+            std::lock_guard<std::mutex> workerLock(worker->mutex);
+            worker->tileBuilder = std::make_unique<TileBuilder>(_scene);
         }
-        m_queue.push_back(std::move(task));
+        worker->condition.notify_one();
+    }
+}
+
+void TileWorker::enqueue(std::shared_ptr<TileTask>&& task) {
+    // m_mutex only keeps m_queue and m_workers from being replaced here,
+    // running workers do not contend for it.
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        return;
     }
-    m_condition.notify_one();
+    m_queue->push(std::move(task));
+
+    wakeWorker();
+}
+
+void TileWorker::updatePriorities() {
+    // restart() replaces m_queue
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_queue->reprioritize();
 }
 
 void TileWorker::stop() {
     {
         std::unique_lock<std::mutex> lock(m_mutex);
         m_running = false;
-    }
 
-    m_condition.notify_all();
+        for (auto& worker : m_workers) {
+            // Lock so that the flag is not missed between the
+            // worker's check and its wait
+            { std::lock_guard<std::mutex> workerLock(worker->mutex); }
+            worker->condition.notify_one();
+        }
+    }
 
     for (auto& worker : m_workers) {
         worker->thread.join();
     }
+
+    m_queue->clear();
 }
 
 }
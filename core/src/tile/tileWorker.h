@@ -1,6 +1,7 @@
 #pragma once
 
 #include "tile/tileTask.h"
+#include "tile/tileTaskScheduler.h"
 
 #include <memory>
 #include <vector>
@@ -8,45 +9,109 @@
 #include <thread>
 #include <mutex>
 #include <atomic>
+#include <chrono>
+#include <string>
 
 namespace Tangram {
 
 class Scene;
 class TileBuilder;
+struct WorkerInfo;
 
 class TileWorker : public TileTaskQueue {
 
 public:
 
-    TileWorker(int _num_worker);
+    TileWorker(int _num_worker, std::vector<TileTaskScheduler::Reservation> _reservations = {});
 
     ~TileWorker();
 
     virtual void enqueue(std::shared_ptr<TileTask>&& task) override;
 
+    virtual void updatePriorities() override;
+
     void stop();
 
     bool isRunning() const { return m_running; }
 
     void setScene(std::shared_ptr<Scene>& _scene);
 
+    /* Restart the pool with @_num_worker threads, queued tasks are kept */
+    void setWorkerCount(int _num_worker);
+
+    int workerCount() const { return m_numWorkers; }
+
+    /* Reserve @_count of the workers for tasks of the DataSource named
+     * @_source; a count of 0 removes the reservation */
+    void setSourceWorkers(const std::string& _source, int _count);
+
+    /* Apply setSourceWorkers() to a list of reservations, returns
+     * false when the list is unchanged */
+    static bool updateReservations(std::vector<TileTaskScheduler::Reservation>& _reservations,
+                                   const std::string& _source, int _count);
+
+    std::vector<WorkerInfo> getWorkerInfo();
+
+    /* Build tiles in stages that are shown as soon as they are finished,
+     * see TileBuilder::buildStaged() */
+    void setProgressiveBuild(bool _progressive) { m_progressive = _progressive; }
+
 private:
 
     struct Worker {
+        size_t id;
         std::thread thread;
+
+        // Guards tileBuilder and stop, and puts the worker to sleep
+        // when there is nothing to pop
+        std::mutex mutex;
+        std::condition_variable condition;
         std::unique_ptr<TileBuilder> tileBuilder;
+        bool stop = false;
+
+        // Set while the worker is about to wait on its condition
+        std::atomic<bool> sleeping{false};
+
+        // Utilization counters
+        std::chrono::steady_clock::time_point started;
+        std::atomic<uint64_t> tasks{0};
+        std::atomic<uint64_t> busyTime{0}; // microseconds
     };
 
     void run(Worker* instance);
 
-    bool m_running;
+    // Block until there may be a task to pop, a new TileBuilder or a stop request
+    void sleep(Worker* instance, bool _hasBuilder);
 
-    std::vector<std::unique_ptr<Worker>> m_workers;
+    // Wake one sleeping worker that can take the tasks just pushed, must hold m_mutex
+    void wakeWorker();
 
-    std::condition_variable m_condition;
+    // Start m_numWorkers threads, must hold m_mutex
+    void startWorkers();
 
+    // Stop and join all threads, queued tasks are kept
+    void stopWorkers();
+
+    void restart(int _num_worker, std::vector<TileTaskScheduler::Reservation> _reservations);
+
+    std::atomic<bool> m_running;
+
+    std::atomic<bool> m_progressive{false};
+
+    int m_numWorkers;
+
+    std::vector<TileTaskScheduler::Reservation> m_reservations;
+
+    std::weak_ptr<Scene> m_scene;
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // Guards m_queue and m_workers replacement. Workers never take it
+    // while running: they pop through the queues' own locks and sleep
+    // on their own Worker::condition.
     std::mutex m_mutex;
-    std::vector<std::shared_ptr<TileTask>> m_queue;
+
+    std::unique_ptr<TileTaskScheduler> m_queue;
 
 };
 
@@ -0,0 +1,64 @@
+#include "arena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace Tangram {
+
+Arena::Arena(size_t _blockSize) : m_blockSize(_blockSize) {}
+
+Arena::~Arena() {
+    for (auto& block : m_blocks) {
+        ::operator delete(block.first);
+    }
+}
+
+void Arena::addBlock(size_t _minSize) {
+    size_t size = std::max(m_blockSize, _minSize);
+
+    char* data = static_cast<char*>(::operator new(size));
+
+    m_blocks.emplace_back(data, size);
+    m_pos = data;
+    m_end = data + size;
+}
+
+void* Arena::allocate(size_t _size, size_t _align) {
+
+    auto align = [&]() {
+        uintptr_t pos = reinterpret_cast<uintptr_t>(m_pos);
+        return reinterpret_cast<char*>((pos + _align - 1) & ~(uintptr_t(_align) - 1));
+    };
+
+    char* ptr = align();
+    if (!m_pos || ptr + _size > m_end) {
+        addBlock(_size + _align);
+        ptr = align();
+    }
+
+    m_pos = ptr + _size;
+    m_used += _size;
+
+    return ptr;
+}
+
+void Arena::reset() {
+
+    if (m_blocks.size() > 1) {
+        size_t total = 0;
+        for (auto& block : m_blocks) {
+            total += block.second;
+            ::operator delete(block.first);
+        }
+        m_blocks.clear();
+        addBlock(total);
+    }
+
+    if (!m_blocks.empty()) {
+        m_pos = m_blocks[0].first;
+        m_end = m_pos + m_blocks[0].second;
+    }
+    m_used = 0;
+}
+
+}
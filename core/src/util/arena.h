@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Tangram {
+
+/* Bump allocator for data that lives as long as one tile is processed
+ *
+ * Allocations are carved from large blocks and never freed individually;
+ * reset() releases all of them at once. Each worker keeps its own Arena and
+ * resets it between tiles, so that after the first tiles decoding does not
+ * touch the heap at all. An Arena must not be shared between threads.
+ */
+class Arena {
+public:
+    explicit Arena(size_t _blockSize = 64 * 1024);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(size_t _size, size_t _align);
+
+    // Invalidate all allocations. When more than one block was used they are
+    // merged into one, so that the next tile of similar size fits into it.
+    void reset();
+
+    // Bytes handed out since the last reset
+    size_t used() const { return m_used; }
+
+    // Number of blocks currently held
+    size_t blocks() const { return m_blocks.size(); }
+
+private:
+    void addBlock(size_t _minSize);
+
+    std::vector<std::pair<char*, size_t>> m_blocks;
+    char* m_pos = nullptr;
+    char* m_end = nullptr;
+    size_t m_blockSize;
+    size_t m_used = 0;
+};
+
+/* Standard allocator handing out memory from an Arena. deallocate() is a
+ * no-op: memory of a container that grows is reclaimed on Arena::reset().
+ */
+template<class T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    ArenaAllocator(Arena& _arena) : arena(&_arena) {}
+
+    template<class U>
+    ArenaAllocator(const ArenaAllocator<U>& _other) : arena(_other.arena) {}
+
+    T* allocate(size_t _n) {
+        return static_cast<T*>(arena->allocate(_n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T*, size_t) {}
+
+    Arena* arena;
+};
+
+template<class T, class U>
+bool operator==(const ArenaAllocator<T>& _a, const ArenaAllocator<U>& _b) { return _a.arena == _b.arena; }
+
+template<class T, class U>
+bool operator!=(const ArenaAllocator<T>& _a, const ArenaAllocator<U>& _b) { return _a.arena != _b.arena; }
+
+template<class T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+}
@@ -1,8 +1,14 @@
 #pragma once
 
 #include "data/tileData.h"
+#include "util/geom.h"
+#include "util/lineSegments.h"
+
+#include "glm/gtx/rotate_vector.hpp"
+#include "glm/gtx/norm.hpp"
 
 #include <functional>
+#include <limits>
 #include <vector>
 
 #include "earcut.hpp/include/earcut.hpp"
@@ -70,6 +76,7 @@ typedef std::function<void(const glm::vec3& coord, const glm::vec2& enormal, con
  */
 struct PolyLineBuilder {
     std::vector<uint16_t> indices; // indices for drawing the polyline as triangles are added to this vector
+    LineSegments segments; // normals and lengths of the segments of the current line
     PolyLineVertexFn addVertex;
     size_t numVertices = 0;
     float miterLimit = 3.f;
@@ -132,6 +139,20 @@ public:
      */
     static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx);
 
+    /* Variants of the functions above that pass the vertices to @_addVertex
+     * instead of _ctx.addVertex. The callable has the signature of
+     * <PolygonVertexFn> or <PolyLineVertexFn> and can be inlined.
+     */
+    template<class F>
+    static void buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx, F&& _addVertex);
+
+    template<class F>
+    static void buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight,
+                                      PolygonBuilder& _ctx, F&& _addVertex);
+
+    template<class F>
+    static void buildPolyLine(const Line& _line, PolyLineBuilder& _ctx, F&& _addVertex);
+
     /* Build a tesselated quad centered on _screenOrigin
      * @_screenOrigin the sprite origin in screen space
      * @_size the size of the sprite in pixels
@@ -141,6 +162,415 @@ public:
      */
     static void buildQuadAtPoint(const glm::vec2& _screenOrigin, const glm::vec2& _size, const glm::vec2& _uvBL, const glm::vec2& _uvTR, SpriteBuilder& _ctx);
 
+private:
+
+    // Run earcut on @_polygon and mark the points referenced by the triangles
+    // in _ctx.used, returns the number of used points
+    static size_t triangulate(const Polygon& _polygon, PolygonBuilder& _ctx);
+
+    // Tests if a line segment (from point A to B) is outside the edge of a tile
+    static bool isOutsideTile(const glm::vec3& _a, const glm::vec3& _b);
+
+    // Adds indices for pairs of vertices arranged like a line strip
+    static void indexPairs(int _nPairs, int _nVertices, std::vector<uint16_t>& _indicesOut);
+
+    template<class F>
+    static void addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv,
+                                  PolyLineBuilder& _ctx, F& _addVertex);
+
+    template<class F>
+    static void addFan(const glm::vec3& _pC,
+                       const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
+                       const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
+                       int _numTriangles, PolyLineBuilder& _ctx, F& _addVertex);
+
+    template<class F>
+    static void addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners,
+                       bool _isBeginning, PolyLineBuilder& _ctx, F& _addVertex);
+
+    template<class F>
+    static void buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t startIndex,
+                                     size_t endIndex, bool endCap, F& _addVertex);
+
 };
 
+template<class F>
+void Builders::buildPolygon(const Polygon& _polygon, float _height, PolygonBuilder& _ctx, F&& _addVertex) {
+
+    glm::vec2 min, max;
+    if (_ctx.useTexCoords) {
+        min = glm::vec2(std::numeric_limits<float>::max());
+        max = glm::vec2(std::numeric_limits<float>::min());
+
+        for (auto& p : _polygon[0]) {
+            min.x = std::min(min.x, p.x);
+            min.y = std::min(min.y, p.y);
+            max.x = std::max(max.x, p.x);
+            max.y = std::max(max.y, p.y);
+        }
+    }
+
+    size_t sumVertices = triangulate(_polygon, _ctx);
+    size_t sumPoints = _ctx.used.size();
+
+    uint16_t vertexDataOffset = _ctx.numVertices;
+    _ctx.numVertices += sumVertices;
+
+    size_t ring = 0;
+    size_t offset = 0;
+
+    // Go through all points of the polyon.
+    for (size_t src = 0, dst = 0; src < sumPoints; src++) {
+        // The points of the polygon rings are indexed linearly.
+        // This maps the indices back to the original ring and point.
+        if (src - offset >= _polygon[ring].size()) {
+            offset += _polygon[ring].size();
+            ring += 1;
+        }
+
+        // Add vertex only when the point is used.
+        if (_ctx.used[src] == 0) { continue; }
+
+        // Keep track of skipped points to update indices
+        _ctx.used[src] = dst++;
+
+        auto& p = _polygon[ring][src - offset];
+        glm::vec3 coord(p.x, p.y, _height);
+        static const glm::vec3 normal(0.0, 0.0, 1.0);
+
+        if (_ctx.useTexCoords) {
+            glm::vec2 uv(mapValue(coord.x, min.x, max.x, 0., 1.),
+                         mapValue(coord.y, min.y, max.y, 1., 0.));
+
+            _addVertex(coord, normal, uv);
+        } else {
+            _addVertex(coord, normal, glm::vec2(0));
+        }
+    }
+
+    for (auto i : _ctx.earcut.indices) {
+        _ctx.indices.push_back(vertexDataOffset + _ctx.used[i]);
+    }
+}
+
+template<class F>
+void Builders::buildPolygonExtrusion(const Polygon& _polygon, float _minHeight, float _maxHeight,
+                                     PolygonBuilder& _ctx, F&& _addVertex) {
+
+    auto vertexDataOffset = _ctx.numVertices;
+
+    static const glm::vec3 upVector(0.0f, 0.0f, 1.0f);
+    glm::vec3 normalVector;
+
+    for (auto& line : _polygon) {
+
+        size_t lineSize = line.size();
+
+        for (size_t i = 0; i < lineSize - 1; i++) {
+
+            glm::vec3 a(line[i]);
+            glm::vec3 b(line[i+1]);
+
+            normalVector = glm::cross(upVector, b - a);
+            normalVector = glm::normalize(normalVector);
+
+            if (std::isnan(normalVector.x)
+             || std::isnan(normalVector.y)
+             || std::isnan(normalVector.z)) {
+                continue;
+            }
+
+            // 1st vertex top
+            a.z = _maxHeight;
+            _addVertex(a, normalVector, glm::vec2(1.,0.));
+
+            // 2nd vertex top
+            b.z = _maxHeight;
+            _addVertex(b, normalVector, glm::vec2(0.,0.));
+
+            // 1st vertex bottom
+            a.z = _minHeight;
+            _addVertex(a, normalVector, glm::vec2(1.,1.));
+
+            // 2nd vertex bottom
+            b.z = _minHeight;
+            _addVertex(b, normalVector, glm::vec2(0.,1.));
+
+            // Start the index from the previous state of the vertex Data
+            _ctx.indices.push_back(vertexDataOffset);
+            _ctx.indices.push_back(vertexDataOffset + 1);
+            _ctx.indices.push_back(vertexDataOffset + 2);
+
+            _ctx.indices.push_back(vertexDataOffset + 1);
+            _ctx.indices.push_back(vertexDataOffset + 3);
+            _ctx.indices.push_back(vertexDataOffset + 2);
+
+            vertexDataOffset += 4;
+        }
+
+        _ctx.numVertices = vertexDataOffset;
+    }
+}
+
+// Get 2D perpendicular of two points
+inline glm::vec2 perp2d(const glm::vec3& _v1, const glm::vec3& _v2 ){
+    return glm::vec2(_v2.y - _v1.y, _v1.x - _v2.x);
+}
+
+// Helper function for polyline tesselation
+template<class F>
+void Builders::addPolyLineVertex(const glm::vec3& _coord, const glm::vec2& _normal, const glm::vec2& _uv,
+                                 PolyLineBuilder& _ctx, F& _addVertex) {
+    _ctx.numVertices++;
+    _addVertex(_coord, _normal, _uv);
+}
+
+//  Tessalate a fan geometry between points A       B
+//  using their normals from a center        \ . . /
+//  and interpolating their UVs               \ p /
+//                                             \./
+//                                              C
+template<class F>
+void Builders::addFan(const glm::vec3& _pC,
+                      const glm::vec2& _nA, const glm::vec2& _nB, const glm::vec2& _nC,
+                      const glm::vec2& _uA, const glm::vec2& _uB, const glm::vec2& _uC,
+                      int _numTriangles, PolyLineBuilder& _ctx, F& _addVertex) {
+
+    // Find angle difference
+    float cross = _nA.x * _nB.y - _nA.y * _nB.x; // z component of cross(_CA, _CB)
+    float angle = atan2f(cross, glm::dot(_nA, _nB));
+
+    int startIndex = _ctx.numVertices;
+
+    // Add center vertex
+    addPolyLineVertex(_pC, _nC, _uC, _ctx, _addVertex);
+
+    // Add vertex for point A
+    addPolyLineVertex(_pC, _nA, _uA, _ctx, _addVertex);
+
+    // Add radial vertices
+    glm::vec2 radial = _nA;
+    for (int i = 0; i < _numTriangles; i++) {
+        float frac = (i + 1)/(float)_numTriangles;
+        radial = glm::rotate(_nA, angle * frac);
+
+        glm::vec2 uv(0.0);
+        if (_ctx.useTexCoords) {
+            uv = (1.f - frac) * _uA + frac * _uB;
+        }
+
+        addPolyLineVertex(_pC, radial, uv, _ctx, _addVertex);
+
+        // Add indices
+        _ctx.indices.push_back(startIndex); // center vertex
+        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 1 : 2));
+        _ctx.indices.push_back(startIndex + i + (angle > 0 ? 2 : 1));
+    }
+
+}
+
+// Function to add the vertices for line caps
+template<class F>
+void Builders::addCap(const glm::vec3& _coord, const glm::vec2& _normal, int _numCorners,
+                      bool _isBeginning, PolyLineBuilder& _ctx, F& _addVertex) {
+
+    float v = _isBeginning ? 0.f : 1.f; // length-wise tex coord
+
+    if (_numCorners < 1) {
+        // "Butt" cap needs no extra vertices
+        return;
+    } else if (_numCorners == 2) {
+        // "Square" cap needs two extra vertices
+        glm::vec2 tangent(-_normal.y, _normal.x);
+        addPolyLineVertex(_coord, _normal + tangent, {0.f, v}, _ctx, _addVertex);
+        addPolyLineVertex(_coord, -_normal + tangent, {0.f, v}, _ctx, _addVertex);
+        if (!_isBeginning) { // At the beginning of a line we can't form triangles with previous vertices
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+        }
+        return;
+    }
+
+    // "Round" cap type needs a fan of vertices
+    glm::vec2 nA(_normal), nB(-_normal), nC(0.f, 0.f), uA(1.f, v), uB(0.f, v), uC(0.5f, v);
+    if (_isBeginning) {
+        nA *= -1.f; // To flip the direction of the fan, we negate the normal vectors
+        nB *= -1.f;
+        uA.x = 0.f; // To keep tex coords consistent, we must reverse these too
+        uB.x = 1.f;
+    }
+    addFan(_coord, nA, nB, nC, uA, uB, uC, _numCorners, _ctx, _addVertex);
+}
+
+template<class F>
+void Builders::buildPolyLineSegment(const Line& _line, PolyLineBuilder& _ctx, size_t startIndex,
+                                    size_t endIndex, bool endCap, F& _addVertex) {
+
+    float distance = 0; // Cumulative distance along the polyline.
+
+    size_t origLineSize = _line.size();
+
+    // endIndex/startIndex could be wrapped values, calculate lineSize accordingly
+    int lineSize = (int)((endIndex > startIndex) ?
+                   (endIndex - startIndex) :
+                   (origLineSize - startIndex + endIndex));
+    if (lineSize < 2) { return; }
+
+    glm::vec3 coordCurr(_line[startIndex]);
+    // get the Point using wrapped index in the original line geometry
+    glm::vec3 coordNext(_line[(startIndex + 1) % origLineSize]);
+    glm::vec2 normPrev, normNext, miterVec;
+
+    // Normals and lengths of segments by wrapped start index
+    const auto& normals = _ctx.segments.normals;
+    const auto& lengths = _ctx.segments.lengths;
+
+    int cornersOnCap = (int)_ctx.cap;
+    int trianglesOnJoin = (int)_ctx.join;
+
+    // Process first point in line with an end cap
+    normNext = normals[startIndex % origLineSize];
+
+    if (endCap) {
+        addCap(coordCurr, normNext, cornersOnCap, true, _ctx, _addVertex);
+    }
+    addPolyLineVertex(coordCurr, normNext, {1.0f, 0.0f}, _ctx, _addVertex); // right corner
+    addPolyLineVertex(coordCurr, -normNext, {0.0f, 0.0f}, _ctx, _addVertex); // left corner
+
+
+    // Process intermediate points
+    for (int i = 1; i < lineSize - 1; i++) {
+        // get the Point using wrapped index in the original line geometry
+        int nextIndex = (i + startIndex + 1) % origLineSize;
+
+        distance += lengths[(i + startIndex - 1) % origLineSize];
+
+        coordCurr = coordNext;
+        coordNext = _line[nextIndex];
+
+        if (coordCurr == coordNext) {
+            continue;
+        }
+
+        normPrev = normNext;
+        normNext = normals[(i + startIndex) % origLineSize];
+
+        // Compute "normal" for miter joint
+        miterVec = normPrev + normNext;
+
+        float scale = 1.f;
+
+        // normPrev and normNext are in the opposite direction
+        // in order to prevent NaN values, we use the perp
+        // vector of those two vectors
+        if (miterVec == glm::zero<glm::vec2>()) {
+            miterVec = perp2d(glm::vec3(normNext, 0.f), glm::vec3(normPrev, 0.f));
+        } else {
+            scale = 2.f / glm::dot(miterVec, miterVec);
+        }
+
+        miterVec *= scale;
+
+        if (glm::length2(miterVec) > glm::length2(_ctx.miterLimit)) {
+            trianglesOnJoin = 1;
+            miterVec *= _ctx.miterLimit / glm::length(miterVec);
+        }
+
+        float v = distance;
+
+        if (trianglesOnJoin == 0) {
+            // Join type is a simple miter
+
+            addPolyLineVertex(coordCurr, miterVec, {1.0, v}, _ctx, _addVertex); // right corner
+            addPolyLineVertex(coordCurr, -miterVec, {0.0, v}, _ctx, _addVertex); // left corner
+            indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+        } else {
+
+            // Join type is a fan of triangles
+
+            bool isRightTurn = (normNext.x * normPrev.y - normNext.y * normPrev.x) > 0; // z component of cross(normNext, normPrev)
+
+            if (isRightTurn) {
+
+                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx, _addVertex); // right (inner) corner
+                addPolyLineVertex(coordCurr, -normPrev, {0.0f, v}, _ctx, _addVertex); // left (outer) corner
+                indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+                addFan(coordCurr, -normPrev, -normNext, miterVec, {0.f, v}, {0.f, v}, {1.f, v}, trianglesOnJoin, _ctx, _addVertex);
+
+                addPolyLineVertex(coordCurr, miterVec, {1.0f, v}, _ctx, _addVertex); // right (inner) corner
+                addPolyLineVertex(coordCurr, -normNext, {0.0f, v}, _ctx, _addVertex); // left (outer) corner
+
+            } else {
+
+                addPolyLineVertex(coordCurr, normPrev, {1.0f, v}, _ctx, _addVertex); // right (outer) corner
+                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx, _addVertex); // left (inner) corner
+                indexPairs(1, _ctx.numVertices, _ctx.indices);
+
+                addFan(coordCurr, normPrev, normNext, -miterVec, {1.f, v}, {1.f, v}, {0.0f, v}, trianglesOnJoin, _ctx, _addVertex);
+
+                addPolyLineVertex(coordCurr, normNext, {1.0f, v}, _ctx, _addVertex); // right (outer) corner
+                addPolyLineVertex(coordCurr, -miterVec, {0.0f, v}, _ctx, _addVertex); // left (inner) corner
+            }
+        }
+    }
+
+    distance += lengths[(startIndex + lineSize - 2) % origLineSize];
+
+    // Process last point in line with a cap
+    addPolyLineVertex(coordNext, normNext, {1.f, distance}, _ctx, _addVertex); // right corner
+    addPolyLineVertex(coordNext, -normNext, {0.f, distance}, _ctx, _addVertex); // left corner
+    indexPairs(1, _ctx.numVertices, _ctx.indices);
+    if (endCap) {
+        addCap(coordNext, normNext, cornersOnCap, false, _ctx, _addVertex);
+    }
+
+}
+
+template<class F>
+void Builders::buildPolyLine(const Line& _line, PolyLineBuilder& _ctx, F&& _addVertex) {
+
+    size_t lineSize = _line.size();
+
+    _ctx.segments.compute(_line);
+
+    if (_ctx.keepTileEdges) {
+
+        buildPolyLineSegment(_line, _ctx, 0, lineSize, true, _addVertex);
+
+    } else {
+
+        int cut = 0;
+        int firstCutEnd = 0;
+
+        // Determine cuts
+        for (size_t i = 0; i < lineSize - 1; i++) {
+            const glm::vec3& coordCurr = _line[i];
+            const glm::vec3& coordNext = _line[i+1];
+            if (isOutsideTile(coordCurr, coordNext)) {
+                if (cut == 0) {
+                    firstCutEnd = i + 1;
+                }
+                buildPolyLineSegment(_line, _ctx, cut, i + 1, true, _addVertex);
+                cut = i + 1;
+            }
+        }
+
+        if (_ctx.closedPolygon) {
+            if (cut == 0) {
+                // no tile edge cuts!
+                // loop and close the polygon with no endcaps
+                buildPolyLineSegment(_line, _ctx, 0, lineSize+2, false, _addVertex);
+            } else {
+                // merge first and last cut line-segments together
+                buildPolyLineSegment(_line, _ctx, cut, firstCutEnd, true, _addVertex);
+            }
+        } else {
+            buildPolyLineSegment(_line, _ctx, cut, lineSize, true, _addVertex);
+        }
+
+    }
+
+}
+
 }
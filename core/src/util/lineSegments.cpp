@@ -0,0 +1,108 @@
+#include "util/lineSegments.h"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TANGRAM_SEGMENTS_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+// ARMv7 NEON has no IEEE division and square root
+#include <arm_neon.h>
+#define TANGRAM_SEGMENTS_NEON
+#endif
+
+namespace Tangram {
+
+// Same operations in the same order as glm::normalize and glm::distance and
+// as the SIMD batches below. This file is built with -ffp-contract=off, so
+// that the compiler does not fuse the multiply-adds and round differently.
+static inline void computeSegment(const Point& _a, const Point& _b, glm::vec2& _normal, float& _length) {
+    float px = _b.y - _a.y;
+    float py = _a.x - _b.x;
+    float inv = 1.f / std::sqrt(px * px + py * py);
+    _normal = glm::vec2(px * inv, py * inv);
+
+    float dx = _b.x - _a.x;
+    float dy = _b.y - _a.y;
+    float dz = _b.z - _a.z;
+    _length = std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void LineSegments::computeScalar(const Line& _line) {
+
+    size_t n = _line.size();
+    normals.resize(n);
+    lengths.resize(n);
+
+    for (size_t i = 0; i < n; i++) {
+        computeSegment(_line[i], _line[(i + 1) % n], normals[i], lengths[i]);
+    }
+}
+
+void LineSegments::compute(const Line& _line) {
+
+    size_t n = _line.size();
+    normals.resize(n);
+    lengths.resize(n);
+
+    size_t i = 0;
+
+#if defined(TANGRAM_SEGMENTS_SSE2) || defined(TANGRAM_SEGMENTS_NEON)
+    // Batches of four segments, all but the last one that wraps around
+    const Point* p = _line.data();
+
+    for (; i + 4 < n; i += 4) {
+        alignas(16) float ax[4], ay[4], az[4], bx[4], by[4], bz[4];
+        for (int k = 0; k < 4; k++) {
+            ax[k] = p[i+k].x; ay[k] = p[i+k].y; az[k] = p[i+k].z;
+            bx[k] = p[i+k+1].x; by[k] = p[i+k+1].y; bz[k] = p[i+k+1].z;
+        }
+        alignas(16) float nx[4], ny[4], len[4];
+
+#if defined(TANGRAM_SEGMENTS_SSE2)
+        __m128 vax = _mm_load_ps(ax), vay = _mm_load_ps(ay), vaz = _mm_load_ps(az);
+        __m128 vbx = _mm_load_ps(bx), vby = _mm_load_ps(by), vbz = _mm_load_ps(bz);
+
+        __m128 px = _mm_sub_ps(vby, vay);
+        __m128 py = _mm_sub_ps(vax, vbx);
+        __m128 dot = _mm_add_ps(_mm_mul_ps(px, px), _mm_mul_ps(py, py));
+        __m128 inv = _mm_div_ps(_mm_set1_ps(1.f), _mm_sqrt_ps(dot));
+        _mm_store_ps(nx, _mm_mul_ps(px, inv));
+        _mm_store_ps(ny, _mm_mul_ps(py, inv));
+
+        __m128 dx = _mm_sub_ps(vbx, vax);
+        __m128 dz = _mm_sub_ps(vbz, vaz);
+        __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(px, px)),
+                                 _mm_mul_ps(dz, dz));
+        _mm_store_ps(len, _mm_sqrt_ps(dist));
+#else
+        float32x4_t vax = vld1q_f32(ax), vay = vld1q_f32(ay), vaz = vld1q_f32(az);
+        float32x4_t vbx = vld1q_f32(bx), vby = vld1q_f32(by), vbz = vld1q_f32(bz);
+
+        float32x4_t px = vsubq_f32(vby, vay);
+        float32x4_t py = vsubq_f32(vax, vbx);
+        // Separate multiply and add, a fused multiply-add would round differently
+        float32x4_t dot = vaddq_f32(vmulq_f32(px, px), vmulq_f32(py, py));
+        float32x4_t inv = vdivq_f32(vdupq_n_f32(1.f), vsqrtq_f32(dot));
+        vst1q_f32(nx, vmulq_f32(px, inv));
+        vst1q_f32(ny, vmulq_f32(py, inv));
+
+        float32x4_t dx = vsubq_f32(vbx, vax);
+        float32x4_t dz = vsubq_f32(vbz, vaz);
+        float32x4_t dist = vaddq_f32(vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(px, px)),
+                                     vmulq_f32(dz, dz));
+        vst1q_f32(len, vsqrtq_f32(dist));
+#endif
+        for (int k = 0; k < 4; k++) {
+            normals[i+k] = glm::vec2(nx[k], ny[k]);
+            lengths[i+k] = len[k];
+        }
+    }
+#endif
+
+    for (; i < n; i++) {
+        computeSegment(_line[i], _line[(i + 1) % n], normals[i], lengths[i]);
+    }
+}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "data/tileData.h"
+
+#include "glm/vec2.hpp"
+
+#include <vector>
+
+namespace Tangram {
+
+/* Normals and lengths of the segments of a line, see Builders::buildPolyLine()
+ *
+ * Segment i goes from point i to point i+1, the last segment wraps around to
+ * the first point for closed polygons. The values are the same as computed
+ * by glm::normalize(perp2d(a, b)) and glm::distance(a, b), so degenerate
+ * segments have NaN normals.
+ */
+struct LineSegments {
+    std::vector<glm::vec2> normals;
+    std::vector<float> lengths;
+
+    /* Compute the segments of @_line, using SSE2 or NEON where available */
+    void compute(const Line& _line);
+
+    /* Reference implementation with scalar math */
+    void computeScalar(const Line& _line);
+};
+
+}
@@ -0,0 +1,164 @@
+#include "util/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace Tangram {
+namespace Parallel {
+
+namespace {
+
+// Calls of one run(), claimed one at a time by the calling thread and the
+// pool threads
+struct Batch {
+    const std::function<void(size_t)>* fn;
+    size_t count;
+    std::atomic<size_t> next{0};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t done = 0;
+
+    bool claimed() const { return next >= count; }
+
+    // Take calls until none are left
+    void work() {
+        size_t n = 0;
+        for (size_t i = next++; i < count; i = next++) {
+            (*fn)(i);
+            n++;
+        }
+        if (n == 0) { return; }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        done += n;
+        if (done == count) { finished.notify_all(); }
+    }
+};
+
+class Pool {
+
+public:
+
+    Pool() {
+        unsigned threads = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        for (unsigned i = 0; i < threads; i++) {
+            m_threads.emplace_back(&Pool::loop, this);
+        }
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_condition.notify_all();
+        for (auto& thread : m_threads) { thread.join(); }
+    }
+
+    void run(size_t _count, const std::function<void(size_t)>& _fn) {
+        auto batch = std::make_shared<Batch>();
+        batch->fn = &_fn;
+        batch->count = _count;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_batches.push_back(batch);
+        }
+        m_condition.notify_all();
+
+        batch->work();
+
+        // Wait for the calls that pool threads took
+        {
+            std::unique_lock<std::mutex> lock(batch->mutex);
+            batch->finished.wait(lock, [&]{ return batch->done == batch->count; });
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = std::find(m_batches.begin(), m_batches.end(), batch);
+        if (it != m_batches.end()) { m_batches.erase(it); }
+    }
+
+private:
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        while (true) {
+            m_condition.wait(lock, [&]{ return m_stop || !m_batches.empty(); });
+            if (m_stop) { return; }
+
+            auto batch = m_batches.front();
+            if (batch->claimed()) {
+                m_batches.pop_front();
+                continue;
+            }
+
+            lock.unlock();
+            batch->work();
+            lock.lock();
+        }
+    }
+
+    std::vector<std::thread> m_threads;
+    std::deque<std::shared_ptr<Batch>> m_batches;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_stop = false;
+};
+
+}
+
+void run(size_t _count, const std::function<void(size_t)>& _fn) {
+    static Pool s_pool;
+
+    if (_count == 0) { return; }
+    if (_count == 1) {
+        _fn(0);
+        return;
+    }
+    s_pool.run(_count, _fn);
+}
+
+std::vector<Chunk> split(const std::vector<size_t>& _weights, size_t _minChunkWeight,
+                         size_t _maxChunks) {
+
+    std::vector<Chunk> chunks;
+    if (_weights.empty()) { return chunks; }
+
+    if (_maxChunks == 0) {
+        _maxChunks = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+
+    size_t total = std::accumulate(_weights.begin(), _weights.end(), size_t(0));
+    size_t count = std::min(_maxChunks, total / std::max(_minChunkWeight, size_t(1)));
+    count = std::max(count, size_t(1));
+
+    size_t target = (total + count - 1) / count;
+    size_t weight = 0;
+    size_t begin = 0;
+
+    for (size_t i = 0; i < _weights.size(); i++) {
+        weight += _weights[i];
+        if (weight >= target && chunks.size() + 1 < count) {
+            chunks.push_back({ begin, i + 1 });
+            begin = i + 1;
+            weight = 0;
+        }
+    }
+    if (begin < _weights.size()) {
+        chunks.push_back({ begin, _weights.size() });
+    }
+
+    return chunks;
+}
+
+}
+}
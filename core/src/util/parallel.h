@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace Tangram {
+namespace Parallel {
+
+// Consecutive range of items [begin, end)
+struct Chunk {
+    size_t begin;
+    size_t end;
+};
+
+// Split items with @_weights into consecutive chunks of about equal weight.
+// Returns at most @_maxChunks chunks and no more than the total weight divided
+// by @_minChunkWeight. @_maxChunks defaults to the number of hardware threads.
+std::vector<Chunk> split(const std::vector<size_t>& _weights, size_t _minChunkWeight,
+                         size_t _maxChunks = 0);
+
+// Call @_fn(i) for each i in [0, @_count) and return when all calls finished.
+// The calls are shared between the calling thread and one process wide pool
+// of hardware threads minus one, so that concurrent callers do not start more
+// threads than there are cores. The calling thread keeps taking calls until
+// none are left, so it never waits for a pool that is busy with other work.
+void run(size_t _count, const std::function<void(size_t)>& _fn);
+
+// Call @_fn(index, chunk) for each chunk, concurrently when there is more
+// than one, see run(). Results written per chunk index do not depend on the
+// scheduling.
+template<class F>
+void forEachChunk(const std::vector<Chunk>& _chunks, F&& _fn) {
+
+    if (_chunks.size() == 1) {
+        _fn(0, _chunks[0]);
+        return;
+    }
+
+    run(_chunks.size(), [&](size_t i) { _fn(i, _chunks[i]); });
+}
+
+}
+}
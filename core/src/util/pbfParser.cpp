@@ -1,11 +1,13 @@
 #include "pbfParser.h"
 
 #include "data/propertyItem.h"
+#include "data/propertyKeys.h"
 #include "tile/tile.h"
 #include "platform.h"
 #include "util/geom.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iterator>
 
 #define FEATURE_ID 1
@@ -22,14 +24,20 @@
 
 namespace Tangram {
 
-PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
+using PbfParser::pbfGeomCmd;
 
-    Geometry geometry;
+// Decode the commands of @_geomIn, appending the points to @_coordinates and
+// the number of points of each line to @_sizes
+template<class Points>
+static void decodeGeometry(int _tileExtent, protobuf::message _geomIn,
+                           Points& _coordinates, std::vector<int>& _sizes) {
+
+    const size_t start = _coordinates.size();
 
     pbfGeomCmd cmd = pbfGeomCmd::moveTo;
     uint32_t cmdRepeat = 0;
 
-    double invTileExtent = (1.0/(_ctx.tileExtent-1.0));
+    double invTileExtent = (1.0/(_tileExtent-1.0));
 
     int64_t x = 0;
     int64_t y = 0;
@@ -47,8 +55,8 @@ PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::messag
         if(cmd == pbfGeomCmd::moveTo || cmd == pbfGeomCmd::lineTo) { // get parameters/points
             // if cmd is move then move to a new line/set of points and save this line
             if(cmd == pbfGeomCmd::moveTo) {
-                if (geometry.coordinates.size() > 0) {
-                    geometry.sizes.push_back(numCoordinates);
+                if (_coordinates.size() > start) {
+                    _sizes.push_back(numCoordinates);
                 }
                 numCoordinates = 0;
             }
@@ -59,16 +67,16 @@ PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::messag
             // bring the points in 0 to 1 space
             Point p;
             p.x = invTileExtent * (double)x;
-            p.y = invTileExtent * (double)(_ctx.tileExtent - y);
+            p.y = invTileExtent * (double)(_tileExtent - y);
 
-            if (numCoordinates == 0 || geometry.coordinates.back() != p) {
-                geometry.coordinates.push_back(p);
+            if (numCoordinates == 0 || _coordinates.back() != p) {
+                _coordinates.push_back(p);
                 numCoordinates++;
             }
         } else if(cmd == pbfGeomCmd::closePath) {
             // end of a polygon, push first point in this line as last and push line to poly
-            geometry.coordinates.push_back(geometry.coordinates[geometry.coordinates.size() - numCoordinates]);
-            geometry.sizes.push_back(numCoordinates + 1);
+            _coordinates.push_back(_coordinates[_coordinates.size() - numCoordinates]);
+            _sizes.push_back(numCoordinates + 1);
             numCoordinates = 0;
         }
 
@@ -77,19 +85,27 @@ PbfParser::Geometry PbfParser::getGeometry(ParserContext& _ctx, protobuf::messag
 
     // Enter the last line
     if (numCoordinates > 0) {
-        geometry.sizes.push_back(numCoordinates);
+        _sizes.push_back(numCoordinates);
     }
-
-    return geometry;
 }
 
-Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn) {
+void PbfParser::getGeometry(ParserContext& _ctx, protobuf::message _geomIn) {
+
+    // Keep the capacity of the buffers from previous features
+    _ctx.geometry.coordinates.clear();
+    _ctx.geometry.sizes.clear();
 
-    Feature feature(_ctx.sourceId);
+    decodeGeometry(_ctx.tileExtent, _geomIn, _ctx.geometry.coordinates, _ctx.geometry.sizes);
+}
 
-    _ctx.featureTags.clear();
-    _ctx.featureTags.assign(_ctx.keys.size(), -1);
+// Read the tags, type and geometry message of @_featureIn. Sets the value of
+// each key of the feature in _ctx.featureTags, returns false on invalid tags.
+static bool readFeature(PbfParser::ParserContext& _ctx, protobuf::message& _featureIn,
+                        size_t _numKeys, size_t _numValues, GeometryType& _geometryType,
+                        protobuf::message& _geometryMsg, size_t& _numTags) {
 
+    _ctx.featureTags.assign(_numKeys, -1);
+    _numTags = 0;
 
     while(_featureIn.next()) {
         switch(_featureIn.tag) {
@@ -104,33 +120,34 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
                 while(tagsMsg) {
                     auto tagKey = tagsMsg.varint();
 
-                    if(_ctx.keys.size() <= tagKey) {
+                    if(_numKeys <= tagKey) {
                         LOGE("accessing out of bound key");
-                        return feature;
+                        return false;
                     }
 
                     if(!tagsMsg) {
                         LOGE("uneven number of feature tag ids");
-                        return feature;
+                        return false;
                     }
 
                     auto valueKey = tagsMsg.varint();
 
-                    if( _ctx.values.size() <= valueKey ) {
+                    if(_numValues <= valueKey) {
                         LOGE("accessing out of bound values");
-                        return feature;
+                        return false;
                     }
 
+                    if (_ctx.featureTags[tagKey] < 0) { _numTags++; }
                     _ctx.featureTags[tagKey] = valueKey;
                 }
                 break;
             }
             case FEATURE_TYPE:
-                feature.geometryType = (GeometryType)_featureIn.varint();
+                _geometryType = (GeometryType)_featureIn.varint();
                 break;
-            // Actual geometry data
+            // Actual geometry data, decoded when the feature is selected
             case FEATURE_GEOM:
-                _ctx.geometry = getGeometry(_ctx, _featureIn.getMessage());
+                _geometryMsg = _featureIn.getMessage();
                 break;
 
             default:
@@ -138,35 +155,55 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
                 break;
         }
     }
+    return true;
+}
+
+bool PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn, Feature& _feature) {
+
+    protobuf::message geometryMsg;
+    size_t numTags = 0;
+
+    _ctx.geometry.coordinates.clear();
+    _ctx.geometry.sizes.clear();
+
+    if (!readFeature(_ctx, _featureIn, _ctx.keys.size(), _ctx.values.size(),
+                     _feature.geometryType, geometryMsg, numTags)) {
+        return false;
+    }
 
     std::vector<Properties::Item> properties;
-    properties.reserve(_ctx.featureTags.size());
+    properties.reserve(numTags);
 
     for (int tagKey : _ctx.orderedKeys) {
         int tagValue = _ctx.featureTags[tagKey];
         if (tagValue >= 0) {
-            properties.emplace_back(_ctx.keys[tagKey], _ctx.values[tagValue]);
+            properties.emplace_back(_ctx.keys[tagKey], _ctx.keyIds[tagKey], _ctx.values[tagValue]);
         }
     }
-    feature.props.setSorted(std::move(properties));
+    _feature.props.setSorted(std::move(properties));
 
-    switch(feature.geometryType) {
+    if (_ctx.filter && !_ctx.filter->feature(_feature)) {
+        return false;
+    }
+
+    if (geometryMsg) {
+        getGeometry(_ctx, geometryMsg);
+    }
+
+    switch(_feature.geometryType) {
         case GeometryType::points:
-            feature.points.insert(feature.points.begin(),
-                                  _ctx.geometry.coordinates.begin(),
+            _feature.points.assign(_ctx.geometry.coordinates.begin(),
                                   _ctx.geometry.coordinates.end());
             break;
 
         case GeometryType::lines:
         {
+            _feature.lines.reserve(_ctx.geometry.sizes.size());
             auto pos = _ctx.geometry.coordinates.begin();
             for (int length : _ctx.geometry.sizes) {
                 if (length == 0) { continue; }
-                Line line;
-                line.reserve(length);
-                line.insert(line.begin(), pos, pos + length);
+                _feature.lines.emplace_back(pos, pos + length);
                 pos += length;
-                feature.lines.emplace_back(std::move(line));
             }
             break;
         }
@@ -187,20 +224,18 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
                 if (_ctx.winding == 0) {
                     _ctx.winding = winding;
                 }
-                Line line;
-                line.reserve(length);
+                if (winding == _ctx.winding || _feature.polygons.empty()) {
+                    // This is an exterior polygon.
+                    _feature.polygons.emplace_back();
+                }
+                // Construct the ring in place with its final size
                 if (_ctx.winding > 0) {
-                    line.insert(line.end(), pos, pos + length);
+                    _feature.polygons.back().emplace_back(pos, pos + length);
                 } else {
-                    line.insert(line.end(), rpos - length, rpos);
+                    _feature.polygons.back().emplace_back(rpos - length, rpos);
                 }
                 pos += length;
                 rpos -= length;
-                if (winding == _ctx.winding || feature.polygons.empty()) {
-                    // This is an exterior polygon.
-                    feature.polygons.emplace_back();
-                }
-                feature.polygons.back().push_back(std::move(line));
             }
             break;
         }
@@ -210,13 +245,28 @@ Feature PbfParser::getFeature(ParserContext& _ctx, protobuf::message _featureIn)
             break;
     }
 
-    return feature;
+    return true;
 }
 
 Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
     Layer layer("");
 
+    if (_ctx.filter) {
+        // Find the name first to skip decoding of unused collections
+        protobuf::message nameItr = _layerIn;
+        while (nameItr.next()) {
+            if (nameItr.tag == LAYER_NAME) {
+                layer.name = nameItr.string();
+                break;
+            }
+            nameItr.skip();
+        }
+        if (!_ctx.filter->collection(layer.name)) {
+            return layer;
+        }
+    }
+
     _ctx.keys.clear();
     _ctx.values.clear();
     _ctx.featureMsgs.clear();
@@ -293,6 +343,13 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
 
     if (_ctx.featureMsgs.empty()) { return layer; }
 
+    // Intern keys once for all features of the layer
+    _ctx.keyIds.clear();
+    _ctx.keyIds.reserve(_ctx.keys.size());
+    for (const auto& key : _ctx.keys) {
+        _ctx.keyIds.push_back(PropertyKeys::lookup(key));
+    }
+
     //// Assign ordering to keys for faster sorting
     _ctx.orderedKeys.clear();
     _ctx.orderedKeys.reserve(_ctx.keys.size());
@@ -311,8 +368,243 @@ Layer PbfParser::getLayer(ParserContext& _ctx, protobuf::message _layerIn) {
         do {
             auto featureMsg = featureItr.getMessage();
 
-            layer.features.push_back(getFeature(_ctx, featureMsg));
+            layer.features.emplace_back(_ctx.sourceId);
+            if (!getFeature(_ctx, featureMsg, layer.features.back())) {
+                layer.features.pop_back();
+            }
+
+        } while (featureItr.next() && featureItr.tag == LAYER_FEATURE);
+    }
+
+    return layer;
+}
+
+bool PbfParser::getFlatFeature(ParserContext& _ctx, protobuf::message _featureIn, FlatLayer& _layer) {
+
+    protobuf::message geometryMsg;
+    size_t numTags = 0;
+    FlatFeature feature;
+
+    if (!readFeature(_ctx, _featureIn, _layer.keys.size(), _layer.values.size(),
+                     feature.geometryType, geometryMsg, numTags)) {
+        return false;
+    }
+
+    feature.propsBegin = _layer.properties.size();
+    for (int tagKey : _ctx.orderedKeys) {
+        int tagValue = _ctx.featureTags[tagKey];
+        if (tagValue >= 0) {
+            _layer.properties.push_back({ uint32_t(tagKey), uint32_t(tagValue) });
+        }
+    }
+    feature.propsEnd = _layer.properties.size();
+
+    // Append the geometry to the layer buffers, line sizes go to the context
+    auto& coordinates = _layer.coordinates;
+    const uint32_t start = coordinates.size();
+
+    _ctx.geometry.sizes.clear();
+    if (geometryMsg) {
+        decodeGeometry(_ctx.tileExtent, geometryMsg, coordinates, _ctx.geometry.sizes);
+    }
+
+    feature.linesBegin = _layer.lineEnds.size();
+    feature.polygonsBegin = _layer.polygonEnds.size();
+
+    switch(feature.geometryType) {
+        case GeometryType::points:
+            if (coordinates.size() > start) {
+                _layer.lineEnds.push_back(coordinates.size());
+            }
+            break;
+
+        case GeometryType::lines:
+        {
+            uint32_t end = start;
+            for (int length : _ctx.geometry.sizes) {
+                if (length == 0) { continue; }
+                end += length;
+                _layer.lineEnds.push_back(end);
+            }
+            break;
+        }
+        case GeometryType::polygons:
+        {
+            // Rings without area are dropped by moving the following rings
+            // down, rings are reversed in place to the exterior winding.
+            uint32_t read = start;
+            uint32_t write = start;
+            bool hasPolygon = false;
+            for (int length : _ctx.geometry.sizes) {
+                if (length == 0) { continue; }
+                auto pos = coordinates.begin() + read;
+                read += length;
+
+                float area = signedArea(pos, pos + length);
+                if (area == 0) { continue; }
+
+                int winding = area > 0 ? 1 : -1;
+                // Determine exterior winding from first polygon.
+                if (_ctx.winding == 0) {
+                    _ctx.winding = winding;
+                }
+                if (winding == _ctx.winding || !hasPolygon) {
+                    // This is an exterior polygon, close the previous one.
+                    if (hasPolygon) { _layer.polygonEnds.push_back(_layer.lineEnds.size()); }
+                    hasPolygon = true;
+                }
+                auto ring = coordinates.begin() + write;
+                if (ring != pos) {
+                    std::copy(pos, pos + length, ring);
+                }
+                if (_ctx.winding < 0) {
+                    std::reverse(ring, ring + length);
+                }
+                write += length;
+                _layer.lineEnds.push_back(write);
+            }
+            if (hasPolygon) { _layer.polygonEnds.push_back(_layer.lineEnds.size()); }
+            coordinates.resize(write);
+            break;
+        }
+        default:
+            coordinates.resize(start);
+            break;
+    }
+
+    feature.linesEnd = _layer.lineEnds.size();
+    feature.polygonsEnd = _layer.polygonEnds.size();
+
+    _layer.features.push_back(feature);
+
+    return true;
+}
+
+static StringView getStringView(protobuf::message& _msg) {
+    protobuf::message str = _msg.getMessage();
+    return StringView(str.getData(), str.getEnd() - str.getData());
+}
+
+FlatLayer PbfParser::getFlatLayer(ParserContext& _ctx, Arena& _arena, protobuf::message _layerIn) {
+
+    FlatLayer layer(_arena);
+
+    if (_ctx.filter) {
+        // Find the name first to skip decoding of unused collections
+        protobuf::message nameItr = _layerIn;
+        while (nameItr.next()) {
+            if (nameItr.tag == LAYER_NAME) {
+                layer.name = getStringView(nameItr);
+                break;
+            }
+            nameItr.skip();
+        }
+        if (!_ctx.filter->collection(layer.name.str())) {
+            return layer;
+        }
+    }
 
+    _ctx.featureMsgs.clear();
+
+    bool lastWasFeature = false;
+    size_t numFeatures = 0;
+
+    // Iterate layer to populate featureMsgs, keys and values
+    while(_layerIn.next()) {
+
+        switch(_layerIn.tag) {
+            case LAYER_NAME: {
+                layer.name = getStringView(_layerIn);
+                break;
+            }
+            case LAYER_FEATURE: {
+                numFeatures++;
+                if (!lastWasFeature) {
+                    _ctx.featureMsgs.push_back(_layerIn);
+                    lastWasFeature = true;
+                }
+                _layerIn.skip();
+                continue;
+            }
+            case LAYER_KEY: {
+                layer.keys.push_back(getStringView(_layerIn));
+                break;
+            }
+            case LAYER_VALUE: {
+                protobuf::message valueItr = _layerIn.getMessage();
+
+                // Same conversions as getLayer()
+                while (valueItr.next()) {
+                    FlatValue value;
+                    value.type = FlatValue::Type::number;
+                    switch (valueItr.tag) {
+                        case 1: // string value
+                            value.type = FlatValue::Type::string;
+                            value.string = getStringView(valueItr);
+                            break;
+                        case 2: // float value
+                            value.number = valueItr.float32();
+                            break;
+                        case 3: // double value
+                            value.number = valueItr.float64();
+                            break;
+                        case 4: // int value
+                        case 6: // sint value
+                            value.number = valueItr.int64();
+                            break;
+                        case 5: // uint value
+                            value.number = valueItr.varint();
+                            break;
+                        case 7: // bool value
+                            value.number = valueItr.boolean();
+                            break;
+                        default:
+                            value.type = FlatValue::Type::none;
+                            valueItr.skip();
+                            break;
+                    }
+                    layer.values.push_back(value);
+                }
+                break;
+            }
+            case LAYER_TILE_EXTENT:
+                _ctx.tileExtent = static_cast<int>(_layerIn.int64());
+                break;
+
+            default: // skip
+                _layerIn.skip();
+                break;
+        }
+        lastWasFeature = false;
+    }
+
+    if (_ctx.featureMsgs.empty()) { return layer; }
+
+    // Intern keys once for all features of the layer
+    layer.keyIds.reserve(layer.keys.size());
+    for (const auto& key : layer.keys) {
+        _ctx.key.assign(key.data, key.size);
+        layer.keyIds.push_back(PropertyKeys::lookup(_ctx.key));
+    }
+
+    // Order keys like Properties::keyComparator
+    _ctx.orderedKeys.clear();
+    _ctx.orderedKeys.reserve(layer.keys.size());
+    for (int i = 0, n = layer.keys.size(); i < n; i++) {
+        _ctx.orderedKeys.push_back(i);
+    }
+    std::sort(_ctx.orderedKeys.begin(), _ctx.orderedKeys.end(),
+              [&](int a, int b) {
+                  const auto& ka = layer.keys[a];
+                  const auto& kb = layer.keys[b];
+                  if (ka.size != kb.size) { return ka.size < kb.size; }
+                  return std::memcmp(ka.data, kb.data, ka.size) < 0;
+              });
+
+    layer.features.reserve(numFeatures);
+    for (auto& featureItr : _ctx.featureMsgs) {
+        do {
+            getFlatFeature(_ctx, featureItr.getMessage(), layer);
         } while (featureItr.next() && featureItr.tag == LAYER_FEATURE);
     }
 
@@ -23,24 +23,43 @@ namespace PbfParser {
 
         int32_t sourceId;
         std::vector<std::string> keys;
+        // Interned IDs of keys
+        std::vector<uint32_t> keyIds;
         std::vector<Value> values;
         std::vector<protobuf::message> featureMsgs;
+        // Geometry of the current feature, reused across features
         Geometry geometry;
         // Map Key ID -> Tag values
         std::vector<int> featureTags;
         // Key IDs sorted by Property key ordering
         std::vector<int> orderedKeys;
+        // Key of a FlatLayer for PropertyKeys::lookup()
+        std::string key;
 
         int tileExtent = 0;
         int winding = 0;
+
+        // Optional, skips collections and features that are not drawn
+        TileDataFilter* filter = nullptr;
     };
 
-    Geometry getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
+    // Decode @_geomIn into _ctx.geometry
+    void getGeometry(ParserContext& _ctx, protobuf::message _geomIn);
 
-    Feature getFeature(ParserContext& _ctx, protobuf::message _featureIn);
+    // Decode @_featureIn into @_feature, returns false when the feature was
+    // rejected by _ctx.filter or is invalid
+    bool getFeature(ParserContext& _ctx, protobuf::message _featureIn, Feature& _feature);
 
     Layer getLayer(ParserContext& _ctx, protobuf::message _layerIn);
 
+    // Decode @_featureIn into the buffers of @_layer, returns false when the
+    // feature is invalid. Does not apply _ctx.filter.
+    bool getFlatFeature(ParserContext& _ctx, protobuf::message _featureIn, FlatLayer& _layer);
+
+    // Decode @_layerIn without copying keys and string values, all buffers
+    // are allocated from @_arena. Only collections are filtered by _ctx.filter.
+    FlatLayer getFlatLayer(ParserContext& _ctx, Arena& _arena, protobuf::message _layerIn);
+
     enum pbfGeomCmd {
         moveTo = 1,
         lineTo = 2,
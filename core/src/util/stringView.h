@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+
+namespace Tangram {
+
+/* Non-owning reference to a range of characters, e.g. a string inside a
+ * protobuf buffer. The referenced data must outlive the view.
+ */
+struct StringView {
+    StringView() {}
+    StringView(const char* _data, size_t _size) : data(_data), size(_size) {}
+    StringView(const std::string& _str) : data(_str.data()), size(_str.size()) {}
+
+    std::string str() const { return std::string(data, size); }
+
+    bool empty() const { return size == 0; }
+
+    bool operator==(const StringView& _other) const {
+        return size == _other.size && std::memcmp(data, _other.data, size) == 0;
+    }
+    bool operator!=(const StringView& _other) const { return !(*this == _other); }
+
+    const char* data = nullptr;
+    size_t size = 0;
+};
+
+}
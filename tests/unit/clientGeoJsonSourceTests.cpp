@@ -0,0 +1,69 @@
+#include "catch.hpp"
+#include "data/clientGeoJsonSource.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "tile/tileID.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <cmath>
+#include <memory>
+#include <random>
+
+using namespace Tangram;
+
+struct TestGeoJsonSource : public ClientGeoJsonSource {
+    using ClientGeoJsonSource::ClientGeoJsonSource;
+    using ClientGeoJsonSource::parse;
+
+    // Number of points inside of the tile, without its buffer
+    size_t tilePoints(TileID _tileId) {
+        MercatorProjection projection;
+        TileTask task(_tileId, shared_from_this(), 0);
+
+        auto data = parse(task, projection);
+        if (!data) { return 0; }
+
+        size_t count = 0;
+        for (auto& feature : data->layers[0].features) {
+            for (auto& point : feature.points) {
+                if (point.x >= 0 && point.x < 1 && point.y > 0 && point.y <= 1) { count++; }
+            }
+        }
+        return count;
+    }
+};
+
+static int tileX(double _lng, int _z) { return int((_lng + 180.) / 360. * (1 << _z)); }
+
+static int tileY(double _lat, int _z) {
+    double r = _lat * M_PI / 180.;
+    return int((1. - std::log(std::tan(r) + 1. / std::cos(r)) / M_PI) / 2. * (1 << _z));
+}
+
+TEST_CASE("Client GeoJSON tiles contain each point once at every zoom", "[ClientGeoJsonSource]") {
+    auto source = std::make_shared<TestGeoJsonSource>("points", "");
+
+    // Enough points in one batch to split the store into cells
+    const size_t numPoints = 20000;
+    std::mt19937 random(0);
+    std::uniform_real_distribution<double> lng(-122.5, -122.3);
+    std::uniform_real_distribution<double> lat(37.7, 37.8);
+
+    Properties props;
+    source->beginBatch();
+    for (size_t i = 0; i < numPoints; i++) {
+        source->addPoint(props, LngLat(lng(random), lat(random)));
+    }
+    source->commitBatch();
+
+    for (int z : { 4, 10, 14, 16 }) {
+        size_t count = 0;
+        for (int x = tileX(-122.5, z); x <= tileX(-122.3, z); x++) {
+            for (int y = tileY(37.8, z); y <= tileY(37.7, z); y++) {
+                count += source->tilePoints(TileID(x, y, z));
+            }
+        }
+        REQUIRE(count == numPoints);
+    }
+}
@@ -0,0 +1,206 @@
+#include "catch.hpp"
+#include "data/clientClusterSource.h"
+#include "data/clusterIndex.h"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "tile/tileID.h"
+#include "tile/tileTask.h"
+#include "util/mapProjection.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+
+using namespace Tangram;
+
+static std::shared_ptr<ClusterIndex::Points> clusterPoints() {
+    auto points = std::make_shared<ClusterIndex::Points>();
+
+    // Three points a few meters apart and one far away
+    for (int i = 0; i < 3; i++) {
+        Properties props;
+        props.set("value", double(i + 1));
+        points->push_back({ LngLat(10.0 + i * 0.0001, 50.0), props });
+    }
+    Properties props;
+    props.set("value", 10.0);
+    points->push_back({ LngLat(-70.0, -30.0), props });
+
+    return points;
+}
+
+static const Feature* findCluster(const Layer& _layer) {
+    for (auto& feature : _layer.features) {
+        if (feature.props.getNumber("cluster") == 1) { return &feature; }
+    }
+    return nullptr;
+}
+
+TEST_CASE("Points within the radius are clustered with aggregates", "[ClusterIndex]") {
+    ClusterIndex::Options options;
+    options.maxZoom = 14;
+    options.aggregates.push_back({ "value", ClusterIndex::Aggregation::sum, "value_sum" });
+
+    ClusterIndex index(clusterPoints(), options);
+
+    REQUIRE(index.size(0) == 2);
+    REQUIRE(index.size(20) == 4);
+
+    Layer layer("");
+    index.getTile(TileID(0, 0, 0), 1, layer);
+    REQUIRE(layer.features.size() == 2);
+
+    const Feature* cluster = findCluster(layer);
+    REQUIRE(cluster != nullptr);
+    REQUIRE(cluster->props.getNumber("point_count") == 3);
+    REQUIRE(cluster->props.getNumber("value_sum") == 6);
+    REQUIRE(cluster->props.sourceId == 1);
+
+    // Above maxZoom every point is returned with its own properties
+    double scale = 1 << 16;
+    double lat = 50.0 * M_PI / 180.0;
+    double x = (10.0 / 360.0 + 0.5) * scale;
+    double y = (0.5 - std::log(std::tan(M_PI / 4.0 + lat / 2.0)) / (2.0 * M_PI)) * scale;
+    TileID tile(int32_t(x), int32_t(y), 16);
+
+    Layer points("");
+    index.getTile(tile, 1, points);
+    REQUIRE(points.features.size() == 3);
+    REQUIRE(findCluster(points) == nullptr);
+}
+
+TEST_CASE("Cluster aggregates skip points without the property", "[ClusterIndex]") {
+    auto points = clusterPoints();
+
+    // A fourth close point without 'value'
+    points->push_back({ LngLat(10.0003, 50.0), Properties() });
+
+    ClusterIndex::Options options;
+    options.aggregates.push_back({ "value", ClusterIndex::Aggregation::min, "value_min" });
+    options.aggregates.push_back({ "value", ClusterIndex::Aggregation::max, "value_max" });
+    options.aggregates.push_back({ "missing", ClusterIndex::Aggregation::sum, "missing_sum" });
+
+    ClusterIndex index(points, options);
+
+    Layer layer("");
+    index.getTile(TileID(0, 0, 0), 0, layer);
+
+    const Feature* cluster = findCluster(layer);
+    REQUIRE(cluster != nullptr);
+    REQUIRE(cluster->props.getNumber("point_count") == 4);
+    REQUIRE(cluster->props.getNumber("value_min") == 1);
+    REQUIRE(cluster->props.getNumber("value_max") == 3);
+
+    // No point has the property, so the cluster has no value for it
+    double value;
+    REQUIRE(!cluster->props.getNumber("missing_sum", value));
+}
+
+TEST_CASE("Points on tile edges are in exactly one tile", "[ClusterIndex]") {
+    auto points = std::make_shared<ClusterIndex::Points>();
+    points->push_back({ LngLat(0.0, 0.0), Properties() });
+    points->push_back({ LngLat(180.0, 0.0), Properties() });
+    points->push_back({ LngLat(-180.0, 10.0), Properties() });
+
+    ClusterIndex::Options options;
+    options.maxZoom = 0;
+
+    ClusterIndex index(points, options);
+
+    auto count = [&](TileID _tile) {
+        Layer layer("");
+        index.getTile(_tile, 0, layer);
+        return layer.features.size();
+    };
+
+    // At zoom 1 the first point is on the corner of all four tiles, it
+    // belongs to the south-east one. The point at 180 stays in the east
+    // tiles at the edge of the world.
+    REQUIRE(count(TileID(0, 0, 1)) == 1);
+    REQUIRE(count(TileID(1, 0, 1)) == 0);
+    REQUIRE(count(TileID(0, 1, 1)) == 0);
+    REQUIRE(count(TileID(1, 1, 1)) == 2);
+}
+
+struct TestClusterSource : public ClientClusterSource {
+    using ClientClusterSource::ClientClusterSource;
+    using ClientClusterSource::parse;
+
+    size_t tileFeatures(TileID _tileId) {
+        MercatorProjection projection;
+        TileTask task(_tileId, shared_from_this(), 0);
+
+        auto data = parse(task, projection);
+        if (!data) { return 0; }
+        return data->layers[0].features.size();
+    }
+};
+
+TEST_CASE("Client cluster source builds tiles from added points", "[ClusterIndex][ClientClusterSource]") {
+    ClusterIndex::Options options;
+    options.maxZoom = 14;
+
+    auto source = std::make_shared<TestClusterSource>("points", "", options);
+    REQUIRE(source->tileFeatures(TileID(0, 0, 0)) == 0);
+
+    int64_t generation = source->generation();
+    source->addPoint(Properties(), LngLat(10.0, 50.0));
+    REQUIRE(source->generation() > generation);
+    REQUIRE(source->clusterCount(0) == 1);
+
+    // Points of a batch are only indexed on commit
+    generation = source->generation();
+    source->beginBatch();
+    source->addPoint(Properties(), LngLat(10.0001, 50.0));
+    source->addPoint(Properties(), LngLat(-70.0, -30.0));
+    REQUIRE(source->clusterCount(20) == 1);
+    source->commitBatch();
+
+    REQUIRE(source->generation() > generation);
+    REQUIRE(source->clusterCount(20) == 3);
+    REQUIRE(source->clusterCount(0) == 2);
+    REQUIRE(source->tileFeatures(TileID(0, 0, 0)) == 2);
+
+    source->clearData();
+    REQUIRE(source->clusterCount(20) == 0);
+    REQUIRE(source->tileFeatures(TileID(0, 0, 0)) == 0);
+}
+
+TEST_CASE("Client cluster source adds GeoJSON points", "[ClusterIndex][ClientClusterSource]") {
+    auto source = std::make_shared<TestClusterSource>("points", "");
+
+    source->addData(R"({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "properties": { "name": "a" },
+          "geometry": { "type": "Point", "coordinates": [ 10.0, 50.0 ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "MultiPoint", "coordinates": [ [ -70.0, -30.0 ], [ 100.0, 0.0 ] ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "LineString", "coordinates": [ [ 0.0, 0.0 ], [ 1.0, 1.0 ] ] } }
+    ]})");
+
+    REQUIRE(source->clusterCount(20) == 3);
+}
+
+TEST_CASE("Client cluster source skips malformed GeoJSON points", "[ClusterIndex][ClientClusterSource]") {
+    auto source = std::make_shared<TestClusterSource>("points", "");
+
+    source->addData(R"({ "type": "FeatureCollection", "features": [
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "Point", "coordinates": [ 10.0, 50.0 ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "coordinates": [ 10.0, 50.0 ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "Point" } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "Point", "coordinates": [ 10.0 ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "Point", "coordinates": [ "10", 50.0 ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "MultiPoint", "coordinates": [ 10.0, 50.0 ] } },
+        { "type": "Feature", "properties": {},
+          "geometry": { "type": "MultiPoint", "coordinates": [ [ -70.0, -30.0 ], 5 ] } },
+        "feature"
+    ]})");
+
+    REQUIRE(source->clusterCount(20) == 1);
+}
@@ -0,0 +1,138 @@
+#include "catch.hpp"
+
+#include "data/diskTileCache.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+using namespace Tangram;
+
+std::string tempCacheDir() {
+    char path[] = "/tmp/tangram_cache_XXXXXX";
+    REQUIRE(mkdtemp(path) != nullptr);
+    return path;
+}
+
+std::vector<char> tileData(size_t _size, char _value) {
+    return std::vector<char>(_size, _value);
+}
+
+TEST_CASE( "Write and read back entries", "[DiskTileCache]" ) {
+    DiskTileCache cache(tempCacheDir(), 1024 * 1024);
+
+    REQUIRE(cache.contains("url#1/0/0") == false);
+    REQUIRE(cache.write("url#1/0/0", tileData(100, 'a')));
+    REQUIRE(cache.contains("url#1/0/0"));
+    REQUIRE(cache.contains("url#1/0/1") == false);
+
+    std::vector<char> data;
+    REQUIRE(cache.read("url#1/0/0", data));
+    REQUIRE(data == tileData(100, 'a'));
+    REQUIRE(cache.entries() == 1);
+}
+
+TEST_CASE( "Keep entries across instances", "[DiskTileCache]" ) {
+    auto path = tempCacheDir();
+    {
+        DiskTileCache cache(path, 1024 * 1024);
+        cache.put("url#2/1/1", std::make_shared<std::vector<char>>(tileData(64, 'b')));
+        cache.flush();
+    }
+
+    DiskTileCache cache(path, 1024 * 1024);
+    // The directory is scanned on the I/O thread
+    cache.flush();
+    REQUIRE(cache.entries() == 1);
+
+    std::vector<char> data;
+    REQUIRE(cache.read("url#2/1/1", data));
+    REQUIRE(data == tileData(64, 'b'));
+
+    bool loaded = false;
+    cache.load("url#2/1/1", [&](std::vector<char>&& _data) {
+            loaded = (_data == tileData(64, 'b'));
+        });
+    cache.flush();
+    REQUIRE(loaded);
+}
+
+TEST_CASE( "Evict least recently used entries", "[DiskTileCache]" ) {
+    // Room for two entries including headers
+    DiskTileCache cache(tempCacheDir(), 2 * (1000 + 64));
+
+    REQUIRE(cache.write("a", tileData(1000, 'a')));
+    REQUIRE(cache.write("b", tileData(1000, 'b')));
+
+    std::vector<char> data;
+    REQUIRE(cache.read("a", data));
+
+    REQUIRE(cache.write("c", tileData(1000, 'c')));
+
+    REQUIRE(cache.contains("a"));
+    REQUIRE(cache.contains("b") == false);
+    REQUIRE(cache.contains("c"));
+    REQUIRE(cache.usage() <= 2 * (1000 + 64));
+}
+
+TEST_CASE( "Clear all entries", "[DiskTileCache]" ) {
+    auto path = tempCacheDir();
+    DiskTileCache cache(path, 1024 * 1024);
+
+    REQUIRE(cache.write("key", tileData(100, 'x')));
+    cache.clear();
+    REQUIRE(cache.entries() == 0);
+    REQUIRE(cache.usage() == 0);
+
+    std::vector<char> data;
+    REQUIRE(cache.read("key", data) == false);
+
+    DiskTileCache reopened(path, 1024 * 1024);
+    reopened.flush();
+    REQUIRE(reopened.entries() == 0);
+}
+
+TEST_CASE( "Pending loads complete when the cache is destroyed", "[DiskTileCache]" ) {
+    std::atomic<int> loaded(0);
+    const int numLoads = 100;
+    {
+        DiskTileCache cache(tempCacheDir(), 1024 * 1024);
+        REQUIRE(cache.write("key", tileData(100, 'x')));
+
+        for (int i = 0; i < numLoads; i++) {
+            cache.load("key", [&](std::vector<char>&& _data) { loaded++; });
+        }
+    }
+    // Each callback ran, with the data or empty when the load was canceled
+    REQUIRE(loaded == numLoads);
+}
+
+TEST_CASE( "Remove leftover temporary files on startup", "[DiskTileCache]" ) {
+    auto path = tempCacheDir();
+    {
+        DiskTileCache cache(path, 1024 * 1024);
+        REQUIRE(cache.write("key", tileData(100, 'x')));
+    }
+    std::string tmpPath = path + "/00/stale.tmp";
+    REQUIRE((mkdir((path + "/00").c_str(), 0755) == 0 || errno == EEXIST));
+    {
+        FILE* file = fopen(tmpPath.c_str(), "w");
+        REQUIRE(file != nullptr);
+        fclose(file);
+        // Older than the next cache instance
+        struct utimbuf times = { 0, 0 };
+        REQUIRE(utime(tmpPath.c_str(), &times) == 0);
+    }
+
+    DiskTileCache cache(path, 1024 * 1024);
+    cache.flush();
+    REQUIRE(cache.entries() == 1);
+    REQUIRE(access(tmpPath.c_str(), F_OK) != 0);
+}
@@ -368,3 +368,65 @@ TEST_CASE( "Test evalFunction explicit", "[Duktape][evalFunction]") {
     }
 
 }
+
+TEST_CASE( "Test native functions match Duktape", "[Duktape][NativeFunction]") {
+    std::vector<std::string> functions = {
+        R"(function() { return feature.kind === 'park' && $zoom >= 12; })",
+        R"(function() { return $geometry === 'line' || feature.name == 42; })",
+        R"(function() { return (feature.scalerank * .5) <= ($zoom - 4); })",
+        R"(function() { return feature.missing === undefined ? 'a' : 'b'; })",
+        R"(function() { return feature['name'] + 5; })",
+        R"(function() { return -feature.height % 3 + 0xff; })",
+        R"(function() { return !feature.kind; })",
+        R"(function() { return feature.name !== '42'; })",
+        R"(function() { return feature.height / 1e8 + ''; })",
+        R"(function() { return feature.height * 1e21 + ' ' + 1 / feature.height; })",
+    };
+
+    std::vector<Feature> features(3);
+    features[0].geometryType = GeometryType::polygons;
+    features[0].props.set("kind", "park");
+    features[0].props.set("name", "42");
+    features[0].props.set("scalerank", 12);
+    features[1].geometryType = GeometryType::lines;
+    features[1].props.set("name", 42);
+    features[1].props.set("height", 7.5);
+    features[2].geometryType = GeometryType::points;
+
+    StyleContext native, duktape;
+    duktape.setNativeFunctions(false);
+    REQUIRE(native.setFunctions(functions));
+    REQUIRE(duktape.setFunctions(functions));
+
+    for (int zoom : { 10, 14 }) {
+        native.setKeywordZoom(zoom);
+        duktape.setKeywordZoom(zoom);
+
+        for (auto& feature : features) {
+            native.setFeature(feature);
+            duktape.setFeature(feature);
+
+            for (uint32_t id = 0; id < functions.size(); id++) {
+                REQUIRE(native.evalFilter(id) == duktape.evalFilter(id));
+
+                StyleParam::Value nativeValue, duktapeValue;
+                REQUIRE(native.evalStyle(id, StyleParamKey::order, nativeValue) ==
+                        duktape.evalStyle(id, StyleParamKey::order, duktapeValue));
+                REQUIRE(nativeValue.which() == duktapeValue.which());
+                if (nativeValue.is<uint32_t>()) {
+                    REQUIRE(nativeValue.get<uint32_t>() == duktapeValue.get<uint32_t>());
+                }
+
+                for (auto key : { StyleParamKey::width, StyleParamKey::text_source }) {
+                    StyleParam::Value nativeValue, duktapeValue;
+                    REQUIRE(native.evalStyle(id, key, nativeValue) ==
+                            duktape.evalStyle(id, key, duktapeValue));
+                    REQUIRE(nativeValue.which() == duktapeValue.which());
+                    if (nativeValue.is<std::string>()) {
+                        REQUIRE(nativeValue.get<std::string>() == duktapeValue.get<std::string>());
+                    }
+                }
+            }
+        }
+    }
+}
@@ -5,14 +5,20 @@
 #include "style/style.h"
 #include "style/textStyle.h"
 #include "labels/labels.h"
+#include "labels/collisionGrid.h"
 #include "labels/textLabel.h"
 #include "labels/textLabels.h"
 #include "gl/dynamicQuadMesh.h"
 
 #include "view/view.h"
 #include "tile/tile.h"
+#include "tile/tileCache.h"
 
+#include "glm/gtc/matrix_transform.hpp"
+
+#include <limits>
 #include <memory>
+#include <thread>
 
 namespace Tangram {
 
@@ -20,9 +26,11 @@ glm::vec2 screenSize(256.f, 256.f);
 TextStyle dummyStyle("textStyle");
 TextLabels dummy(dummyStyle);
 
-std::unique_ptr<TextLabel> makeLabel(Label::Transform _transform, Label::Type _type, std::string id) {
+std::unique_ptr<TextLabel> makeLabel(Label::Transform _transform, Label::Type _type, std::string id,
+                                     float _priority = std::numeric_limits<float>::max()) {
     Label::Options options;
     options.offset = {0.0f, 0.0f};
+    options.priority = _priority;
     options.properties = std::make_shared<Properties>();
     options.properties->set("id", id);
     options.interactive = true;
@@ -81,4 +89,191 @@ TEST_CASE("Test getFeaturesAtPoint", "[Labels][FeaturePicking]") {
     }
 }
 
+TEST_CASE("Test CollisionGrid keeps collisions of labels that did not move", "[Labels][CollisionGrid]") {
+    CollisionGrid grid;
+
+    glm::mat4 mvp(1.0);
+
+    // Centered labels, the first two overlap
+    auto l0 = makeLabel(glm::vec2{0.f, 0.f}, Label::Type::point, "0");
+    auto l1 = makeLabel(glm::vec2{0.05f, 0.f}, Label::Type::point, "1");
+    auto l2 = makeLabel(glm::vec2{0.5f, 0.5f}, Label::Type::point, "2");
+
+    auto countCollisions = [&](const Label& _label) {
+        int count = 0;
+        grid.forEachCollision(_label.id(), [&](uint32_t) { count++; });
+        return count;
+    };
+
+    auto update = [&](Label& _label) {
+        grid.update(_label.id(), _label.aabb(), _label.obb(), 0);
+    };
+
+    for (auto* label : { l0.get(), l1.get(), l2.get() }) {
+        label->update(mvp, screenSize, 0);
+        update(*label);
+    }
+    grid.commit();
+
+    REQUIRE(grid.moved() == 3);
+    REQUIRE(countCollisions(*l0) == 1);
+    REQUIRE(countCollisions(*l1) == 1);
+    REQUIRE(countCollisions(*l2) == 0);
+
+    // Nothing moved
+    for (auto* label : { l0.get(), l1.get(), l2.get() }) {
+        label->update(mvp, screenSize, 0);
+        update(*label);
+    }
+    grid.commit();
+
+    REQUIRE(grid.moved() == 0);
+    REQUIRE(countCollisions(*l0) == 1);
+
+    // Move the second label next to the third, drop the first
+    l1->update(glm::translate(mvp, glm::vec3(0.45f, 0.5f, 0.f)), screenSize, 0);
+    update(*l1);
+    l2->update(mvp, screenSize, 0);
+    update(*l2);
+    grid.commit();
+
+    REQUIRE(grid.size() == 2);
+    REQUIRE(grid.moved() == 1);
+    REQUIRE(countCollisions(*l0) == 0);
+    REQUIRE(countCollisions(*l1) == 1);
+    REQUIRE(countCollisions(*l2) == 1);
+}
+
+TEST_CASE("Test CollisionGrid does not re-test labels when the view pans", "[Labels][CollisionGrid]") {
+    CollisionGrid grid;
+
+    auto l0 = makeLabel(glm::vec2{0.f, 0.f}, Label::Type::point, "0");
+    auto l1 = makeLabel(glm::vec2{0.05f, 0.f}, Label::Type::point, "1");
+
+    auto update = [&](glm::vec2 _pan) {
+        // Pan by _pan pixels, the origin moves on screen with the labels
+        // (screen y points down)
+        glm::mat4 mvp = glm::translate(glm::mat4(1.0), glm::vec3(_pan / screenSize * 2.f, 0.f));
+        grid.setOrigin(screenSize * 0.5f + glm::vec2(_pan.x, -_pan.y));
+
+        for (auto* label : { l0.get(), l1.get() }) {
+            label->update(mvp, screenSize, 0);
+            grid.update(label->id(), label->aabb(), label->obb(), 0);
+        }
+        grid.commit();
+    };
+
+    update(glm::vec2(0.f));
+    REQUIRE(grid.moved() == 2);
+
+    for (float x = 1.f; x < 100.f; x += 7.3f) {
+        update(glm::vec2(x, -x));
+        REQUIRE(grid.moved() == 0);
+    }
+
+    int count = 0;
+    grid.forEachCollision(l0->id(), [&](uint32_t) { count++; });
+    REQUIRE(count == 1);
+}
+
+struct PlacementTest {
+    struct TestLabelMesh : public LabelSet {
+        void addLabel(std::unique_ptr<Label> _label) { m_labels.push_back(std::move(_label)); }
+    };
+
+    View view{256, 256};
+    std::vector<std::unique_ptr<Style>> styles;
+    std::unique_ptr<TileCache> cache{new TileCache(0)};
+    Labels labels;
+
+    PlacementTest() {
+        view.setPosition(0, 0);
+        view.setZoom(0);
+        view.update(false);
+
+        auto textStyle = std::unique_ptr<TextStyle>(new TextStyle("test", false));
+        textStyle->setID(0);
+        styles.push_back(std::move(textStyle));
+    }
+
+    // Tile with one 10x10 label
+    std::shared_ptr<Tile> makeTile(glm::vec2 _position, float _priority, Label*& _label) {
+        auto label = makeLabel(_position, Label::Type::point, "0", _priority);
+        _label = label.get();
+
+        auto labelMesh = std::unique_ptr<TestLabelMesh>(new TestLabelMesh());
+        labelMesh->addLabel(std::move(label));
+
+        std::shared_ptr<Tile> tile(new Tile({0,0,0}, view.getMapProjection()));
+        tile->initGeometry(1);
+        tile->setMesh(*styles[0], std::move(labelMesh));
+        tile->update(0, view);
+        return tile;
+    }
+
+    // Start a placement and apply its results
+    void place(const std::vector<std::shared_ptr<Tile>>& _tiles) {
+        labels.updateLabelSet(view, 0, styles, _tiles, cache);
+        REQUIRE(labels.placementPending());
+
+        while (labels.placementPending()) {
+            std::this_thread::yield();
+            labels.updateLabels(view, 0, styles, _tiles);
+        }
+    }
+};
+
+TEST_CASE("Labels are placed on the worker and fade in", "[Labels][Placement]") {
+    PlacementTest test;
+
+    // The first two labels overlap
+    Label *l0, *l1, *l2;
+    std::vector<std::shared_ptr<Tile>> tiles = {
+        test.makeTile({0.5f, 0.5f}, 0, l0),
+        test.makeTile({0.51f, 0.5f}, 1, l1),
+        test.makeTile({0.25f, 0.25f}, 0, l2)
+    };
+
+    test.place(tiles);
+
+    REQUIRE(l0->state() == Label::State::fading_in);
+    REQUIRE(l1->state() == Label::State::dead);
+    REQUIRE(l2->state() == Label::State::fading_in);
+
+    // Longer than the show transition
+    test.labels.updateLabels(test.view, 1.f, test.styles, tiles);
+
+    REQUIRE(l0->state() == Label::State::visible);
+    REQUIRE(l0->transform().state.alpha == 1.f);
+    REQUIRE(l2->state() == Label::State::visible);
+}
+
+TEST_CASE("Occluded labels fade out and show up again without the occluder", "[Labels][Placement]") {
+    PlacementTest test;
+
+    Label *l0, *l1;
+    auto tile0 = test.makeTile({0.5f, 0.5f}, 1, l0);
+    auto tile1 = test.makeTile({0.51f, 0.5f}, 0, l1);
+
+    test.place({ tile0 });
+    test.labels.updateLabels(test.view, 1.f, test.styles, { tile0 });
+    REQUIRE(l0->state() == Label::State::visible);
+
+    // A label with higher priority shows up
+    test.place({ tile0, tile1 });
+    REQUIRE(l0->state() == Label::State::fading_out);
+    REQUIRE(l1->state() == Label::State::fading_in);
+
+    test.labels.updateLabels(test.view, 1.f, test.styles, { tile0, tile1 });
+    REQUIRE(l0->state() == Label::State::sleep);
+    REQUIRE(l1->state() == Label::State::visible);
+
+    // Only projected by the worker while it sleeps
+    test.place({ tile0 });
+    REQUIRE(l0->state() == Label::State::fading_in);
+
+    test.labels.updateLabels(test.view, 1.f, test.styles, { tile0 });
+    REQUIRE(l0->state() == Label::State::visible);
+}
+
 }
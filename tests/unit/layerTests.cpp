@@ -216,3 +216,38 @@ TEST_CASE("SceneLayer correctly merges rules matched from sublayer", "[SceneLaye
     REQUIRE(matches[0].findParameter(StyleParamKey::order).value.get<std::string>() == "value_c");
 
 }
+
+TEST_CASE("DrawRuleMergeSet reuses matches for features with equal filter properties", "[SceneLayer][Filter][DrawRule]") {
+
+    Context ctx;
+    DrawRuleMergeSet ruleSet;
+
+    auto layer = instance();
+
+    Feature f1, f2, f3;
+    f1.props.set("base", "blah");
+    f1.props.set("one", "blah");
+    f1.props.set("name", "a");
+    // Differs only in a property that no filter reads
+    f2.props.set("base", "blah");
+    f2.props.set("one", "blah");
+    f2.props.set("name", "b");
+    // Differs in a filtered property
+    f3.props.set("base", "blah");
+    f3.props.set("two", "blah");
+
+    REQUIRE(ruleSet.match(f1, layer, ctx));
+    REQUIRE(ruleSet.match(f2, layer, ctx));
+    REQUIRE(ruleSet.matchedRules().size() == 1);
+    REQUIRE(ruleSet.matchedRules()[0].getStyleName() == "group1");
+
+    REQUIRE(ruleSet.match(f3, layer, ctx));
+    REQUIRE(ruleSet.matchedRules().size() == 2);
+
+    REQUIRE(ruleSet.cacheStats().hits == 1);
+    REQUIRE(ruleSet.cacheStats().misses == 2);
+
+    ruleSet.clearCache();
+    REQUIRE(ruleSet.match(f2, layer, ctx));
+    REQUIRE(ruleSet.cacheStats().hits == 0);
+}
@@ -0,0 +1,77 @@
+#include "catch.hpp"
+
+#include "util/lineSegments.h"
+#include "util/builders.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+using namespace Tangram;
+
+static Line randomLine(std::mt19937& _rng, size_t _size) {
+    std::uniform_real_distribution<float> coord(-0.2f, 1.2f);
+    Line line;
+    for (size_t i = 0; i < _size; i++) {
+        Point p(coord(_rng), coord(_rng), (i % 3 == 0) ? coord(_rng) : 0.f);
+        line.push_back(p);
+        // Add some duplicate points
+        if (_rng() % 7 == 0) { line.push_back(p); }
+    }
+    return line;
+}
+
+// Distance in units in the last place between two finite floats of the same sign
+static uint32_t ulpDistance(float _a, float _b) {
+    if (_a == _b) { return 0; }
+    int32_t a, b;
+    std::memcpy(&a, &_a, sizeof(a));
+    std::memcpy(&b, &_b, sizeof(b));
+    return a > b ? uint32_t(a - b) : uint32_t(b - a);
+}
+
+TEST_CASE("Vectorized line segments match the scalar path", "[Core][Builders]") {
+    std::mt19937 rng(0);
+
+    for (size_t size : { 1, 2, 3, 4, 5, 8, 9, 33, 10000 }) {
+        Line line = randomLine(rng, size);
+
+        LineSegments simd, scalar;
+        simd.compute(line);
+        scalar.computeScalar(line);
+
+        REQUIRE(simd.normals.size() == line.size());
+        REQUIRE(scalar.normals.size() == line.size());
+
+        for (size_t i = 0; i < line.size(); i++) {
+            // Degenerate segments have NaN normals in both paths
+            REQUIRE(std::isnan(simd.normals[i].x) == std::isnan(scalar.normals[i].x));
+            if (std::isnan(scalar.normals[i].x)) { continue; }
+
+            // Both paths use the same operations in the same order, but allow
+            // for a compiler that still contracts the scalar ones into FMAs
+            REQUIRE(ulpDistance(simd.normals[i].x, scalar.normals[i].x) <= 2);
+            REQUIRE(ulpDistance(simd.normals[i].y, scalar.normals[i].y) <= 2);
+            REQUIRE(ulpDistance(simd.lengths[i], scalar.lengths[i]) <= 2);
+        }
+    }
+}
+
+TEST_CASE("Line segments match glm normals and distances", "[Core][Builders]") {
+    std::mt19937 rng(1);
+    Line line = randomLine(rng, 100);
+
+    LineSegments segments;
+    segments.compute(line);
+
+    for (size_t i = 0; i + 1 < line.size(); i++) {
+        if (line[i] == line[i+1]) { continue; }
+
+        glm::vec2 normal = glm::normalize(perp2d(line[i], line[i+1]));
+
+        REQUIRE(std::abs(segments.normals[i].x - normal.x) < 1e-6f);
+        REQUIRE(std::abs(segments.normals[i].y - normal.y) < 1e-6f);
+        REQUIRE(std::abs(segments.lengths[i] - glm::distance(line[i], line[i+1])) < 1e-6f);
+    }
+}
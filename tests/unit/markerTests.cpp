@@ -0,0 +1,84 @@
+#include "catch.hpp"
+#include "tangram.h"
+#include "marker/markerManager.h"
+#include "scene/scene.h"
+#include "style/pointStyle.h"
+#include "view/view.h"
+
+#include <memory>
+
+using namespace Tangram;
+
+static std::shared_ptr<Scene> markerScene() {
+    auto scene = std::make_shared<Scene>();
+    scene->styles().emplace_back(new PointStyle("points"));
+    scene->styles().back()->setID(0);
+    return scene;
+}
+
+TEST_CASE("Markers get labels once they are positioned and visible", "[Markers]") {
+    View view(256, 256);
+    view.setPosition(0, 0);
+    view.setZoom(10);
+    view.update(false);
+
+    MarkerManager markers;
+    markers.setScene(markerScene());
+
+    MarkerID a = markers.add();
+    MarkerID b = markers.add();
+
+    REQUIRE(markers.update(view));
+    REQUIRE(markers.labels().empty());
+
+    markers.setPosition(a, {100, 100});
+    markers.setPosition(b, {-100, 100});
+
+    REQUIRE(markers.update(view));
+    REQUIRE(markers.labels().size() == 2);
+
+    // Nothing changed
+    REQUIRE(!markers.update(view));
+
+    // Moving keeps the label
+    const Label* label = markers.labels()[0];
+    markers.setPosition(a, {200, 100});
+    REQUIRE(markers.update(view));
+    REQUIRE(markers.labels()[0] == label);
+
+    markers.setVisible(b, false);
+    markers.update(view);
+    REQUIRE(markers.labels().size() == 1);
+
+    REQUIRE(markers.remove(a));
+    REQUIRE(!markers.remove(a));
+    markers.update(view);
+    REQUIRE(markers.labels().empty());
+    REQUIRE(markers.size() == 1);
+
+    markers.setVisible(b, true);
+    markers.update(view);
+    REQUIRE(markers.labels().size() == 1);
+}
+
+TEST_CASE("Markers without a point style are not drawn", "[Markers]") {
+    View view(256, 256);
+    view.update(false);
+
+    MarkerManager markers;
+    markers.setScene(markerScene());
+
+    MarkerID id = markers.add();
+    markers.setPosition(id, {0, 0});
+
+    MarkerStyle style;
+    style.style = "missing";
+    markers.setStyle(id, style);
+
+    markers.update(view);
+    REQUIRE(markers.labels().empty());
+
+    markers.setStyle(id, MarkerStyle());
+    markers.update(view);
+    REQUIRE(markers.labels().size() == 1);
+}
@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include "gl/mesh.h"
+#include "gl/hardware.h"
 
 using namespace Tangram;
 
@@ -27,6 +28,8 @@ struct TestMesh : public Mesh<Vertex> {
 
     int numVertices() const { return m_nVertices; }
     int numIndices() const { return m_nIndices; }
+    size_t numBatches() const { return m_vertexOffsets.size(); }
+    GLenum indexType() const { return m_indexType; }
 };
 
 std::shared_ptr<TestMesh> newMesh(unsigned int size) {
@@ -170,3 +173,42 @@ TEST_CASE( "Check overflow", "[Core][TypedMesh]" ) {
 
     checkBounds(mesh);
 }
+
+std::shared_ptr<TestMesh> newIndexedMesh(size_t chunks, size_t verticesPerChunk) {
+    auto mesh = std::make_shared<TestMesh>(layout, GL_TRIANGLES);
+    MeshData<Vertex> meshData;
+
+    for (size_t i = 0; i < chunks; ++i) {
+        meshData.vertices.resize(meshData.vertices.size() + verticesPerChunk);
+        meshData.indices.insert(meshData.indices.end(), { 0, 1, 2 });
+        meshData.offsets.emplace_back(3, verticesPerChunk);
+    }
+    mesh->compile(meshData);
+    return mesh;
+}
+
+TEST_CASE( "Large meshes are split into batches of 16-bit indices", "[Core][TypedMesh]" ) {
+    Hardware::supportsElementIndexUint = false;
+
+    auto mesh = newIndexedMesh(3, 30000);
+
+    REQUIRE(mesh->indexType() == GL_UNSIGNED_SHORT);
+    REQUIRE(mesh->numBatches() == 2);
+    REQUIRE(mesh->bufferSize() == 90000 * layout->getStride() + 9 * sizeof(GLushort));
+}
+
+TEST_CASE( "Large meshes use 32-bit indices when supported", "[Core][TypedMesh]" ) {
+    Hardware::supportsElementIndexUint = true;
+
+    auto mesh = newIndexedMesh(3, 30000);
+    REQUIRE(mesh->indexType() == GL_UNSIGNED_INT);
+    REQUIRE(mesh->numBatches() == 1);
+    REQUIRE(mesh->bufferSize() == 90000 * layout->getStride() + 9 * sizeof(GLuint));
+
+    // Small meshes keep 16-bit indices
+    auto small = newIndexedMesh(3, 100);
+    REQUIRE(small->indexType() == GL_UNSIGNED_SHORT);
+    REQUIRE(small->numBatches() == 1);
+
+    Hardware::supportsElementIndexUint = false;
+}
@@ -0,0 +1,145 @@
+#include "catch.hpp"
+
+#include "util/parallel.h"
+#include "util/builders.h"
+#include "gl/mesh.h"
+
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace Tangram;
+
+TEST_CASE("Split small workloads into one chunk", "[Core][Parallel]") {
+    std::vector<size_t> weights(10, 100);
+
+    auto chunks = Parallel::split(weights, 8192, 4);
+
+    REQUIRE(chunks.size() == 1);
+    REQUIRE(chunks[0].begin == 0);
+    REQUIRE(chunks[0].end == 10);
+}
+
+TEST_CASE("Split large workloads into consecutive chunks", "[Core][Parallel]") {
+    std::vector<size_t> weights(100, 1000);
+
+    auto chunks = Parallel::split(weights, 8192, 4);
+
+    REQUIRE(chunks.size() == 4);
+    REQUIRE(chunks.front().begin == 0);
+    REQUIRE(chunks.back().end == 100);
+    for (size_t i = 1; i < chunks.size(); i++) {
+        REQUIRE(chunks[i].begin == chunks[i-1].end);
+        REQUIRE(chunks[i].end - chunks[i].begin == 25);
+    }
+}
+
+TEST_CASE("Run chunks into separate results", "[Core][Parallel]") {
+    std::vector<size_t> weights(1000, 100);
+    auto chunks = Parallel::split(weights, 1000, 8);
+
+    std::vector<std::vector<size_t>> results(chunks.size());
+
+    Parallel::forEachChunk(chunks, [&](size_t i, Parallel::Chunk chunk) {
+        for (size_t j = chunk.begin; j < chunk.end; j++) { results[i].push_back(j); }
+    });
+
+    size_t expected = 0;
+    for (auto& result : results) {
+        for (auto j : result) { REQUIRE(j == expected++); }
+    }
+    REQUIRE(expected == 1000);
+}
+
+TEST_CASE("Run chunks from several threads at once", "[Core][Parallel]") {
+    const size_t callers = 8;
+    std::vector<std::vector<size_t>> results(callers, std::vector<size_t>(64, 0));
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < callers; t++) {
+        threads.emplace_back([&, t]() {
+            for (int n = 0; n < 100; n++) {
+                Parallel::run(results[t].size(), [&](size_t i) { results[t][i]++; });
+            }
+        });
+    }
+    for (auto& thread : threads) { thread.join(); }
+
+    for (auto& result : results) {
+        for (auto count : result) { REQUIRE(count == 100); }
+    }
+}
+
+struct PolygonTestVertex {
+    glm::vec3 position;
+    glm::vec2 uv;
+};
+
+struct PolygonTestMesh : public Mesh<PolygonTestVertex> {
+    using Base = Mesh<PolygonTestVertex>;
+    using Base::Base;
+
+    size_t vertexBytes() const { return m_nVertices * sizeof(PolygonTestVertex); }
+    size_t indexBytes() const { return m_nIndices * indexSize(); }
+    const GLbyte* vertexData() const { return m_glVertexData; }
+    const GLbyte* indexData() const { return m_glIndexData; }
+};
+
+// Build @_polygons into one MeshData per chunk, as PolygonStyleBuilder does
+static std::vector<MeshData<PolygonTestVertex>> buildPolygons(const std::vector<Polygon>& _polygons,
+                                                              const std::vector<Parallel::Chunk>& _chunks) {
+    std::vector<MeshData<PolygonTestVertex>> meshData(_chunks.size());
+
+    Parallel::forEachChunk(_chunks, [&](size_t i, Parallel::Chunk chunk) {
+        PolygonBuilder builder;
+        auto& mesh = meshData[i];
+
+        for (size_t j = chunk.begin; j < chunk.end; j++) {
+            Builders::buildPolygon(_polygons[j], 0.f, builder,
+                                   [&](const glm::vec3& _coord, const glm::vec3&, const glm::vec2& _uv) {
+                mesh.vertices.push_back({ _coord, _uv });
+            });
+            mesh.indices.insert(mesh.indices.end(), builder.indices.begin(), builder.indices.end());
+            mesh.offsets.emplace_back(builder.indices.size(), builder.numVertices);
+            builder.clear();
+        }
+    });
+    return meshData;
+}
+
+TEST_CASE("Polygon meshes built in parallel chunks equal the serial build", "[Core][Parallel]") {
+    std::mt19937 rng(0);
+    std::uniform_real_distribution<float> coord(0.f, 1.f);
+    std::uniform_real_distribution<float> size(0.001f, 0.01f);
+
+    std::vector<Polygon> polygons;
+    std::vector<size_t> points;
+    for (int i = 0; i < 2000; i++) {
+        glm::vec3 o(coord(rng), coord(rng), 0.f);
+        float s = size(rng);
+        Line ring = { o, o + glm::vec3(s, 0, 0), o + glm::vec3(s, s, 0),
+                      o + glm::vec3(s * 0.5f, s * 1.5f, 0), o + glm::vec3(0, s, 0), o };
+        polygons.push_back({ ring });
+        points.push_back(ring.size());
+    }
+
+    auto layout = std::shared_ptr<VertexLayout>(new VertexLayout({
+        {"a_position", 3, GL_FLOAT, false, 0},
+        {"a_uv", 2, GL_FLOAT, false, 0},
+    }));
+
+    auto chunks = Parallel::split(points, 1000, 4);
+    REQUIRE(chunks.size() == 4);
+
+    PolygonTestMesh parallel(layout, GL_TRIANGLES);
+    parallel.compile(buildPolygons(polygons, chunks));
+
+    PolygonTestMesh serial(layout, GL_TRIANGLES);
+    serial.compile(buildPolygons(polygons, { { 0, polygons.size() } }));
+
+    REQUIRE(parallel.vertexBytes() == serial.vertexBytes());
+    REQUIRE(parallel.indexBytes() == serial.indexBytes());
+    REQUIRE(std::memcmp(parallel.vertexData(), serial.vertexData(), serial.vertexBytes()) == 0);
+    REQUIRE(std::memcmp(parallel.indexData(), serial.indexData(), serial.indexBytes()) == 0);
+}
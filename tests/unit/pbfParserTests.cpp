@@ -0,0 +1,213 @@
+#include "catch.hpp"
+#include "data/propertyItem.h"
+#include "data/tileData.h"
+#include "util/arena.h"
+#include "util/pbfParser.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Tangram;
+
+// Minimal protobuf writer for building test tiles
+struct PbfWriter {
+    std::string buffer;
+
+    void varint(uint64_t _value) {
+        while (_value >= 0x80) {
+            buffer.push_back(char((_value & 0x7f) | 0x80));
+            _value >>= 7;
+        }
+        buffer.push_back(char(_value));
+    }
+    void field(uint32_t _tag, uint32_t _type) { varint((_tag << 3) | _type); }
+    void uint(uint32_t _tag, uint64_t _value) { field(_tag, 0); varint(_value); }
+    void bytes(uint32_t _tag, const std::string& _value) {
+        field(_tag, 2);
+        varint(_value.size());
+        buffer += _value;
+    }
+    void float64(uint32_t _tag, double _value) {
+        field(_tag, 1);
+        char data[8];
+        std::memcpy(data, &_value, 8);
+        buffer.append(data, 8);
+    }
+    void packed(uint32_t _tag, const std::vector<uint32_t>& _values) {
+        PbfWriter packed;
+        for (auto value : _values) { packed.varint(value); }
+        bytes(_tag, packed.buffer);
+    }
+};
+
+static uint32_t command(uint32_t _cmd, uint32_t _count) { return (_cmd & 0x7) | (_count << 3); }
+static uint32_t zigzag(int32_t _value) { return (uint32_t(_value) << 1) ^ uint32_t(_value >> 31); }
+
+// Geometry commands for @_rings, each ring as absolute (x, y) pairs
+static std::vector<uint32_t> encodeLines(const std::vector<std::vector<int>>& _rings, bool _close) {
+    std::vector<uint32_t> cmds;
+    int x = 0, y = 0;
+    for (auto& ring : _rings) {
+        for (size_t i = 0; i < ring.size(); i += 2) {
+            if (i == 0) { cmds.push_back(command(1, 1)); }
+            if (i == 2) { cmds.push_back(command(2, ring.size() / 2 - 1)); }
+            cmds.push_back(zigzag(ring[i] - x));
+            cmds.push_back(zigzag(ring[i + 1] - y));
+            x = ring[i];
+            y = ring[i + 1];
+        }
+        if (_close) { cmds.push_back(command(7, 1)); }
+    }
+    return cmds;
+}
+
+static std::vector<char> encodeTile() {
+    PbfWriter layer;
+    layer.bytes(1, "test");
+    layer.uint(5, 4096);
+
+    layer.bytes(3, "name");
+    layer.bytes(3, "kind");
+    layer.bytes(3, "height");
+
+    PbfWriter value;
+    value.bytes(1, "Main Street");
+    layer.bytes(4, value.buffer);
+    value = {};
+    value.bytes(1, "road");
+    layer.bytes(4, value.buffer);
+    value = {};
+    value.float64(3, 42.5);
+    layer.bytes(4, value.buffer);
+
+    // Points
+    PbfWriter feature;
+    feature.packed(2, { 1, 1 });
+    feature.uint(3, GeometryType::points);
+    feature.packed(4, { command(1, 2), zigzag(10), zigzag(20), zigzag(5), zigzag(5) });
+    layer.bytes(2, feature.buffer);
+
+    // Lines, with a repeated point
+    feature = {};
+    feature.packed(2, { 1, 1, 0, 0 });
+    feature.uint(3, GeometryType::lines);
+    feature.packed(4, encodeLines({ { 0, 0, 100, 0, 100, 0, 100, 100 }, { 200, 200, 300, 300 } }, false));
+    layer.bytes(2, feature.buffer);
+
+    // Two polygons, the first with a hole, and a ring without area
+    feature = {};
+    feature.packed(2, { 2, 2 });
+    feature.uint(3, GeometryType::polygons);
+    feature.packed(4, encodeLines({ { 0, 0, 1000, 0, 1000, 1000, 0, 1000 },
+                                    { 100, 100, 100, 200, 200, 200, 200, 100 },
+                                    { 10, 10, 20, 20, 30, 30 },
+                                    { 2000, 2000, 3000, 2000, 3000, 3000 } }, true));
+    layer.bytes(2, feature.buffer);
+
+    PbfWriter tile;
+    tile.bytes(3, layer.buffer);
+    return std::vector<char>(tile.buffer.begin(), tile.buffer.end());
+}
+
+static std::vector<Point> flatLine(const FlatLayer& _layer, uint32_t _line) {
+    return std::vector<Point>(_layer.coordinates.begin() + _layer.lineBegin(_line),
+                              _layer.coordinates.begin() + _layer.lineEnds[_line]);
+}
+
+TEST_CASE("Flat MVT layer matches the nested layer", "[PbfParser]") {
+    auto data = encodeTile();
+
+    protobuf::message layerMsg;
+    protobuf::message item(data.data(), data.size());
+    while (item.next()) { layerMsg = item.getMessage(); }
+
+    PbfParser::ParserContext ctx(0);
+    Layer layer = PbfParser::getLayer(ctx, layerMsg);
+
+    Arena arena(256);
+    PbfParser::ParserContext flatCtx(0);
+    FlatLayer flat = PbfParser::getFlatLayer(flatCtx, arena, layerMsg);
+
+    REQUIRE(flat.name.str() == layer.name);
+    REQUIRE(flat.features.size() == layer.features.size());
+    REQUIRE(flat.features.size() == 3);
+
+    for (size_t i = 0; i < layer.features.size(); i++) {
+        const auto& feature = layer.features[i];
+        const auto& flatFeature = flat.features[i];
+
+        REQUIRE(flatFeature.geometryType == feature.geometryType);
+
+        // Properties, in the same order
+        const auto& items = feature.props.items();
+        uint32_t numProps = flatFeature.propsEnd - flatFeature.propsBegin;
+        REQUIRE(numProps == items.size());
+        for (size_t p = 0; p < items.size(); p++) {
+            const auto& prop = flat.properties[flatFeature.propsBegin + p];
+            REQUIRE(flat.keys[prop.key].str() == items[p].key);
+            REQUIRE(flat.keyIds[prop.key] == items[p].keyId);
+
+            const auto& value = flat.values[prop.value];
+            if (value.type == FlatValue::Type::string) {
+                REQUIRE(items[p].value.get<std::string>() == value.string.str());
+                // Points into the tile data
+                bool inTile = value.string.data >= data.data() &&
+                    value.string.data + value.string.size <= data.data() + data.size();
+                REQUIRE(inTile);
+            } else {
+                REQUIRE(items[p].value.get<double>() == value.number);
+            }
+        }
+
+        uint32_t numLines = flatFeature.linesEnd - flatFeature.linesBegin;
+        uint32_t numPolygons = flatFeature.polygonsEnd - flatFeature.polygonsBegin;
+
+        switch (feature.geometryType) {
+        case GeometryType::points:
+            REQUIRE(numLines == 1);
+            REQUIRE(flatLine(flat, flatFeature.linesBegin) == feature.points);
+            break;
+        case GeometryType::lines:
+            REQUIRE(numLines == feature.lines.size());
+            for (size_t l = 0; l < feature.lines.size(); l++) {
+                REQUIRE(flatLine(flat, flatFeature.linesBegin + l) == feature.lines[l]);
+            }
+            break;
+        case GeometryType::polygons:
+            REQUIRE(feature.polygons.size() == 2);
+            REQUIRE(numPolygons == feature.polygons.size());
+            for (size_t p = 0; p < feature.polygons.size(); p++) {
+                uint32_t polygon = flatFeature.polygonsBegin + p;
+                uint32_t ring = flat.polygonBegin(flatFeature, polygon);
+                uint32_t numRings = flat.polygonEnds[polygon] - ring;
+                REQUIRE(numRings == feature.polygons[p].size());
+                for (auto& line : feature.polygons[p]) {
+                    REQUIRE(flatLine(flat, ring++) == line);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+TEST_CASE("Arena merges its blocks on reset", "[Arena]") {
+    Arena arena(64);
+
+    arena.allocate(48, 8);
+    uintptr_t aligned = reinterpret_cast<uintptr_t>(arena.allocate(48, 8)) % 8;
+    REQUIRE(aligned == 0);
+    REQUIRE(arena.blocks() == 2);
+    REQUIRE(arena.used() == 96);
+
+    arena.reset();
+    REQUIRE(arena.blocks() == 1);
+    REQUIRE(arena.used() == 0);
+
+    // The same allocations fit into the merged block
+    arena.allocate(48, 8);
+    arena.allocate(48, 8);
+    REQUIRE(arena.blocks() == 1);
+}
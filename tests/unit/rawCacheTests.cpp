@@ -0,0 +1,101 @@
+#include "catch.hpp"
+
+#include "data/rawCache.h"
+
+#include <vector>
+
+using namespace Tangram;
+
+RawCache::Data rawData(size_t _size, char _value = 0) {
+    return std::make_shared<std::vector<char>>(_size, _value);
+}
+
+TEST_CASE("RawCache keeps tiles larger than a shard's share of the limit", "[Core][RawCache]") {
+    RawCache cache(16);
+    cache.setMaxUsage(1000);
+
+    // Larger than 1000 / 16 bytes
+    cache.put(TileID(0, 0, 1), rawData(300));
+    cache.put(TileID(1, 0, 1), rawData(300));
+
+    RawCache::Data data;
+    REQUIRE(cache.get(TileID(0, 0, 1), data));
+    REQUIRE(cache.get(TileID(1, 0, 1), data));
+    REQUIRE(cache.usage() == 600);
+}
+
+TEST_CASE("RawCache evicts across shards to stay within its limit", "[Core][RawCache]") {
+    RawCache cache(16);
+    cache.setMaxUsage(1000);
+
+    for (int i = 0; i < 64; i++) {
+        cache.put(TileID(i, 0, 6), rawData(100));
+        REQUIRE(cache.usage() <= 1000);
+    }
+    REQUIRE(cache.usage() == 1000);
+
+    // The most recent tile is still cached
+    RawCache::Data data;
+    REQUIRE(cache.get(TileID(63, 0, 6), data));
+
+    cache.setMaxUsage(500);
+    REQUIRE(cache.usage() <= 500);
+}
+
+TEST_CASE("RawCache does not cache tiles larger than its limit", "[Core][RawCache]") {
+    RawCache cache(4);
+    cache.setMaxUsage(1000);
+
+    cache.put(TileID(0, 0, 1), rawData(100, 'a'));
+    cache.put(TileID(0, 0, 1), rawData(2000, 'b'));
+
+    // The previous data of the tile is kept
+    RawCache::Data data;
+    REQUIRE(cache.get(TileID(0, 0, 1), data));
+    REQUIRE(data->size() == 100);
+    REQUIRE(cache.usage() == 100);
+}
+
+TEST_CASE("RawCache keeps the old entry when admission rejects a new one", "[Core][RawCache]") {
+    RawCache cache(1);
+    cache.setMaxUsage(200);
+    cache.setFrequencyAdmission(true);
+
+    RawCache::Data data;
+    for (int i = 0; i < 4; i++) { cache.get(TileID(0, 0, 2), data); }
+    cache.put(TileID(0, 0, 2), rawData(100));
+    cache.put(TileID(1, 0, 2), rawData(100));
+
+    // Requested once, less often than the least recently used tile
+    cache.get(TileID(2, 0, 2), data);
+    cache.put(TileID(2, 0, 2), rawData(100));
+    REQUIRE(!cache.get(TileID(2, 0, 2), data));
+
+    // Replacing a cached tile does not go through admission
+    cache.put(TileID(0, 0, 2), rawData(50));
+    REQUIRE(cache.get(TileID(0, 0, 2), data));
+    REQUIRE(data->size() == 50);
+    REQUIRE(cache.usage() == 150);
+}
+
+TEST_CASE("RawCache evicts the least recently used tile of all shards", "[Core][RawCache]") {
+    RawCache cache(16);
+    cache.setMaxUsage(1000);
+
+    for (int i = 0; i < 10; i++) {
+        cache.put(TileID(i, 0, 6), rawData(100));
+    }
+
+    RawCache::Data data;
+    REQUIRE(cache.get(TileID(0, 0, 6), data));
+
+    cache.put(TileID(10, 0, 6), rawData(100));
+    REQUIRE(cache.usage() == 1000);
+
+    // Tile 1 is now the oldest, regardless of the shard of tile 10
+    REQUIRE(!cache.get(TileID(1, 0, 6), data));
+    for (int i = 0; i <= 10; i++) {
+        if (i == 1) { continue; }
+        REQUIRE(cache.get(TileID(i, 0, 6), data));
+    }
+}
@@ -0,0 +1,65 @@
+#include "catch.hpp"
+
+#include "text/textLayoutCache.h"
+
+#include <string>
+
+using namespace Tangram;
+
+static TextLayoutKey layoutKey(const std::string& _text, float _fontScale = 1.f) {
+    return { _text, nullptr, _fontScale, 0.f, 15, true, TextLabelProperty::Align::center };
+}
+
+TEST_CASE("Text layouts are found by text and layout parameters", "[Core][TextLayoutCache]") {
+    TextLayoutCache<int> cache(8);
+
+    REQUIRE(cache.put(layoutKey("Main Street"), 1).empty());
+
+    int layout = 0;
+    REQUIRE(cache.get(layoutKey("Main Street"), [&](int _layout) { layout = _layout; }));
+    REQUIRE(layout == 1);
+
+    REQUIRE(!cache.get(layoutKey("Main Street", 2.f), [](int) {}));
+    REQUIRE(!cache.get(layoutKey("Main St"), [](int) {}));
+
+    auto stats = cache.stats();
+    REQUIRE(stats.hits == 1);
+    REQUIRE(stats.misses == 2);
+    REQUIRE(stats.entries == 1);
+}
+
+TEST_CASE("Least recently used text layouts are evicted", "[Core][TextLayoutCache]") {
+    TextLayoutCache<int> cache(2);
+
+    cache.put(layoutKey("a"), 1);
+    cache.put(layoutKey("b"), 2);
+
+    // Use "a" so that "b" is evicted next
+    cache.get(layoutKey("a"), [](int) {});
+
+    auto evicted = cache.put(layoutKey("c"), 3);
+    REQUIRE(evicted.size() == 1);
+    REQUIRE(evicted[0] == 2);
+
+    // A layout for an existing key is returned as evicted
+    evicted = cache.put(layoutKey("a"), 4);
+    REQUIRE(evicted.size() == 1);
+    REQUIRE(evicted[0] == 4);
+
+    REQUIRE(cache.get(layoutKey("a"), [](int _layout) { REQUIRE(_layout == 1); }));
+    REQUIRE(cache.stats().entries == 2);
+}
+
+TEST_CASE("Text layouts are removed by predicate", "[Core][TextLayoutCache]") {
+    TextLayoutCache<int> cache(8);
+
+    cache.put(layoutKey("a"), 1);
+    cache.put(layoutKey("b"), 2);
+    cache.put(layoutKey("c"), 3);
+
+    REQUIRE(cache.removeIf([](int _layout) { return _layout != 2; }) == 2);
+
+    REQUIRE(!cache.get(layoutKey("a"), [](int) {}));
+    REQUIRE(cache.get(layoutKey("b"), [](int) {}));
+    REQUIRE(cache.stats().entries == 1);
+}
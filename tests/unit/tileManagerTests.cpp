@@ -99,6 +99,8 @@ struct TestDataSource : DataSource {
 
     void clearData() override {}
 
+    void invalidate(const BoundingBox& _bounds) { invalidateRegion(_bounds); }
+
     std::shared_ptr<TileTask> createTask(TileID _tileId, int _subTask) override {
         return std::make_shared<Task>(_tileId, shared_from_this(), _subTask);
     }
@@ -272,3 +274,34 @@ TEST_CASE( "Use proxy Tile - circular proxies", "[TileManager][updateTileSets]"
     REQUIRE(tileManager.getVisibleTiles()[0]->getID() == TileID(0,0,0));
 
 }
+
+TEST_CASE( "Reload only tiles in changed regions", "[TileManager][updateTileSets]" ) {
+    TestTileWorker worker;
+    TileManager tileManager(worker);
+    ViewState viewState { s_projection, true, glm::vec2(0), 1 };
+
+    auto source = std::make_shared<TestDataSource>();
+    std::vector<std::shared_ptr<DataSource>> sources = { source };
+    tileManager.setDataSources(sources);
+
+    std::set<TileID> visibleTiles = { TileID{0,0,1}, TileID{1,1,1} };
+    tileManager.updateTileSets(viewState, visibleTiles);
+    worker.processTask();
+    worker.processTask();
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(tileManager.getVisibleTiles().size() == 2);
+    REQUIRE(source->tileTaskCount == 2);
+
+    /// Change data within the north-west quarter of the map
+    source->invalidate({ {0.1, 0.1}, {0.2, 0.2} });
+    tileManager.updateTileSets(viewState, visibleTiles);
+
+    REQUIRE(source->tileTaskCount == 3);
+    REQUIRE(worker.tasks.size() == 1);
+    REQUIRE(worker.tasks[0]->tileId() == TileID(0,0,1));
+
+    REQUIRE(source->isTileStale(TileID(0,0,1), 1));
+    REQUIRE(!source->isTileStale(TileID(1,1,1), 1));
+    REQUIRE(!source->isTileStale(TileID(0,0,1), source->generation()));
+}
@@ -0,0 +1,129 @@
+#include "catch.hpp"
+
+#include "data/dataSource.h"
+#include "tile/tileTask.h"
+#include "tile/tileTaskScheduler.h"
+
+using namespace Tangram;
+
+struct TestSource : DataSource {
+    TestSource(const std::string& _name = "") : DataSource(_name, "") {}
+
+    std::shared_ptr<TileData> parse(const TileTask& _task,
+                                    const MapProjection& _projection) const override {
+        return nullptr;
+    }
+};
+
+std::shared_ptr<TileTask> makeTask(std::shared_ptr<DataSource> _source, int _x, double _priority) {
+    TileID id(_x, 0, 10);
+    auto task = std::make_shared<TileTask>(id, _source, -1);
+    task->setPriority(_priority);
+    return task;
+}
+
+TEST_CASE( "Pop tasks in priority order", "[TileTaskScheduler]" ) {
+    auto source = std::make_shared<TestSource>();
+    TileTaskScheduler scheduler(1);
+
+    scheduler.push(makeTask(source, 0, 3));
+    scheduler.push(makeTask(source, 1, 1));
+    scheduler.push(makeTask(source, 2, 2));
+
+    auto proxy = makeTask(source, 3, 0);
+    proxy->setProxyState(true);
+    scheduler.push(std::move(proxy));
+
+    REQUIRE(scheduler.size() == 4);
+    REQUIRE(scheduler.pop(0)->tileId().x == 1);
+    REQUIRE(scheduler.pop(0)->tileId().x == 2);
+    REQUIRE(scheduler.pop(0)->tileId().x == 0);
+    // Proxy tiles come last
+    REQUIRE(scheduler.pop(0)->tileId().x == 3);
+    REQUIRE(scheduler.pop(0) == nullptr);
+    REQUIRE(scheduler.empty());
+}
+
+TEST_CASE( "Drop canceled tasks", "[TileTaskScheduler]" ) {
+    auto source = std::make_shared<TestSource>();
+    TileTaskScheduler scheduler(1);
+
+    auto task = makeTask(source, 0, 1);
+    scheduler.push(std::shared_ptr<TileTask>(task));
+    scheduler.push(makeTask(source, 1, 2));
+
+    task->cancel();
+
+    REQUIRE(scheduler.pop(0)->tileId().x == 1);
+    REQUIRE(scheduler.pop(0) == nullptr);
+    REQUIRE(scheduler.empty());
+}
+
+TEST_CASE( "Apply updated priorities after reprioritize", "[TileTaskScheduler]" ) {
+    auto source = std::make_shared<TestSource>();
+    TileTaskScheduler scheduler(1);
+
+    auto task = makeTask(source, 0, 1);
+    scheduler.push(std::shared_ptr<TileTask>(task));
+    scheduler.push(makeTask(source, 1, 2));
+
+    task->setPriority(3);
+    scheduler.reprioritize();
+
+    REQUIRE(scheduler.pop(0)->tileId().x == 1);
+    REQUIRE(scheduler.pop(0)->tileId().x == 0);
+}
+
+TEST_CASE( "Steal tasks from other queues", "[TileTaskScheduler]" ) {
+    auto source = std::make_shared<TestSource>();
+    TileTaskScheduler scheduler(4);
+
+    // Round-robin distribution puts one task into each queue
+    for (int i = 0; i < 4; i++) {
+        scheduler.push(makeTask(source, i, i));
+    }
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(scheduler.pop(0) != nullptr);
+    }
+    REQUIRE(scheduler.pop(0) == nullptr);
+    REQUIRE(scheduler.empty());
+}
+
+TEST_CASE( "Steal the best task of the other queues", "[TileTaskScheduler]" ) {
+    auto source = std::make_shared<TestSource>();
+    TileTaskScheduler scheduler(4);
+
+    scheduler.push(makeTask(source, 0, 0));
+    scheduler.push(makeTask(source, 1, 3));
+    scheduler.push(makeTask(source, 2, 1));
+    scheduler.push(makeTask(source, 3, 2));
+
+    REQUIRE(scheduler.pop(0)->tileId().x == 0);
+    REQUIRE(scheduler.pop(0)->tileId().x == 2);
+    REQUIRE(scheduler.pop(0)->tileId().x == 3);
+    REQUIRE(scheduler.pop(0)->tileId().x == 1);
+    REQUIRE(scheduler.pop(0) == nullptr);
+}
+
+TEST_CASE( "Keep tasks of reserved sources on reserved queues", "[TileTaskScheduler]" ) {
+    auto shared = std::make_shared<TestSource>();
+    auto reserved = std::make_shared<TestSource>("reserved");
+
+    // Queue 0 is shared, queue 1 reserved for 'reserved'
+    TileTaskScheduler scheduler(2, {{ "reserved", 1 }});
+    REQUIRE(scheduler.reservation(0) == "");
+    REQUIRE(scheduler.reservation(1) == "reserved");
+
+    scheduler.push(makeTask(reserved, 0, 0));
+    REQUIRE(scheduler.hasTasks(0) == false);
+    REQUIRE(scheduler.hasTasks(1) == true);
+    REQUIRE(scheduler.pop(0) == nullptr);
+    REQUIRE(scheduler.pop(1)->tileId().x == 0);
+
+    // Reserved queues help out with shared tasks
+    scheduler.push(makeTask(shared, 1, 0));
+    REQUIRE(scheduler.hasTasks(1) == true);
+    REQUIRE(scheduler.pop(1)->tileId().x == 1);
+    REQUIRE(scheduler.empty());
+}
@@ -5,6 +5,8 @@
 
 #include "yaml-cpp/yaml.h"
 #include "scene/filters.h"
+#include "scene/filterProgram.h"
+#include "data/propertyItem.h"
 #include "data/tileData.h"
 #include "scene/sceneLoader.h"
 #include "scene/scene.h"
@@ -27,6 +29,16 @@ Filter load(const std::string& filterYaml) {
     return filter;
 }
 
+// Evaluate the filter tree and its compiled form, which is what
+// DrawRuleMergeSet::matchLayers runs, and require the same result
+bool evalBoth(const Filter& filter, const Feature& feature) {
+    FilterProgram program(filter);
+
+    bool result = filter.eval(feature, ctx);
+    REQUIRE(program.eval(feature, ctx) == result);
+    return result;
+}
+
 void init() {
 
     civic.props.clear();
@@ -65,9 +77,9 @@ TEST_CASE( "yaml-filter-tests: basic predicate test", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: { series: !!str 3}");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -76,9 +88,9 @@ TEST_CASE( "yaml-filter-tests: predicate with valueList", "[filters][core][yaml]
     init();
     Filter filter = load("filter: { name : [civic, bmw320i] }");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -87,9 +99,9 @@ TEST_CASE( "yaml-filter-tests: range min", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {wheel : {min : 3}}");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -98,9 +110,9 @@ TEST_CASE( "yaml-filter-tests: range max", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {wheel : {max : 2}}");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -109,9 +121,9 @@ TEST_CASE( "yaml-filter-tests: range min max", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {wheel : {min : 2, max : 5}}");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -120,9 +132,9 @@ TEST_CASE( "yaml-filter-tests: any", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {any : [{name : civic}, {name : bmw320i}]}");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -131,9 +143,9 @@ TEST_CASE( "yaml-filter-tests: all", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {all : [ {name : civic}, {brand : honda}, {wheel: 4} ] }");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -142,9 +154,9 @@ TEST_CASE( "yaml-filter-tests: none", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {none : [{name : civic}, {name : bmw320i}]}");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -153,9 +165,9 @@ TEST_CASE( "yaml-filter-tests: not", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {not : { any: [{name : civic}, {name : bmw320i}]}}");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -164,9 +176,9 @@ TEST_CASE( "yaml-filter-tests: context filter", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {$geometry : 1}");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -174,9 +186,9 @@ TEST_CASE( "yaml-filter-tests: bogus filter", "[filters][core][yaml]") {
     init();
     Filter filter = load("filter: {max: bogus}");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -184,9 +196,9 @@ TEST_CASE( "yaml-filter-tests: boolean true filter as existence check", "[filter
     init();
     Filter filter = load("filter: { drive : true }");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -194,9 +206,9 @@ TEST_CASE( "yaml-filter-tests: boolean false filter as existence check", "[filte
     init();
     Filter filter = load("filter: { drive : false}");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -204,9 +216,9 @@ TEST_CASE( "yaml-filter-tests: boolean true filter as existence check for keywor
     init();
     Filter filter = load("filter: {$geometry : 1}");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -214,9 +226,9 @@ TEST_CASE( "yaml-filter-tests: boolean false filter as existence check for keywo
     init();
     Filter filter = load("filter: {$zoom : false}");
 
-    REQUIRE(filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(filter.eval(bike, ctx));
+    REQUIRE(evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(evalBoth(filter, bike));
 
 }
 
@@ -224,9 +236,9 @@ TEST_CASE( "yaml-filter-tests: predicate with large integers", "[filters][core][
     init();
     Filter filter = load("filter: { serial : [4398046511104] }");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
 
 }
 
@@ -234,7 +246,24 @@ TEST_CASE("Filters specified as a javascript function evaluate correctly", "[fil
     init();
     Filter filter = load("filter: 'function() { return false; }'");
 
-    REQUIRE(!filter.eval(civic, ctx));
-    REQUIRE(!filter.eval(bmw1, ctx));
-    REQUIRE(!filter.eval(bike, ctx));
+    REQUIRE(!evalBoth(filter, civic));
+    REQUIRE(!evalBoth(filter, bmw1));
+    REQUIRE(!evalBoth(filter, bike));
+}
+
+TEST_CASE("Compiled filters match feature keys that were not interned", "[filters][core][yaml]") {
+    init();
+    Filter filter = load("filter: { owner : [alice] }");
+    FilterProgram program(filter);
+
+    // As parsed after the key table was full
+    Feature feature;
+    std::vector<PropertyItem> items;
+    items.emplace_back("name", PropertyKeys::lookup("name"), Value("x"));
+    items.emplace_back("owner", PropertyKeys::unknown, Value("alice"));
+    feature.props.setSorted(std::move(items));
+
+    REQUIRE(evalBoth(filter, feature));
+    REQUIRE(program.eval(feature, ctx));
+    REQUIRE(!program.eval(civic, ctx));
 }